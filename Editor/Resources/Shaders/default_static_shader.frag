@@ -52,9 +52,19 @@ layout (std140) uniform u_LightSpaceMatrices
 uniform float u_CascadePlaneDistances[16];
 uniform int u_CascadeCount;
 
-uniform float u_EnvironmentBrightness;
-uniform float u_CameraFarPlane;
-uniform mat4 u_CameraView;
+layout(std140, binding = 1) uniform FrameData {
+    mat4 u_SunView;
+    mat4 u_SunProjection;
+    float u_EnvironmentBrightness;
+    int u_NumDirectionalLights;
+};
+
+layout(std140, binding = 2) uniform ViewData {
+    mat4 u_CameraView;
+    mat4 u_CameraProjection;
+    vec3 u_CameraPos;
+    float u_CameraFarPlane;
+};
 
 
 struct Material
@@ -66,7 +76,11 @@ struct Material
 	bool UseNormalMap;
 };
 
-uniform Material u_MaterialUniforms;
+layout(binding = 4, std430) readonly buffer MaterialsBuffer {
+    Material data[];
+} materialsBuffer;
+
+uniform uint u_MaterialIndex;
 
 
 layout(binding = 2, std430) readonly buffer LightBuffer {
@@ -84,7 +98,6 @@ layout(binding = 1, std430) readonly buffer VisibleLightIndicesBuffer {
 out vec4 fragColor;
 
 uniform int numberOfTilesX;
-uniform int u_NumDirectionalLights;
 uniform int u_UsesHeightMap;
 uniform int u_UsesNormalMap;
 
@@ -110,9 +123,10 @@ vec3 sRGBToLinear(vec3 sRGB) {
 }
 
 void main() {
+    Material material = materialsBuffer.data[u_MaterialIndex];
     vec3 V = normalize(cameraPosition - worldSpacePosition);
     vec3 N = normal;
-    if (u_MaterialUniforms.UseNormalMap) {
+    if (material.UseNormalMap) {
         vec3 normalMap = texture(u_NormalTexture, texCoords).xyz;
         normalMap = normalMap * 2.0 - 1.0;
         N = normalize(TBN * normalMap);
@@ -120,9 +134,9 @@ void main() {
     vec3 R = reflect(-V, N); 
 
     vec3 specular_color = texture(u_SpecularTexture, texCoords).rgb;
-    vec3 albedo = texture(u_AlbedoTexture, texCoords).rgb * u_MaterialUniforms.AlbedoColor * specular_color;
-    float roughness = texture(u_MetalnessTexture, texCoords).g * u_MaterialUniforms.Roughness;
-    float metalness = texture(u_MetalnessTexture, texCoords).b * u_MaterialUniforms.Metalness;
+    vec3 albedo = texture(u_AlbedoTexture, texCoords).rgb * material.AlbedoColor * specular_color;
+    float roughness = texture(u_MetalnessTexture, texCoords).g * material.Roughness;
+    float metalness = texture(u_MetalnessTexture, texCoords).b * material.Metalness;
     vec3 ao = texture(u_AOTexture, texCoords).rgb;
     vec3 emission = texture(u_EmissionTexture, texCoords).rgb;
 
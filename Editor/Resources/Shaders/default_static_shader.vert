@@ -7,12 +7,23 @@ layout (location = 3) in vec3 a_normals;
 layout (location = 4) in vec3 a_tangent;
 layout (location = 5) in vec3 a_bitangent;
 
-uniform mat4 u_CameraView;
-uniform mat4 u_CameraProjection;
-uniform vec3 u_CameraPos;
-uniform mat4 u_Transform;
-uniform mat4 u_SunView;
-uniform mat4 u_SunProjection;
+layout(std140, binding = 1) uniform FrameData {
+    mat4 u_SunView;
+    mat4 u_SunProjection;
+    float u_EnvironmentBrightness;
+    int u_NumDirectionalLights;
+};
+
+layout(std140, binding = 2) uniform ViewData {
+    mat4 u_CameraView;
+    mat4 u_CameraProjection;
+    vec3 u_CameraPos;
+    float u_CameraFarPlane;
+};
+
+layout(std430, binding = 3) readonly buffer InstanceTransformsBuffer {
+    mat4 u_InstanceTransforms[];
+};
 
 out vec3 worldSpacePosition;
 out vec4 vertex_color;
@@ -25,14 +36,15 @@ out vec4 fragLightSpacePosition;
 
 
 void main() {
-    gl_Position = u_CameraProjection * u_CameraView * u_Transform * vec4(a_coords, 1.0);
-    worldSpacePosition = vec3(u_Transform * vec4(a_coords, 1.0));
+    mat4 transform = u_InstanceTransforms[gl_BaseInstance + gl_InstanceID];
+    gl_Position = u_CameraProjection * u_CameraView * transform * vec4(a_coords, 1.0);
+    worldSpacePosition = vec3(transform * vec4(a_coords, 1.0));
 
     fragLightSpacePosition = u_SunProjection * u_SunView * vec4(worldSpacePosition, 1.0);
 
-    vec3 N = normalize(mat3(u_Transform) * a_normals);
-    vec3 T = normalize(mat3(u_Transform) * a_tangent);
-    vec3 B = normalize(mat3(u_Transform) * a_bitangent);
+    vec3 N = normalize(mat3(transform) * a_normals);
+    vec3 T = normalize(mat3(transform) * a_tangent);
+    vec3 B = normalize(mat3(transform) * a_bitangent);
     TBN = mat3(T, B, N);
 
     normal = N;
@@ -2,11 +2,19 @@
 
 layout (location = 0) in vec3 a_coords;
 
-uniform mat4 u_CameraView;
-uniform mat4 u_CameraProjection;
-uniform mat4 u_Transform;
+layout(std140, binding = 2) uniform ViewData {
+	mat4 u_CameraView;
+	mat4 u_CameraProjection;
+	vec3 u_CameraPos;
+	float u_CameraFarPlane;
+};
+
+layout(std430, binding = 3) readonly buffer InstanceTransformsBuffer {
+	mat4 u_InstanceTransforms[];
+};
 
 
 void main(){
-	gl_Position = u_CameraProjection * u_CameraView * u_Transform * vec4(a_coords, 1.0);
+	mat4 transform = u_InstanceTransforms[gl_BaseInstance + gl_InstanceID];
+	gl_Position = u_CameraProjection * u_CameraView * transform * vec4(a_coords, 1.0);
 }
\ No newline at end of file
@@ -2,9 +2,12 @@
 
 layout (location = 0) in vec3 a_coords;
 
-uniform mat4 u_Transform;
+layout(std430, binding = 3) readonly buffer InstanceTransformsBuffer {
+	mat4 u_InstanceTransforms[];
+};
 
 
 void main(){
-	gl_Position = u_Transform * vec4(a_coords, 1.0);
+	mat4 transform = u_InstanceTransforms[gl_BaseInstance + gl_InstanceID];
+	gl_Position = transform * vec4(a_coords, 1.0);
 }
\ No newline at end of file
@@ -7,8 +7,12 @@ layout(location = 3) in vec4 a_transform_row2;
 layout(location = 4) in vec4 a_transform_row3;
 layout(location = 5) in vec4 a_transform_row4;
 
-uniform mat4 u_CameraProjection;
-uniform mat4 u_CameraView;
+layout(std140, binding = 2) uniform ViewData {
+   mat4 u_CameraView;
+   mat4 u_CameraProjection;
+   vec3 u_CameraPos;
+   float u_CameraFarPlane;
+};
 
 out vec4 vColor;
 
@@ -2,8 +2,12 @@
 
 layout (location = 0) in vec3 a_position;
 
-uniform mat4 u_CameraProjection;
-uniform mat4 u_CameraView;
+layout(std140, binding = 2) uniform ViewData {
+	mat4 u_CameraView;
+	mat4 u_CameraProjection;
+	vec3 u_CameraPos;
+	float u_CameraFarPlane;
+};
 
 out vec3 local_pos;
 
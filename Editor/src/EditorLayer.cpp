@@ -34,11 +34,11 @@ namespace Editor {
 			auto entity = EditorPanels::SceneGraph::GetSelectedEntity();
 			if (entity)
 			{
-				if (entity->HasComponent<BoxColliderComponent>())
+				if (entity.HasComponent<BoxColliderComponent>())
 				{
-					auto collider = entity->GetComponent<BoxColliderComponent>();
+					auto collider = entity.GetComponent<BoxColliderComponent>();
 					DebugBox debug_box{};
-					auto transform = entity->GetComponent<TransformComponent>()->world_transform;
+					auto transform = entity.GetComponent<TransformComponent>()->world_transform;
 					transform.translation += collider->Offset;
 					debug_box.Transform = transform.mat4();
 					debug_box.Color = glm::vec4(1.f, 0.f, 0.f, 1.f);
@@ -47,11 +47,11 @@ namespace Editor {
 				}
 
 
-				if (entity->HasComponent<SphereColliderComponent>())
+				if (entity.HasComponent<SphereColliderComponent>())
 				{
-					auto collider = entity->GetComponent<SphereColliderComponent>();
+					auto collider = entity.GetComponent<SphereColliderComponent>();
 					DebugSphere debug_sphere{};
-					auto transform = entity->GetComponent<TransformComponent>()->world_transform;
+					auto transform = entity.GetComponent<TransformComponent>()->world_transform;
 					transform.translation += collider->Offset;
 					debug_sphere.Transform = transform.mat4();
 					debug_sphere.Color = glm::vec4(1.f, 0.f, 0.f, 1.f);
@@ -59,11 +59,11 @@ namespace Editor {
 					Renderer::Get()->SubmitDebugSphere(debug_sphere);
 				}
 
-				if (entity->HasComponent<CharacterControllerComponent>())
+				if (entity.HasComponent<CharacterControllerComponent>())
 				{
-					auto collider = entity->GetComponent<CharacterControllerComponent>();
+					auto collider = entity.GetComponent<CharacterControllerComponent>();
 					DebugCapsule debug_capsule{};
-					auto transform = entity->GetComponent<TransformComponent>()->world_transform;
+					auto transform = entity.GetComponent<TransformComponent>()->world_transform;
 					transform.translation += collider->Offset;
 					debug_capsule.Transform = transform.mat4();
 					debug_capsule.Color = glm::vec4(1.f, 0.f, 0.f, 1.f);
@@ -308,6 +308,13 @@ namespace Editor {
 		ImGui::Text("Draw Calls: %d", Renderer::Get()->GetStats()->draw_calls);
 		ImGui::Text("Vertices: %d", Renderer::Get()->GetStats()->vertices_count);
 		ImGui::Text("Indices: %d", Renderer::Get()->GetStats()->index_count);
+		ImGui::Text("Instanced Draw Calls: %d (%d instances)", Renderer::Get()->GetStats()->instanced_draw_calls, Renderer::Get()->GetStats()->instances_count);
+		ImGui::Text("Culled Submeshes: %d", Renderer::Get()->GetStats()->culled_submeshes);
+		ImGui::Text("Shadow Culled Submeshes: %d", Renderer::Get()->GetStats()->shadow_culled_submeshes);
+		for (uint32_t lod = 0; lod < MeshSource::MaxLODs; lod++)
+		{
+			ImGui::Text("Meshes at LOD %u: %d", lod, Renderer::Get()->GetStats()->lod_mesh_count[lod]);
+		}
 
 		ImGui::End();
 
@@ -392,6 +399,8 @@ namespace Editor {
 		m_SceneState = SceneState::Edit;
 		m_CurrentScene->OnRuntimeStop();
 		m_CurrentScene = m_EditorScene;
+		// The play mode copy shares its meshes with the editor scene and has moved them around
+		m_CurrentScene->ResetChangeTracking();
 		Input::SetLockMouseMode(false);
 	}
 
@@ -477,42 +486,81 @@ namespace Editor {
 			// HVE_INFO("Shot fired from {0} {1}", mouseX, mouseY);
 			auto [origin, direction] = CastRay(mouseX, mouseY);
 
-			auto meshEntities = m_CurrentScene->GetAllEntitiesByType<MeshComponent>();
+			// Only meshes whose world bounds the ray passes through, the scene keeps them in a tree
+			std::vector<EntityId> hit_entities;
+			m_CurrentScene->GetSpatialIndex().RayCast(Math::Ray(origin, direction), FLT_MAX, [&hit_entities](EntityId entity_id, float)
+			{
+				hit_entities.push_back(entity_id);
+				return FLT_MAX;
+			});
 
 			std::vector<SelectionData> selected_entities{};
 
-			for (const auto& [entity, component] : *meshEntities)
+			// Then every submesh of those, bounds moved to world space and tested against the ray in one batch
+			struct Candidate
+			{
+				EntityId Entity;
+				Ref<Mesh> MeshPtr;
+				uint32_t SubmeshIndex;
+			};
+			std::vector<Candidate> candidates;
+			std::vector<Math::BoundingBox> local_bounds;
+			std::vector<glm::mat4> transforms;
+
+			for (EntityId entity_id : hit_entities)
+			{
+				const MeshComponent* component = m_CurrentScene->GetRegistry()->GetReadOnly<MeshComponent>(entity_id);
+				if (!component || !component->mesh || !component->mesh->GetMeshSource())
+				{
+					continue;
+				}
+
+				for (const auto& submesh : component->mesh->GetMeshSource()->GetSubmeshes())
+				{
+					candidates.push_back({ entity_id, component->mesh, submesh.Index });
+					local_bounds.push_back(submesh.Bounds);
+					transforms.push_back(component->mesh->GetTransform() * submesh.WorldTransform);
+				}
+			}
+
+			std::vector<Math::BoundingBox> world_bounds(local_bounds.size());
+			Math::TransformBoundingBoxes(local_bounds.data(), transforms.data(), world_bounds.data(), world_bounds.size());
+
+			Math::BoundingBoxSoA bounds_soa;
+			bounds_soa.Reserve(world_bounds.size());
+			for (const auto& bounds : world_bounds)
+			{
+				bounds_soa.Add(bounds);
+			}
+
+			std::vector<float> distances(world_bounds.size());
+			Math::IntersectRayAABBs(Math::Ray(origin, direction), bounds_soa, distances.data());
+
+			// Narrow phase, triangles are only tested for the boxes the ray hit, in the submesh's own space
+			for (size_t i = 0; i < candidates.size(); i++)
 			{
-				if (!component.mesh)
+				if (distances[i] == FLT_MAX)
 				{
 					continue;
 				}
 
-				for (const auto& submesh : component.mesh->GetMeshSource()->GetSubmeshes())
+				const auto& candidate = candidates[i];
+				glm::mat4 inverse = glm::inverse(transforms[i]);
+				Math::Ray ray = {
+					inverse * glm::vec4(origin, 1.0f),
+					glm::mat3(inverse) * direction
+				};
+
+				float t;
+				const auto& triangleCache = candidate.MeshPtr->GetMeshSource()->GetTriangleCache(candidate.SubmeshIndex);
+				for (const auto& triangle : triangleCache)
 				{
-					
-					Math::Ray ray = {
-						glm::inverse(submesh.WorldTransform) * glm::vec4(origin, 1.0f),
-						glm::inverse(glm::mat3(submesh.WorldTransform)) * direction
-					};
-
-					float t;
-					Math::BoundingBox bounding_box = submesh.Bounds;
-					if (ray.IntersectsAABB(bounding_box, t))
+					if (ray.IntersectsTriangle(triangle.V0.coordinates, triangle.V1.coordinates, triangle.V2.coordinates, t))
 					{
-						const auto& triangleCache = component.mesh->GetMeshSource()->GetTriangleCache(submesh.Index);
-						for (const auto& triangle : triangleCache)
-						{
-
-							if (ray.IntersectsTriangle(triangle.V0.coordinates, triangle.V1.coordinates, triangle.V2.coordinates, t))
-							{
-								selected_entities.push_back({ entity, t });
-								break;
-							}
-						}
+						selected_entities.push_back({ candidate.Entity, t });
+						break;
 					}
 				}
-
 			}
 
 			std::sort(selected_entities.begin(), selected_entities.end(), [](auto& a, auto& b) { return a.Distance < b.Distance; });
@@ -520,13 +568,13 @@ namespace Editor {
 			if (selected_entities.size() > 0)
 			{
 				auto selected_entity = EditorPanels::SceneGraph::GetSelectedEntity();
-				if (selected_entity && selected_entity->GetHandle()->GetID() == selected_entities[0].entity.GetID())
+				if (selected_entity && selected_entity.GetID() == selected_entities[0].entity)
 				{
 					EditorPanels::SceneGraph::SetSelectedEntity(0);
 				}
 				else
 				{
-					EditorPanels::SceneGraph::SetSelectedEntity(selected_entities[0].entity.GetID());
+					EditorPanels::SceneGraph::SetSelectedEntity(m_CurrentScene->GetEntity(selected_entities[0].entity).GetUUID());
 				}
 			}
 			else
@@ -569,13 +617,13 @@ namespace Editor {
 
 	void EditorLayer::CreateEntityFromMesh(const std::filesystem::path& file_path)
 	{
-		auto handle = m_CurrentScene->CreateEntity("New Mesh Entity", nullptr);
+		auto entity = m_CurrentScene->CreateEntity("New Mesh Entity");
 		AssetHandle asset_handle = Project::GetActiveDesignAssetManager()->GetHandleByPath(file_path);
 		Ref<MeshSource> mesh_source = AssetManager::GetAsset<MeshSource>(asset_handle);
 		Ref<Mesh> mesh = CreateRef<Mesh>(mesh_source);
 		MeshComponent mesh_comp{};
 		mesh_comp.mesh = mesh;
-		m_CurrentScene->GetEntity(handle)->AddComponent<MeshComponent>(mesh_comp);
+		entity.AddComponent<MeshComponent>(mesh_comp);
 	}
 
 	void EditorLayer::OpenNewProject(const std::string& project_path)
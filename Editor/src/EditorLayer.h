@@ -24,7 +24,7 @@ namespace Editor {
 
 	struct SelectionData
 	{
-		EntityHandle entity;
+		EntityId entity;
 		float Distance = 0.0f;
 	};
 
@@ -69,7 +69,6 @@ namespace Editor {
 		Ref<Scene> m_EditorScene;
 		std::string m_ProjectPath;
 		Ref<EditorCamera> m_Camera;
-		std::vector<EntityHandle*> entities{};
 		bool b_EditDockspace = true;
 		Ref<Framebuffer> m_SceneBuffer;
 		Ref<Project> m_Project;
@@ -24,18 +24,31 @@ namespace EditorPanels {
             if (ImGui::BeginDragDropTarget()) {
                 const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_NODE");
                 if (payload) {
-                    UUID droppedNodeId = *(const UUID*)payload->Data;
-                    m_Scene->ReparentSceneNode(&droppedNodeId, &m_Scene->GetId());
+                    EntityId droppedNodeId = *(const EntityId*)payload->Data;
+                    m_PendingReparents.push_back({ droppedNodeId, EntityId() });
+                }
+                if (const ImGuiPayload* asset_payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM")) {
+                    const auto payload_path = *(const std::filesystem::path*)asset_payload->Data;
+                    if (DesignAssetManager::GetAssetTypeFromFileExtension(payload_path.extension()) == AssetType::Prefab) {
+                        Project::GetActiveDesignAssetManager()->ImportAsset(payload_path);
+                        auto handle = Project::GetActiveDesignAssetManager()->GetHandleByPath(payload_path);
+                        m_Scene->Instantiate(AssetManager::GetAsset<Prefab>(handle), 1);
+                    }
                 }
                 ImGui::EndDragDropTarget();
             }
-			for (const auto& child : *m_Scene->GetRootNode()->GetChildren()) {
+			m_Scene->GetHierarchy().ForEachChild(EntityId(), [this](EntityId child) {
 				ImGui::Dummy(ImVec2(0.0f, 5.0f));
-				DisplaySceneEntity(child.get());
-			}
+				DisplaySceneEntity(child);
+			});
 			ImGui::TreePop();
 		}
 
+		for (const auto& pending : m_PendingReparents) {
+			m_Scene->ReparentEntity(pending.Entity, pending.NewParent);
+		}
+		m_PendingReparents.clear();
+
 		if (ImGui::IsMouseDown(0) && ImGui::IsWindowHovered()) {
 			m_SelectionContext = {};
 		}	
@@ -43,7 +56,7 @@ namespace EditorPanels {
 		if (ImGui::BeginPopupContextWindow(0, ImGuiPopupFlags_MouseButtonRight | ImGuiPopupFlags_NoOpenOverItems))
 		{
 			if (ImGui::MenuItem("Create Empty Entity"))
-				m_Scene->CreateEntity("Empty Entity", nullptr);
+				m_Scene->CreateEntity("Empty Entity");
 
 			ImGui::EndPopup();
 		}
@@ -57,43 +70,41 @@ namespace EditorPanels {
 		ImGui::End();
 
 	}
-    void SceneGraph::DisplaySceneEntity(SceneNode* node)
+    void SceneGraph::DisplaySceneEntity(EntityId entity_id)
     {
-        if (node == nullptr) {
-            return;
-        }
+        auto entity = m_Scene->GetEntity(entity_id);
 
-        auto entity = m_Scene->GetEntity(node->GetID());
-
-        if (entity == nullptr) {
+        if (!entity) {
             return;
         }
 
-        ImGui::PushID(node->GetID());
+        ImGui::PushID((int)entity_id.Index);
 
+        uint32_t child_count = m_Scene->GetHierarchy().GetChildCount(entity_id);
         ImGuiTreeNodeFlags node_flags = ImGuiTreeNodeFlags_OpenOnArrow;
-        if (node->GetChildren()->empty()) {
+        if (child_count == 0) {
             node_flags |= ImGuiTreeNodeFlags_Leaf;
         }
 
-        std::string entity_header = entity->GetComponent<TagComponent>()->name;
-        if (!node->GetChildren()->empty()) {
-            entity_header += " (" + std::to_string(node->GetChildren()->size()) + ")";
+        std::string entity_header = entity.GetComponent<TagComponent>()->name;
+        if (child_count > 0) {
+            entity_header += " (" + std::to_string(child_count) + ")";
         }
 
         bool node_open = ImGui::TreeNodeEx("##arrow", node_flags);
 
         ImGui::SameLine();
         ImGuiSelectableFlags button_flags = ImGuiSelectableFlags_AllowDoubleClick;
-        if (node->GetID() == m_SelectionContext) {
+        bool is_selected = entity.GetUUID() == m_SelectionContext;
+        if (is_selected) {
             button_flags |= ImGuiTreeNodeFlags_Selected;
         }
-        if (ImGui::Selectable(entity_header.c_str(), node->GetID() == m_SelectionContext, button_flags)) {
-            m_SelectionContext = node->GetID();
+        if (ImGui::Selectable(entity_header.c_str(), is_selected, button_flags)) {
+            m_SelectionContext = entity.GetUUID();
         }
 
         if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
-            ImGui::SetDragDropPayload("SCENE_NODE", &node->GetID(), sizeof(UUID));
+            ImGui::SetDragDropPayload("SCENE_NODE", &entity_id, sizeof(EntityId));
             ImGui::Text("Move %s", entity_header.c_str());
             ImGui::EndDragDropSource();
         }
@@ -101,8 +112,8 @@ namespace EditorPanels {
         if (ImGui::BeginDragDropTarget()) {
             const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_NODE");
             if (payload) {
-                UUID droppedNodeId = *(const UUID*)payload->Data;
-                m_Scene->ReparentSceneNode(&droppedNodeId, &node->GetID());
+                EntityId droppedNodeId = *(const EntityId*)payload->Data;
+                m_PendingReparents.push_back({ droppedNodeId, entity_id });
             }
             ImGui::EndDragDropTarget();
         }
@@ -110,23 +121,31 @@ namespace EditorPanels {
         bool entityDeleted = false;
         if (ImGui::BeginPopupContextItem()) {
             if (ImGui::MenuItem("Create Empty Entity With Current Entity As Parent"))
-                m_Scene->CreateEntity("Empty Entity", &node->GetID());
+                m_Scene->CreateEntity("Empty Entity", entity_id);
+            if (ImGui::MenuItem("Save As Prefab")) {
+                Ref<Prefab> prefab = Prefab::CreateFromEntity(entity);
+                std::filesystem::path prefab_path = Project::GetActive()->GetSettings().AssetPath
+                    / (entity.GetComponent<TagComponent>()->name + DesignAssetManager::GetFileExtensionFromAssetType(AssetType::Prefab));
+                if (prefab->SavePrefab(prefab_path)) {
+                    Project::GetActiveDesignAssetManager()->RegisterAsset(prefab->Handle, prefab_path);
+                }
+            }
             if (ImGui::MenuItem("Delete Entity"))
                 entityDeleted = true;
             ImGui::EndPopup();
         }
 
         if (node_open) {
-            for (auto& child : *node->GetChildren()) {
-                DisplaySceneEntity(child.get());
-            }
+            m_Scene->GetHierarchy().ForEachChild(entity_id, [this](EntityId child) {
+                DisplaySceneEntity(child);
+            });
             ImGui::TreePop();
         }
 
         if (entityDeleted) {
-            m_Scene->DestroyEntity(node->GetID());
-            if (m_SelectionContext == node->GetID())
+            if (is_selected)
                 m_SelectionContext = {};
+            m_Scene->DestroyEntity(entity_id);
         }
 
         ImGui::PopID();
@@ -224,12 +243,12 @@ namespace EditorPanels {
 	}
 
 	template<typename T, typename UIFunction>
-	static void DrawComponent(const std::string& name, Entity* entity, UIFunction uiFunction)
+	static void DrawComponent(const std::string& name, Entity entity, UIFunction uiFunction)
 	{
 		const ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_FramePadding;
-		if (entity->HasComponent<T>())
+		if (entity.HasComponent<T>())
 		{
-			auto component = entity->GetComponent<T>();
+			auto component = entity.GetComponent<T>();
 			ImVec2 contentRegionAvailable = ImGui::GetContentRegionAvail();
 
 			ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2{ 4, 4 });
@@ -254,12 +273,12 @@ namespace EditorPanels {
 
 			if (open)
 			{
-				uiFunction(component, entity->GetHandle());
+				uiFunction(component, entity);
 				ImGui::TreePop();
 			}
 
 			if (removeComponent)
-				entity->RemoveComponent<T>();
+				entity.RemoveComponent<T>();
 		}
 	}
 
@@ -313,18 +332,18 @@ namespace EditorPanels {
 
     void SceneGraph::DrawComponents()
     {
-		auto entity = m_Scene->GetEntity(m_SelectionContext);
-		if (entity == nullptr) {
+		auto entity = m_Scene->GetEntityByUUID(m_SelectionContext);
+		if (!entity) {
 			return;
 		}
 
-		std::string id_string = fmt::format("UUID: {}", entity->GetID());
+		std::string id_string = fmt::format("UUID: {}", entity.GetUUID());
 
 		ImGui::Text(id_string.c_str());
 
-		if (entity->HasComponent<TagComponent>())
+		if (entity.HasComponent<TagComponent>())
 		{
-			auto tag = entity->GetComponent<TagComponent>();
+			auto tag = entity.GetComponent<TagComponent>();
 
 			char buffer[256];
 			memset(buffer, 0, sizeof(buffer));
@@ -360,11 +379,46 @@ namespace EditorPanels {
 
 		DrawComponent<TransformComponent>("Transform", entity, [](auto& component, auto entity)
 		{
+			glm::vec3 previous_translation = component->local_transform.translation;
+			glm::vec3 previous_scale = component->local_transform.scale;
+			Mobility previous_mobility = component->mobility;
+
 			DrawVec3Control("Translation", component->local_transform.translation);
-			glm::vec3 rotation = glm::degrees(component->local_transform.rotation);
+			glm::vec3 previous_rotation = glm::degrees(component->local_transform.rotation_euler);
+			glm::vec3 rotation = previous_rotation;
 			DrawVec3Control("Rotation", rotation);
-			component->local_transform.rotation = glm::radians(rotation);
+			// Only written back when changed, the degree round trip is not exact
+			if (rotation != previous_rotation)
+			{
+				component->local_transform.SetRotationEuler(glm::radians(rotation));
+			}
 			DrawVec3Control("Scale", component->local_transform.scale, 1.0f);
+
+			ImGui::Columns(2);
+			ImGui::SetColumnWidth(0, 100.f);
+			ImGui::Text("Mobility");
+			ImGui::NextColumn();
+			if (ImGui::BeginCombo("##Transform_mobility", MobilityToString(component->mobility)))
+			{
+				for (Mobility mobility : { Mobility::Dynamic, Mobility::Static })
+				{
+					if (ImGui::Selectable(MobilityToString(mobility), component->mobility == mobility))
+					{
+						component->mobility = mobility;
+					}
+				}
+				ImGui::EndCombo();
+			}
+			ImGui::Columns(1);
+
+			// Static entities are only picked up again by the transform pass when told to
+			bool edited = previous_translation != component->local_transform.translation
+				|| previous_rotation != rotation
+				|| previous_scale != component->local_transform.scale;
+			if (previous_mobility != component->mobility || (edited && component->IsStatic()))
+			{
+				entity.GetScene()->InvalidateStaticTransforms();
+			}
 		});
 
 		DrawComponent<ScriptComponent>("Script", entity, [](auto& component, auto entity) {
@@ -444,10 +498,10 @@ namespace EditorPanels {
 
 			if (component->IsPrimary && primary_camera_ID == 0)
 			{
-				primary_camera_ID = entity->GetID();
+				primary_camera_ID = m_SelectionContext;
 			}
 
-			bool is_primary = primary_camera_ID == entity->GetID();
+			bool is_primary = primary_camera_ID == m_SelectionContext;
 			component->IsPrimary = is_primary;
 			ImGui::Columns(2);
 			ImGui::SetColumnWidth(0, 100.f);
@@ -457,7 +511,7 @@ namespace EditorPanels {
 			{
 				if (is_primary)
 				{
-					primary_camera_ID = entity->GetID();
+					primary_camera_ID = m_SelectionContext;
 				}
 				else
 				{
@@ -873,19 +927,19 @@ namespace EditorPanels {
 				const auto payload_path = *(const std::filesystem::path*)payload->Data;
 				if (DesignAssetManager::GetAssetTypeFromFileExtension(payload_path.extension()) == AssetType::Audio)
 				{
-					auto entity = m_Scene->GetEntity(m_SelectionContext);
+					auto entity = m_Scene->GetEntityByUUID(m_SelectionContext);
 					const auto payload_path = *(const std::filesystem::path*)payload->Data;
 					Project::GetActiveDesignAssetManager()->ImportAsset(payload_path);
 					auto handle = Project::GetActiveDesignAssetManager()->GetHandleByPath(payload_path);
 					auto audioSource = AssetManager::GetAsset<AudioAsset>(handle);
 
 					GlobalSoundsComponent* component;
-					if (!entity->HasComponent<GlobalSoundsComponent>())
+					if (!entity.HasComponent<GlobalSoundsComponent>())
 					{
-						entity->AddComponent<GlobalSoundsComponent>(GlobalSoundsComponent());
+						entity.AddComponent<GlobalSoundsComponent>(GlobalSoundsComponent());
 						
 					}
-					component = entity->GetComponent<GlobalSoundsComponent>();
+					component = entity.GetComponent<GlobalSoundsComponent>();
 					component->Sounds.push_back(CreateRef<GlobalSource>(audioSource->Handle));
 				}
 			}
@@ -973,19 +1027,19 @@ namespace EditorPanels {
 				const auto payload_path = *(const std::filesystem::path*)payload->Data;
 				if (DesignAssetManager::GetAssetTypeFromFileExtension(payload_path.extension()) == AssetType::Audio)
 				{
-					auto entity = m_Scene->GetEntity(m_SelectionContext);
+					auto entity = m_Scene->GetEntityByUUID(m_SelectionContext);
 					const auto payload_path = *(const std::filesystem::path*)payload->Data;
 					Project::GetActiveDesignAssetManager()->ImportAsset(payload_path);
 					auto handle = Project::GetActiveDesignAssetManager()->GetHandleByPath(payload_path);
 					auto audioSource = AssetManager::GetAsset<AudioAsset>(handle);
 
 					LocalSoundsComponent* component;
-					if (!entity->HasComponent<LocalSoundsComponent>())
+					if (!entity.HasComponent<LocalSoundsComponent>())
 					{
-						entity->AddComponent<LocalSoundsComponent>(LocalSoundsComponent());
+						entity.AddComponent<LocalSoundsComponent>(LocalSoundsComponent());
 
 					}
-					component = entity->GetComponent<LocalSoundsComponent>();
+					component = entity.GetComponent<LocalSoundsComponent>();
 					component->Sounds.push_back(CreateRef<LocalSource>(audioSource->Handle));
 				}
 			}
@@ -1013,6 +1067,27 @@ namespace EditorPanels {
 					ImGui::SetTooltip("%s", mesh_relative_path.string().c_str());
 				}
 				ImGui::Columns(1);
+
+				auto mesh_source = component->mesh->GetMeshSource();
+				ImGui::Columns(2);
+				ImGui::SetColumnWidth(0, 100.f);
+				ImGui::Text("LOD Bias");
+				ImGui::NextColumn();
+				ImGui::DragFloat("##mesh_lod_bias", &component->lod_bias, 0.05f, 0.05f, 10.f);
+				ImGui::Columns(1);
+
+				ImGui::Columns(2);
+				ImGui::SetColumnWidth(0, 100.f);
+				ImGui::Text("Forced LOD");
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("-1 picks the level from the size on screen");
+				}
+				ImGui::NextColumn();
+				ImGui::SliderInt("##mesh_forced_lod", &component->forced_lod, -1, (int)mesh_source->GetLODCount() - 1);
+				ImGui::Columns(1);
+
+				ImGui::Text("Drawn at LOD %u of %u", component->mesh->GetLOD(), mesh_source->GetLODCount());
 			}
 
 			DrawDropBox("Drop mesh here to change");
@@ -1028,21 +1103,21 @@ namespace EditorPanels {
 				const auto payload_path = *(const std::filesystem::path*)payload->Data;
 				if (DesignAssetManager::GetAssetTypeFromFileExtension(payload_path.extension()) == AssetType::MeshSource)
 				{
-					auto entity = m_Scene->GetEntity(m_SelectionContext);
+					auto entity = m_Scene->GetEntityByUUID(m_SelectionContext);
 					const auto payload_path = *(const std::filesystem::path*)payload->Data;
 					Project::GetActiveDesignAssetManager()->ImportAsset(payload_path);
 					auto handle = Project::GetActiveDesignAssetManager()->GetHandleByPath(payload_path);
 					auto meshSource = AssetManager::GetAsset<MeshSource>(handle);
 
-					if (entity->HasComponent<MeshComponent>())
+					if (entity.HasComponent<MeshComponent>())
 					{
-						auto component = entity->GetComponent<MeshComponent>();
+						auto component = entity.GetComponent<MeshComponent>();
 						component->mesh->SetMeshSource(meshSource);
 					}
 					else
 					{
 						MeshComponent new_comp(CreateRef<Mesh>(meshSource));
-						entity->AddComponent<MeshComponent>(new_comp);
+						entity.AddComponent<MeshComponent>(new_comp);
 					}
 				}
 			}
@@ -1071,12 +1146,12 @@ namespace EditorPanels {
 
 	template<typename T>
 	void SceneGraph::DisplayAddComponentEntry(const std::string& entryName) {
-		auto entity = m_Scene->GetEntity(m_SelectionContext);
-		if (!entity->HasComponent<T>())
+		auto entity = m_Scene->GetEntityByUUID(m_SelectionContext);
+		if (!entity.HasComponent<T>())
 		{
 			if (ImGui::MenuItem(entryName.c_str()))
 			{
-				entity->AddComponent<T>(T());
+				entity.AddComponent<T>(T());
 				ImGui::CloseCurrentPopup();
 			}
 		}
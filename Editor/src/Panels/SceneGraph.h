@@ -18,7 +18,7 @@ namespace EditorPanels {
 			s_Instance->RenderImpl();
 		}
 
-		static Entity* GetSelectedEntity() {
+		static Entity GetSelectedEntity() {
 			Create();
 			return s_Instance->GetSelectedEntityImpl();
 		}
@@ -46,8 +46,8 @@ namespace EditorPanels {
 	private:
 		void SetActiveScene(Ref<Scene> scene) { m_Scene = scene; }
 		void RenderImpl();
-		void DisplaySceneEntity(SceneNode* node);
-		Entity* GetSelectedEntityImpl() { return m_Scene->GetEntity(m_SelectionContext); }
+		void DisplaySceneEntity(EntityId entity_id);
+		Entity GetSelectedEntityImpl() { return m_Scene->GetEntityByUUID(m_SelectionContext); }
 		void SetSelectedEntityImpl(UUID id){ m_SelectionContext = id; }
 		void DrawComponents();
 
@@ -61,5 +61,13 @@ namespace EditorPanels {
 		Ref<Scene> m_Scene;
 		static SceneGraph* s_Instance;
 		UUID m_SelectionContext = 0;
+
+		// Drops are applied after the hierarchy has been drawn, so the sibling links being walked stay put
+		struct PendingReparent
+		{
+			EntityId Entity;
+			EntityId NewParent;
+		};
+		std::vector<PendingReparent> m_PendingReparents;
 	};
 }
@@ -75,6 +75,33 @@ namespace EditorPanels {
 				}
 			});
 		});
-		
+
+		DrawSection("World Partition", [context]()
+		{
+			WorldPartition& world_partition = context->GetWorldPartition();
+			WorldPartitionSettings settings = world_partition.GetSettings();
+			bool changed = false;
+
+			DrawOption("Enabled", [&]()
+			{
+				changed |= ImGui::Checkbox("##world_partition_enabled", &settings.Enabled);
+			});
+			DrawOption("Cell Size", [&]()
+			{
+				// Changing it loads every cell, so only once the value is committed
+				ImGui::DragFloat("##world_partition_cell_size", &settings.CellSize, 1.0f, 1.0f, 10000.0f, "%.0f");
+				changed |= ImGui::IsItemDeactivatedAfterEdit();
+			});
+			DrawOption("Load Radius", [&]()
+			{
+				changed |= ImGui::DragFloat("##world_partition_load_radius", &settings.LoadRadius, 1.0f, 0.0f, 100000.0f, "%.0f");
+			});
+			ImGui::Text("Cells: %u loaded, %u loading, %u total", world_partition.GetLoadedCellCount(), world_partition.GetPendingCellCount(), world_partition.GetCellCount());
+
+			if (changed)
+			{
+				world_partition.SetSettings(settings);
+			}
+		});
 	}
 }
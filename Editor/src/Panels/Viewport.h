@@ -99,8 +99,8 @@ namespace EditorPanels {
 			m_ViewportBounds[0] = { minBound.x, minBound.y };
 			m_ViewportBounds[1] = { maxBound.x, maxBound.y };
 
-			Entity* selectedEntity = SceneGraph::GetSelectedEntity();
-			if (selectedEntity != nullptr && m_UsingEditor)
+			Entity selectedEntity = SceneGraph::GetSelectedEntity();
+			if (selectedEntity && m_UsingEditor)
 			{
 				ImGuizmo::SetOrthographic(false);
 				ImGuizmo::SetDrawlist();
@@ -110,7 +110,7 @@ namespace EditorPanels {
 				const glm::mat4& cameraProjection = camera->GetProjection();
 				glm::mat4 cameraView = camera->GetView();
 
-				auto tc = selectedEntity->GetComponent<TransformComponent>();
+				auto tc = selectedEntity.GetComponent<TransformComponent>();
 				glm::mat4 transform = tc->local_transform.mat4();
 
 				bool snap = Input::IsKeyPressed(KEY_LEFT_CONTROL);
@@ -129,10 +129,14 @@ namespace EditorPanels {
 					glm::vec3 translation, rotation, scale;
 					Math::DecomposeTransform(transform, translation, rotation, scale);
 
-					glm::vec3 deltaRotation = rotation - tc->local_transform.rotation;
+					glm::vec3 deltaRotation = rotation - tc->local_transform.rotation_euler;
 					tc->local_transform.translation = translation;
-					tc->local_transform.rotation += deltaRotation;
+					tc->local_transform.SetRotationEuler(tc->local_transform.rotation_euler + deltaRotation);
 					tc->local_transform.scale = scale;
+					if (tc->IsStatic())
+					{
+						selectedEntity.GetScene()->InvalidateStaticTransforms();
+					}
 				}
 			}
 		}
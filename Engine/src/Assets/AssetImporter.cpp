@@ -5,6 +5,7 @@
 #include "ModelImporter.h"
 #include "AudioImporter.h"
 #include "Scene/Scene.h"
+#include "Scene/Prefab.h"
 
 namespace Engine {
 
@@ -13,6 +14,7 @@ namespace Engine {
 	{
 		// Project asset is excluded because the asset manager depends on it so we have the project loader managed by the project file itself (since no more than one project will ever be loaded in a project...)
 		{AssetType::Scene, Scene::LoadScene},
+		{AssetType::Prefab, Prefab::LoadPrefab},
 		{AssetType::Texture, TextureImporter::Import2D},
 		{AssetType::CubeMap, TextureImporter::ImportCube},
 		{AssetType::MeshSource, ModelImporter::ImportSource},
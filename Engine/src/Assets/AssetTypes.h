@@ -13,7 +13,8 @@ namespace Engine{
 		Material,
 		Audio,
 		Texture,
-		CubeMap
+		CubeMap,
+		Prefab
 	};
 
 	namespace Utils {
@@ -31,6 +32,7 @@ namespace Engine{
 				case AssetType::Audio:        return "Audio";
 				case AssetType::Texture:      return "Texture";
 				case AssetType::CubeMap:      return "CubeMap";
+				case AssetType::Prefab:       return "Prefab";
 			}
 		}
 
@@ -44,6 +46,7 @@ namespace Engine{
 			if (type_string == "Texture")             return AssetType::Texture;
 			if (type_string == "CubeMap")             return AssetType::CubeMap;
 			if (type_string == "Audio")               return AssetType::Audio;
+			if (type_string == "Prefab")              return AssetType::Prefab;
 		}
 	}
 }
@@ -10,6 +10,7 @@ namespace Engine {
 		{ ".hvescn", AssetType::Scene },
 		{ ".hvereg", AssetType::AssetRegistry },
 		{ ".hvemat", AssetType::Material },
+		{ ".hveprefab", AssetType::Prefab },
 		{ ".fbx", AssetType::MeshSource },
 		{ ".FBX", AssetType::MeshSource },
 		{ ".gltf", AssetType::MeshSource },
@@ -123,6 +124,40 @@ namespace Engine {
 		HVE_CORE_ERROR_TAG("Asset Importer", "Failed to import asset at path {0}", file_path.string());
 		return 0;
 	}
+	void DesignAssetManager::AddLoadedAsset(AssetHandle handle, Ref<Asset> asset)
+	{
+		HVE_CORE_ASSERT(IsAssetHandleValid(handle), "Asset {0} is not registered", handle);
+		asset->Handle = handle;
+		m_LoadedAssets[handle] = asset;
+	}
+	bool DesignAssetManager::UnloadAsset(AssetHandle handle)
+	{
+		auto it = m_LoadedAssets.find(handle);
+		if (it == m_LoadedAssets.end())
+		{
+			return true;
+		}
+		if (it->second && it->second.use_count() > 1)
+		{
+			return false;
+		}
+		m_LoadedAssets.erase(it);
+		return true;
+	}
+	void DesignAssetManager::UnloadUnusedMemoryAssets()
+	{
+		for (auto it = m_LoadedAssets.begin(); it != m_LoadedAssets.end();)
+		{
+			const AssetMetadata& metadata = GetMetadata(it->first);
+			if (metadata.IsEmbedded && (!it->second || it->second.use_count() == 1))
+			{
+				m_AssetRegistry.Remove(it->first);
+				it = m_LoadedAssets.erase(it);
+				continue;
+			}
+			++it;
+		}
+	}
 	void DesignAssetManager::RegisterAsset(AssetHandle handle, const std::filesystem::path& file_path)
 	{
 		std::filesystem::path new_file_path = file_path;
@@ -30,6 +30,14 @@ namespace Engine {
 			return asset->Handle;
 		}
 
+		// Hands over an asset that was imported outside GetAsset, e.g. on a worker thread
+		void AddLoadedAsset(AssetHandle handle, Ref<Asset> asset);
+		// Drops the loaded asset if nothing outside the manager holds it anymore, GetAsset imports it again on demand.
+		// Returns false if it is still in use.
+		bool UnloadAsset(AssetHandle handle);
+		// Memory only assets can not be imported again, so these are forgotten entirely once nothing holds them
+		void UnloadUnusedMemoryAssets();
+
 		void RegisterAsset(AssetHandle handle, const std::filesystem::path& file_path);
 		void UnregsiterAsset(AssetHandle handle);
 
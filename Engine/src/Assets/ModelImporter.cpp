@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "ModelImporter.h"
 #include "Renderer/Renderer.h"
+#include "Renderer/MeshSimplifier.h"
 #include "Project/Project.h"
 #include "TextureImporter.h"
 #include "Serialization/YAMLSerializer.h"
@@ -21,23 +22,109 @@ static const uint32_t s_MeshImportFlags =
 
 namespace Engine {
 
+	// Texture slots read by BuildSource, ReadSource decodes the files they point at ahead of time
+	static const aiTextureType s_MaterialTextureTypes[] = {
+		aiTextureType_DIFFUSE,
+		aiTextureType_SPECULAR,
+		aiTextureType_NORMALS,
+		aiTextureType_SHININESS,
+		aiTextureType_UNKNOWN,
+		aiTextureType_LIGHTMAP,
+		aiTextureType_EMISSIVE
+	};
+
+	static std::filesystem::path ResolveTexturePath(const std::filesystem::path& directory, const aiString& ai_path)
+	{
+		auto texture_path = directory / ai_path.C_Str();
+		if (!std::filesystem::exists(texture_path))
+		{
+			texture_path = directory / texture_path.filename();
+		}
+		return texture_path;
+	}
+
+	static Ref<Texture2D> LoadMaterialTexture(MeshSourceData& data, const std::filesystem::path& path)
+	{
+		auto it = data.Textures.find(path.string());
+		if (it == data.Textures.end())
+		{
+			return TextureImporter::Import2DWithPath(path.string());
+		}
+		Ref<Texture2D> texture = TextureImporter::Create2D(it->second);
+		data.Textures.erase(it);
+		return texture;
+	}
+
+	MeshSourceData::~MeshSourceData()
+	{
+		for (auto& [path, texture] : Textures)
+		{
+			TextureImporter::Free(texture);
+		}
+	}
+
 	Ref<MeshSource> ModelImporter::ImportSource(AssetHandle handle, const AssetMetadata& metadata)
 	{
-		Ref<MeshSource> meshSource = CreateRef<MeshSource>();
-		Math::BoundingBox globalBounds;
-		std::filesystem::path full_asset_path = Project::GetFullFilePath(metadata.FilePath);
-		HVE_CORE_INFO_TAG("Mesh loader", "Loading mesh: {0}", full_asset_path);
+		Scope<MeshSourceData> data = ReadSource(metadata);
+		if (!data)
+		{
+			return nullptr;
+		}
+		return BuildSource(*data);
+	}
 
-		Assimp::Importer importer;
-		importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
-		const aiScene* scene = importer.ReadFile(full_asset_path.string(), s_MeshImportFlags);
+	Scope<MeshSourceData> ModelImporter::ReadSource(const AssetMetadata& metadata)
+	{
+		HVE_PROFILE_FUNC();
+		Scope<MeshSourceData> data = CreateScope<MeshSourceData>();
+		data->FilePath = Project::GetFullFilePath(metadata.FilePath);
+		HVE_CORE_INFO_TAG("Mesh loader", "Loading mesh: {0}", data->FilePath);
+
+		data->Importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
+		data->Scene = data->Importer.ReadFile(data->FilePath.string(), s_MeshImportFlags);
 
-		if (!scene)
+		if (!data->Scene)
 		{
-			HVE_CORE_ERROR_TAG("Mesh", "Failed to load mesh file: {0}", full_asset_path.string());
+			HVE_CORE_ERROR_TAG("Mesh", "Failed to load mesh file: {0}", data->FilePath.string());
 			return nullptr;
 		}
 
+		// Decode the texture files here, they are the slow part of building the materials
+		const std::filesystem::path directory = data->FilePath.parent_path();
+		for (uint32_t i = 0; i < data->Scene->mNumMaterials; i++)
+		{
+			const aiMaterial* ai_material = data->Scene->mMaterials[i];
+			for (aiTextureType type : s_MaterialTextureTypes)
+			{
+				aiString ai_path;
+				if (ai_material->GetTexture(type, 0, &ai_path) != AI_SUCCESS || data->Scene->GetEmbeddedTexture(ai_path.C_Str()))
+				{
+					continue;
+				}
+
+				std::string path = ResolveTexturePath(directory, ai_path).string();
+				if (data->Textures.contains(path))
+				{
+					continue;
+				}
+				TextureData texture;
+				if (TextureImporter::Decode2D(path, texture))
+				{
+					data->Textures.emplace(path, texture);
+				}
+			}
+		}
+		return data;
+	}
+
+	Ref<MeshSource> ModelImporter::BuildSource(MeshSourceData& data)
+	{
+		HVE_PROFILE_FUNC();
+		Ref<MeshSource> meshSource = CreateRef<MeshSource>();
+		Math::BoundingBox globalBounds;
+		const std::filesystem::path& full_asset_path = data.FilePath;
+		const aiScene* scene = data.Scene;
+
 		std::vector<MeshNode> nodes;
 		std::vector<Submesh> meshes;
 		std::vector<Ref<Material>> materials;
@@ -126,7 +213,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    Albedo map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -192,7 +279,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    Specular color map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -255,7 +342,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    Normal map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -320,7 +407,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    Roughness map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -383,7 +470,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    Metalness map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -448,7 +535,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    AO map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -511,7 +598,7 @@ namespace Engine {
 							texturePath = directory / texturePath.filename();
 						}
 						HVE_CORE_TRACE_TAG("Model Library", "    Emission map path = {0}", texturePath);
-						auto new_texture = TextureImporter::Import2DWithPath(texturePath.string());
+						auto new_texture = LoadMaterialTexture(data, texturePath);
 						if (new_texture)
 						{
 							texture_id = Project::GetActive()->GetDesignAssetManager()->CreateMemoryOnlyAsset<Texture2D>(new_texture);
@@ -659,6 +746,11 @@ namespace Engine {
 			}
 		}
 
+		// Coarser levels go after LOD 0 in the same index buffer
+		Submesh& submesh = mesh_destination[mesh_destination.size() - 1];
+		submesh.LODs.push_back({ 0, (uint32_t)indices.size(), (uint32_t)vertices.size() });
+		MeshSimplifier::GenerateLODs(vertices, indices, submesh.Bounds, submesh.LODs, MeshSource::MaxLODs);
+
 		mesh_destination[mesh_destination.size() - 1].VertexArray = VertexArray::Create();
 
 
@@ -678,7 +770,7 @@ namespace Engine {
 		mesh_destination[mesh_destination.size() - 1].VertexArray->SetIndexBuffer(indexBuffer);
 
 		vertex_count += (int)vertices.size();
-		index_count += (int)indices.size();
+		index_count += (int)submesh.LODs[0].IndexCount;
 
 		return (uint32_t)(mesh_destination.size()) - 1;
 	}
@@ -2,6 +2,7 @@
 
 #include <Renderer/Mesh.h>
 #include "AssetManager.h"
+#include "TextureImporter.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -9,10 +10,27 @@
 
 namespace Engine {
 
+	// What ModelImporter::ReadSource gets out of a model file without touching the GL context, ModelImporter::BuildSource
+	// turns it into a MeshSource
+	struct MeshSourceData
+	{
+		std::filesystem::path FilePath;
+		// Owns Scene
+		Assimp::Importer Importer;
+		const aiScene* Scene = nullptr;
+		// Decoded material textures by file path
+		std::unordered_map<std::string, TextureData> Textures;
+
+		~MeshSourceData();
+	};
+
 	class ModelImporter
 	{
 	public:
 		static Ref<MeshSource> ImportSource(AssetHandle handle, const AssetMetadata& metadata);
+		// ImportSource in two halves, ReadSource is safe on any thread and BuildSource uploads on the render thread
+		static Scope<MeshSourceData> ReadSource(const AssetMetadata& metadata);
+		static Ref<MeshSource> BuildSource(MeshSourceData& data);
 		static Ref<Mesh> Import(AssetHandle handle, const AssetMetadata& metadata);
 		static void Serialize(AssetHandle handle, const AssetMetadata& metadata);
 
@@ -2,6 +2,7 @@
 #include "TextureImporter.h"
 #include "Core/Buffer.h"
 #include "Project/Project.h"
+#include "DesignAssetManager.h"
 
 #define STBI_NO_SIMD
 #define STB_IMAGE_IMPLEMENTATION
@@ -64,30 +65,39 @@ namespace Engine {
 	}
 
 	Ref<Texture2D> TextureImporter::Import2DWithPath(const std::string& path)
+	{
+		HVE_PROFILE_FUNC();
+		TextureData data;
+		if (!Decode2D(path, data))
+		{
+			return nullptr;
+		}
+		return Create2D(data);
+	}
+
+	bool TextureImporter::Decode2D(const std::filesystem::path& path, TextureData& out)
 	{
 		HVE_PROFILE_FUNC();
 		int width, height, channels;
 		stbi_set_flip_vertically_on_load(1);
 		Buffer data = nullptr;
-		std::filesystem::path full_path = path;
-		AssetType type = Project::GetActiveDesignAssetManager()->GetAssetTypeFromFileExtension(full_path.extension());
+		AssetType type = DesignAssetManager::GetAssetTypeFromFileExtension(path.extension());
 		{
-			HVE_PROFILE_SCOPE("stbi_load - TextureImporter::Import");
+			HVE_PROFILE_SCOPE("stbi_load - TextureImporter::Decode2D");
 			if (type == AssetType::CubeMap)
 			{
-				data.Data = stbi_loadf(full_path.string().c_str(), &width, &height, &channels, 0);
+				data.Data = stbi_loadf(path.string().c_str(), &width, &height, &channels, 0);
 			}
 			else
 			{
-				data.Data = stbi_load(full_path.string().c_str(), &width, &height, &channels, 0);
+				data.Data = stbi_load(path.string().c_str(), &width, &height, &channels, 0);
 			}
 		}
 
-
 		if (data.Data == nullptr)
 		{
 			HVE_CORE_ERROR_TAG("Texture Importer", "Could not load texture for file path: {0}", path);
-			return nullptr;
+			return false;
 		}
 
 		data.Size = width * height * channels;
@@ -111,12 +121,25 @@ namespace Engine {
 				HVE_CORE_ASSERT(false, "Image has an invalid format");
 		}
 
+		out.Data = data;
+		out.Spec = spec;
+		return true;
+	}
 
-
-		Ref<Texture2D> texture = Texture2D::Create(spec, data);
-		stbi_image_free(data.Data);
+	Ref<Texture2D> TextureImporter::Create2D(TextureData& data)
+	{
+		HVE_PROFILE_FUNC();
+		Ref<Texture2D> texture = Texture2D::Create(data.Spec, data.Data);
+		Free(data);
 		return texture;
 	}
+
+	void TextureImporter::Free(TextureData& data)
+	{
+		stbi_image_free(data.Data.Data);
+		data.Data = Buffer();
+	}
+
 	Ref<TextureCube> TextureImporter::ImportCube(AssetHandle handle, const AssetMetadata& metadata)
 	{
 		Ref<Texture2D> flat_texture = Import2D(handle, metadata);
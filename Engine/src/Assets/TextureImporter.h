@@ -1,15 +1,29 @@
 #pragma once
 #include "Renderer/Texture.h"
 #include "AssetMetadata.h"
+#include "Core/Buffer.h"
 
 
 namespace Engine {
+	// Pixels decoded by TextureImporter::Decode2D, which can run on any thread, waiting to be uploaded by Create2D
+	struct TextureData
+	{
+		Buffer Data;
+		TextureSpecification Spec;
+	};
+
 	class TextureImporter
 	{
 	public:
 		static Ref<Texture2D> Import2D(AssetHandle handle, const AssetMetadata& metadata);
 		static Ref<Texture2D> Import2DWithPath(const std::string& path);
 
+		// Decoding only touches the file, the upload needs the GL context. Create2D frees the pixels.
+		static bool Decode2D(const std::filesystem::path& path, TextureData& out);
+		static Ref<Texture2D> Create2D(TextureData& data);
+		// Frees the pixels of data that is never uploaded
+		static void Free(TextureData& data);
+
 		static Ref<TextureCube> ImportCube(AssetHandle handle, const AssetMetadata& metadata);
 		static Ref<TextureCube> ImportCubeWithPath(const std::string& path);
 	};
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Core/Base.h"
 #include "Application.h"
+#include "JobSystem.h"
 #include "Script/ScriptEngine.h"
 
 #include "Renderer/Renderer.h"
@@ -12,7 +13,7 @@ namespace Engine
 {
 	Application* Application::s_Instance = nullptr;
 
-	Application::Application(WindowProps props, ApplicationProps app_props) : m_AppProps(app_props)
+	Application::Application(WindowProps props, ApplicationProps app_props) : m_FramePacer(app_props.FramePacing), m_AppProps(app_props)
 	{
 		HVE_CORE_ASSERT(!s_Instance, "Application already exists!");
 		s_Instance = this;
@@ -22,6 +23,7 @@ namespace Engine
 		m_ImGuiLayer = new ImGuiLayer();
 		PushOverlay(m_ImGuiLayer);
 
+		JobSystem::Init();
 		SoundEngine::Init();
 
 		if (!m_AppProps.NoScripting)
@@ -60,6 +62,8 @@ namespace Engine
 		{
 			(*--it)->OnDetach();
 		}
+
+		JobSystem::Shutdown();
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -83,22 +87,17 @@ namespace Engine
 		m_Window->SetMaximized(m_Window->GetMaximized());
 		m_Window->SetFullScreen(m_Window->GetFullScreen(), m_Window->GetFullScreenType());
 
-		auto last_frame = std::chrono::high_resolution_clock::now();
 		//PhysicsEngine::tmpRunner();
 		while (m_Running)
 		{
-			auto newTime = std::chrono::high_resolution_clock::now();
-			float frameTime = std::chrono::duration<float, std::chrono::seconds::period>(newTime - last_frame).count();
-			last_frame = newTime;
-			double currentTime = std::chrono::duration<double>(newTime.time_since_epoch()).count();
-			m_FrameData.DeltaTime = frameTime;
-			Renderer::Get()->GetStats()->UpdateFPS(currentTime, frameTime);
+			m_FrameData = m_FramePacer.BeginFrame();
+			Renderer::Get()->GetStats()->UpdateFPS(m_FramePacer.GetTime(), m_FrameData.RawDeltaTime);
 
 			if (!m_Minimized) {
 
 				for (Layer* layer : m_LayerStack)
 				{
-					layer->OnUpdate(frameTime);
+					layer->OnUpdate(m_FrameData.DeltaTime);
 				}
 
 
@@ -111,6 +110,7 @@ namespace Engine
 			}
 
 			m_Window->OnUpdate();
+			m_FramePacer.EndFrame(m_Minimized);
 			HVE_PROFILE_MARK_FRAME;
 		}
 	}
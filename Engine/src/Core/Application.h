@@ -1,19 +1,16 @@
 #pragma once
 #include "LayerStack.h"
 #include "Window.h"
+#include "FramePacer.h"
 #include "Events/ApplicationEvent.h"
 #include "ImGui/ImGuiLayer.h"
 
 namespace Engine
 {
-	struct FrameData
-	{
-		float DeltaTime = 0.0f;
-	};
-
 	struct ApplicationProps
 	{
 		bool NoScripting = false;
+		FramePacerSettings FramePacing;
 	};
 
 	class Application
@@ -30,6 +27,7 @@ namespace Engine
 		void OnEvent(Event& event);
 		void Close();
 		FrameData& GetFrameData() { return m_FrameData; }
+		FramePacer& GetFramePacer() { return m_FramePacer; }
 		static Application& Get() { return *s_Instance; }
 		Window& GetWindow() { return *m_Window; }
 		ApplicationProps& GetProps() { return m_AppProps; }
@@ -44,6 +42,7 @@ namespace Engine
 		bool m_Minimized = false;
 		LayerStack m_LayerStack;
 
+		FramePacer m_FramePacer;
 		FrameData m_FrameData;
 
 	private:
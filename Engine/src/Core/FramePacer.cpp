@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "FramePacer.h"
+#include <thread>
+
+#ifdef PLATFORM_WINDOWS
+#include <timeapi.h>
+#endif
+
+namespace Engine {
+
+	// The spin margin never drops below this, a sleep can always come back a little late
+	static constexpr double s_MinSpinMargin = 0.0005;
+	static constexpr double s_MaxSpinMargin = 0.02;
+
+	FramePacer::FramePacer(const FramePacerSettings& settings)
+		: m_Start(Clock::now())
+	{
+		SetSettings(settings);
+#ifdef PLATFORM_WINDOWS
+		// The default scheduler tick is 15.6ms, far too coarse to sleep out part of a frame
+		timeBeginPeriod(1);
+#endif
+	}
+
+	FramePacer::~FramePacer()
+	{
+#ifdef PLATFORM_WINDOWS
+		timeEndPeriod(1);
+#endif
+	}
+
+	void FramePacer::SetSettings(const FramePacerSettings& settings)
+	{
+		m_Settings = settings;
+		m_Settings.MaxDeltaTime = std::max(m_Settings.MaxDeltaTime, 0.001f);
+		m_Settings.MaxFixedSteps = std::max(m_Settings.MaxFixedSteps, 1u);
+		m_Accumulator = 0.0;
+	}
+
+	const FrameData& FramePacer::BeginFrame()
+	{
+		Clock::time_point now = Clock::now();
+		float raw_delta = m_FirstFrame ? 0.0f : std::chrono::duration<float>(now - m_FrameStart).count();
+		m_FrameStart = now;
+		m_FirstFrame = false;
+
+		m_FrameData.RawDeltaTime = raw_delta;
+		m_FrameData.DeltaTime = std::min(raw_delta, m_Settings.MaxDeltaTime);
+
+		if (m_Settings.FixedUpdateRate == 0)
+		{
+			m_FrameData.FixedDeltaTime = m_FrameData.DeltaTime;
+			m_FrameData.FixedSteps = 1;
+			m_FrameData.Alpha = 1.0f;
+			return m_FrameData;
+		}
+
+		double step = 1.0 / m_Settings.FixedUpdateRate;
+		m_Accumulator += m_FrameData.DeltaTime;
+		uint32_t steps = (uint32_t)(m_Accumulator / step);
+		if (steps > m_Settings.MaxFixedSteps)
+		{
+			// Whatever does not fit is dropped, the simulation runs slow for this frame instead of catching up later
+			steps = m_Settings.MaxFixedSteps;
+			m_Accumulator = std::fmod(m_Accumulator, step);
+		}
+		else
+		{
+			m_Accumulator -= steps * step;
+		}
+
+		m_FrameData.FixedDeltaTime = (float)step;
+		m_FrameData.FixedSteps = steps;
+		m_FrameData.Alpha = (float)(m_Accumulator / step);
+		return m_FrameData;
+	}
+
+	void FramePacer::EndFrame(bool background)
+	{
+		HVE_PROFILE_FUNC();
+		uint32_t target_fps = background ? m_Settings.BackgroundFPS : m_Settings.TargetFPS;
+		if (target_fps == 0)
+		{
+			return;
+		}
+		WaitUntil(m_FrameStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / target_fps)));
+	}
+
+	double FramePacer::GetTime() const
+	{
+		return std::chrono::duration<double>(Clock::now() - m_Start).count();
+	}
+
+	void FramePacer::WaitUntil(Clock::time_point deadline)
+	{
+		while (true)
+		{
+			Clock::time_point now = Clock::now();
+			double remaining = std::chrono::duration<double>(deadline - now).count();
+			if (remaining <= m_SpinMargin)
+			{
+				break;
+			}
+
+			double requested = remaining - m_SpinMargin;
+			std::this_thread::sleep_for(std::chrono::duration<double>(requested));
+			double slept = std::chrono::duration<double>(Clock::now() - now).count();
+
+			// Grow at once when a sleep came back late, shrink slowly while they are on time
+			double oversleep = slept - requested;
+			m_SpinMargin = oversleep > m_SpinMargin ? oversleep : m_SpinMargin * 0.95 + oversleep * 0.05;
+			m_SpinMargin = std::clamp(m_SpinMargin, s_MinSpinMargin, s_MaxSpinMargin);
+		}
+
+		while (Clock::now() < deadline)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <chrono>
+
+namespace Engine {
+
+	struct FrameData
+	{
+		// Time the frame covers, clamped to FramePacerSettings::MaxDeltaTime
+		float DeltaTime = 0.0f;
+		// Wall clock time since the previous frame started
+		float RawDeltaTime = 0.0f;
+		// Length of one simulation step, DeltaTime when there is no fixed rate
+		float FixedDeltaTime = 0.0f;
+		// Simulation steps to take this frame, always 1 without a fixed rate
+		uint32_t FixedSteps = 1;
+		// How far the rendered frame is past the last simulation step, in steps. 1 without a fixed rate.
+		float Alpha = 1.0f;
+	};
+
+	struct FramePacerSettings
+	{
+		// 0 leaves the frame rate to vsync
+		uint32_t TargetFPS = 0;
+		// Used while the window is minimized, there is nothing to draw
+		uint32_t BackgroundFPS = 10;
+		// A hitch or a breakpoint is handed to the frame as this much time at most
+		float MaxDeltaTime = 0.25f;
+		// Steps per second of the simulation, 0 steps it once per frame with the frame's delta
+		uint32_t FixedUpdateRate = 0;
+		// Beyond this many steps in one frame the simulation falls behind rather than spiraling
+		uint32_t MaxFixedSteps = 8;
+	};
+
+	// Times the main loop. BeginFrame measures the frame and works out the fixed simulation steps, EndFrame waits
+	// out the rest of the target frame time. The wait sleeps while the deadline is far and spins the last stretch,
+	// the margin follows how late the OS has been waking the thread up.
+	class FramePacer
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit FramePacer(const FramePacerSettings& settings = FramePacerSettings());
+		~FramePacer();
+
+		const FramePacerSettings& GetSettings() const { return m_Settings; }
+		void SetSettings(const FramePacerSettings& settings);
+
+		const FrameData& BeginFrame();
+		void EndFrame(bool background = false);
+
+		const FrameData& GetFrameData() const { return m_FrameData; }
+		// Seconds since the pacer was created
+		double GetTime() const;
+
+	private:
+		void WaitUntil(Clock::time_point deadline);
+
+	private:
+		FramePacerSettings m_Settings;
+		FrameData m_FrameData;
+
+		Clock::time_point m_Start;
+		Clock::time_point m_FrameStart;
+		bool m_FirstFrame = true;
+
+		// Simulation time not yet consumed by a fixed step
+		double m_Accumulator = 0.0;
+		// How long before the deadline sleeping stops, in seconds
+		double m_SpinMargin = 0.002;
+	};
+}
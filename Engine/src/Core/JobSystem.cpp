@@ -0,0 +1,202 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <condition_variable>
+
+namespace Engine {
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::deque<std::pair<JobSystem::Job, JobCounter*>> Jobs;
+	};
+
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+		std::vector<Scope<WorkerQueue>> Queues; // One per worker plus a shared one at the end for outside threads
+
+		std::mutex SleepMutex;
+		std::condition_variable WakeCondition;
+		std::atomic<uint32_t> QueuedJobs = 0;
+		std::atomic<bool> Running = false;
+	};
+
+	static JobSystemData* s_Data = nullptr;
+	static thread_local int32_t s_WorkerIndex = -1;
+
+	static void ExecuteJob(std::pair<JobSystem::Job, JobCounter*>& job)
+	{
+		job.first();
+		if (job.second)
+		{
+			job.second->Pending.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	}
+
+	static bool PopJob(std::pair<JobSystem::Job, JobCounter*>& out_job)
+	{
+		if (s_Data->QueuedJobs.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		size_t queue_count = s_Data->Queues.size();
+		size_t own_index = s_WorkerIndex >= 0 ? (size_t)s_WorkerIndex : queue_count - 1;
+
+		// Own queue first, newest job, since its data is most likely still in cache
+		{
+			WorkerQueue& queue = *s_Data->Queues[own_index];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (!queue.Jobs.empty())
+			{
+				out_job = std::move(queue.Jobs.back());
+				queue.Jobs.pop_back();
+				s_Data->QueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+				return true;
+			}
+		}
+
+		// Steal the oldest job of someone else
+		for (size_t i = 1; i < queue_count; i++)
+		{
+			WorkerQueue& queue = *s_Data->Queues[(own_index + i) % queue_count];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (!queue.Jobs.empty())
+			{
+				out_job = std::move(queue.Jobs.front());
+				queue.Jobs.pop_front();
+				s_Data->QueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void WorkerLoop(int32_t index)
+	{
+		s_WorkerIndex = index;
+		std::string thread_name = "Job Worker " + std::to_string(index);
+		HVE_PROFILE_THREAD(thread_name.c_str());
+
+		std::pair<JobSystem::Job, JobCounter*> job;
+		while (s_Data->Running.load(std::memory_order_acquire))
+		{
+			if (PopJob(job))
+			{
+				ExecuteJob(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->WakeCondition.wait(lock, []() {
+				return s_Data->QueuedJobs.load(std::memory_order_acquire) > 0 || !s_Data->Running.load(std::memory_order_acquire);
+			});
+		}
+	}
+
+	void JobSystem::Init(uint32_t thread_count)
+	{
+		HVE_CORE_ASSERT(!s_Data, "JobSystem already initialized!");
+		if (thread_count == 0)
+		{
+			uint32_t hardware_threads = std::thread::hardware_concurrency();
+			thread_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+		}
+
+		s_Data = new JobSystemData();
+		s_Data->Running = true;
+		for (uint32_t i = 0; i < thread_count + 1; i++)
+		{
+			s_Data->Queues.push_back(CreateScope<WorkerQueue>());
+		}
+		for (uint32_t i = 0; i < thread_count; i++)
+		{
+			s_Data->Workers.emplace_back(WorkerLoop, (int32_t)i);
+		}
+		HVE_CORE_INFO_TAG("JobSystem", "Started {} worker threads", thread_count);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!s_Data)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->Running = false;
+		}
+		s_Data->WakeCondition.notify_all();
+		for (auto& worker : s_Data->Workers)
+		{
+			worker.join();
+		}
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_Data ? (uint32_t)s_Data->Workers.size() : 0;
+	}
+
+	void JobSystem::Submit(Job job, JobCounter* counter)
+	{
+		if (!s_Data || s_Data->Workers.empty())
+		{
+			job();
+			return;
+		}
+
+		if (counter)
+		{
+			counter->Pending.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		// Count the job before it becomes visible so a fast thief can never take QueuedJobs below zero
+		{
+			std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->QueuedJobs.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		size_t queue_index = s_WorkerIndex >= 0 ? (size_t)s_WorkerIndex : s_Data->Queues.size() - 1;
+		{
+			WorkerQueue& queue = *s_Data->Queues[queue_index];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.emplace_back(std::move(job), counter);
+		}
+		s_Data->WakeCondition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		while (counter.Pending.load(std::memory_order_acquire) > 0)
+		{
+			if (!RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::RunPendingJob()
+	{
+		if (!s_Data)
+		{
+			return false;
+		}
+
+		std::pair<Job, JobCounter*> job;
+		if (!PopJob(job))
+		{
+			return false;
+		}
+		ExecuteJob(job);
+		return true;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <algorithm>
+#include <functional>
+
+namespace Engine {
+
+	// Number of jobs of one batch that have not finished yet, see JobSystem::Wait
+	struct JobCounter
+	{
+		std::atomic<uint32_t> Pending{ 0 };
+	};
+
+	// Work stealing thread pool. Every worker owns a queue it pops from the back, idle workers steal
+	// from the front of the others. Threads that wait on a counter run queued jobs instead of blocking,
+	// so nested ParallelFor calls from inside a job cannot deadlock the pool.
+	class JobSystem
+	{
+	public:
+		using Job = std::function<void()>;
+
+		// thread_count 0 uses one worker per hardware thread minus the main thread
+		static void Init(uint32_t thread_count = 0);
+		static void Shutdown();
+
+		static uint32_t GetWorkerCount();
+
+		// Runs the job inline if the pool has not been started
+		static void Submit(Job job, JobCounter* counter = nullptr);
+		static void Wait(JobCounter& counter);
+
+		// Pops one queued job and runs it on the calling thread, returns false if every queue was empty
+		static bool RunPendingJob();
+
+		// Splits [0, count) into chunks of at least grain_size and returns when all of them ran.
+		// func(begin, end) is called concurrently and must only touch data owned by its range.
+		template<typename Func>
+		static void ParallelFor(size_t count, size_t grain_size, Func&& func)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			size_t chunk_size = std::max<size_t>(grain_size, count / ((size_t)GetWorkerCount() * 4 + 1) + 1);
+			if (GetWorkerCount() == 0 || chunk_size >= count)
+			{
+				func((size_t)0, count);
+				return;
+			}
+
+			JobCounter counter;
+			for (size_t begin = 0; begin < count; begin += chunk_size)
+			{
+				size_t end = std::min(begin + chunk_size, count);
+				Submit([&func, begin, end]() { func(begin, end); }, &counter);
+			}
+			Wait(counter);
+		}
+	};
+}
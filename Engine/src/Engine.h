@@ -11,6 +11,7 @@
 #include "Core/Profiler.h"
 #include "Core/Timer.h"
 #include "Core/IO.h"
+#include "Core/JobSystem.h"
 
 
 // ------------- Assets ------------------
@@ -34,6 +35,7 @@
 #include "Scene/Scene.h"
 #include "Scene/Entity.h"
 #include "Scene/Components.h"
+#include "Scene/Prefab.h"
 
 // ---------------- UI -------------------
 #include "UI/FilePicker.h"
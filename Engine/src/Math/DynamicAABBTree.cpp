@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "DynamicAABBTree.h"
+
+namespace Engine::Math {
+
+	DynamicAABBTree::DynamicAABBTree(float margin, float displacement_multiplier)
+		: m_Margin(margin), m_DisplacementMultiplier(displacement_multiplier)
+	{
+	}
+
+	int32_t DynamicAABBTree::CreateProxy(const BoundingBox& bounds, uint64_t user_data)
+	{
+		int32_t proxy = AllocateNode();
+		Node& node = m_Nodes[proxy];
+		node.Bounds = { bounds.Min - glm::vec3(m_Margin), bounds.Max + glm::vec3(m_Margin) };
+		node.UserData = user_data;
+		node.Height = 0;
+
+		InsertLeaf(proxy);
+		m_ProxyCount++;
+		return proxy;
+	}
+
+	void DynamicAABBTree::DestroyProxy(int32_t proxy)
+	{
+		HVE_CORE_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf());
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_ProxyCount--;
+	}
+
+	bool DynamicAABBTree::MoveProxy(int32_t proxy, const BoundingBox& bounds, const glm::vec3& displacement)
+	{
+		HVE_CORE_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf());
+
+		// Extend the fat box in the direction of travel, the proxy is likely to keep moving that way
+		BoundingBox fat = { bounds.Min - glm::vec3(m_Margin), bounds.Max + glm::vec3(m_Margin) };
+		glm::vec3 extension = displacement * m_DisplacementMultiplier;
+		fat.Min += glm::min(extension, glm::vec3(0.0f));
+		fat.Max += glm::max(extension, glm::vec3(0.0f));
+
+		const BoundingBox& current = m_Nodes[proxy].Bounds;
+		if (current.Contains(bounds))
+		{
+			// Still inside, unless the fat box has grown far larger than it needs to be after the proxy slowed down
+			BoundingBox huge = { fat.Min - glm::vec3(4.0f * m_Margin), fat.Max + glm::vec3(4.0f * m_Margin) };
+			if (huge.Contains(current))
+			{
+				return false;
+			}
+		}
+
+		RemoveLeaf(proxy);
+		m_Nodes[proxy].Bounds = fat;
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAABBTree::Clear()
+	{
+		m_Nodes.clear();
+		m_Root = Null;
+		m_FreeList = Null;
+		m_ProxyCount = 0;
+	}
+
+	int32_t DynamicAABBTree::AllocateNode()
+	{
+		if (m_FreeList == Null)
+		{
+			m_Nodes.emplace_back();
+			return (int32_t)m_Nodes.size() - 1;
+		}
+
+		int32_t index = m_FreeList;
+		m_FreeList = m_Nodes[index].Parent;
+		m_Nodes[index] = Node();
+		return index;
+	}
+
+	void DynamicAABBTree::FreeNode(int32_t index)
+	{
+		m_Nodes[index] = Node();
+		m_Nodes[index].Parent = m_FreeList;
+		m_FreeList = index;
+	}
+
+	void DynamicAABBTree::InsertLeaf(int32_t leaf)
+	{
+		if (m_Root == Null)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = Null;
+			return;
+		}
+
+		// Walk down to the sibling that adds the least surface area. Every node passed on the way grows by the same
+		// amount whichever branch is taken, that is the inherited cost.
+		const BoundingBox leaf_bounds = m_Nodes[leaf].Bounds;
+		int32_t index = m_Root;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node& node = m_Nodes[index];
+			float area = node.Bounds.GetSurfaceArea();
+			float combined_area = BoundingBox::Union(node.Bounds, leaf_bounds).GetSurfaceArea();
+
+			// Cost of making a new parent for this node and the leaf
+			float cost = 2.0f * combined_area;
+			float inheritance_cost = 2.0f * (combined_area - area);
+
+			auto descend_cost = [&](int32_t child)
+			{
+				const Node& child_node = m_Nodes[child];
+				float new_area = BoundingBox::Union(child_node.Bounds, leaf_bounds).GetSurfaceArea();
+				return child_node.IsLeaf() ? new_area + inheritance_cost : new_area - child_node.Bounds.GetSurfaceArea() + inheritance_cost;
+			};
+			float cost1 = descend_cost(node.Child1);
+			float cost2 = descend_cost(node.Child2);
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		int32_t sibling = index;
+		int32_t old_parent = m_Nodes[sibling].Parent;
+		int32_t new_parent = AllocateNode();
+
+		Node& parent_node = m_Nodes[new_parent];
+		parent_node.Parent = old_parent;
+		parent_node.Bounds = BoundingBox::Union(leaf_bounds, m_Nodes[sibling].Bounds);
+		parent_node.Height = m_Nodes[sibling].Height + 1;
+		parent_node.Child1 = sibling;
+		parent_node.Child2 = leaf;
+		m_Nodes[sibling].Parent = new_parent;
+		m_Nodes[leaf].Parent = new_parent;
+
+		if (old_parent == Null)
+		{
+			m_Root = new_parent;
+		}
+		else if (m_Nodes[old_parent].Child1 == sibling)
+		{
+			m_Nodes[old_parent].Child1 = new_parent;
+		}
+		else
+		{
+			m_Nodes[old_parent].Child2 = new_parent;
+		}
+
+		Refit(m_Nodes[leaf].Parent);
+	}
+
+	void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = Null;
+			return;
+		}
+
+		int32_t parent = m_Nodes[leaf].Parent;
+		int32_t grand_parent = m_Nodes[parent].Parent;
+		int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+		// The sibling takes the parent's place
+		m_Nodes[sibling].Parent = grand_parent;
+		FreeNode(parent);
+
+		if (grand_parent == Null)
+		{
+			m_Root = sibling;
+			return;
+		}
+
+		if (m_Nodes[grand_parent].Child1 == parent)
+		{
+			m_Nodes[grand_parent].Child1 = sibling;
+		}
+		else
+		{
+			m_Nodes[grand_parent].Child2 = sibling;
+		}
+		Refit(grand_parent);
+	}
+
+	void DynamicAABBTree::Refit(int32_t index)
+	{
+		while (index != Null)
+		{
+			index = Balance(index);
+
+			Node& node = m_Nodes[index];
+			const Node& child1 = m_Nodes[node.Child1];
+			const Node& child2 = m_Nodes[node.Child2];
+			node.Height = 1 + std::max(child1.Height, child2.Height);
+			node.Bounds = BoundingBox::Union(child1.Bounds, child2.Bounds);
+
+			index = node.Parent;
+		}
+	}
+
+	int32_t DynamicAABBTree::Balance(int32_t index_a)
+	{
+		Node& a = m_Nodes[index_a];
+		if (a.IsLeaf() || a.Height < 2)
+		{
+			return index_a;
+		}
+
+		int32_t index_b = a.Child1;
+		int32_t index_c = a.Child2;
+		Node& b = m_Nodes[index_b];
+		Node& c = m_Nodes[index_c];
+
+		// Lifts the taller child up into a's place, a keeps the other child and the lower of the grandchildren
+		auto rotate_up = [this, index_a, &a](int32_t index_up, Node& up, Node& kept, bool up_is_child1)
+		{
+			int32_t index_f = up.Child1;
+			int32_t index_g = up.Child2;
+			Node& f = m_Nodes[index_f];
+			Node& g = m_Nodes[index_g];
+
+			up.Child1 = index_a;
+			up.Parent = a.Parent;
+			a.Parent = index_up;
+
+			if (up.Parent == Null)
+			{
+				m_Root = index_up;
+			}
+			else if (m_Nodes[up.Parent].Child1 == index_a)
+			{
+				m_Nodes[up.Parent].Child1 = index_up;
+			}
+			else
+			{
+				m_Nodes[up.Parent].Child2 = index_up;
+			}
+
+			// The taller grandchild stays with the lifted node
+			bool keep_f = f.Height > g.Height;
+			int32_t index_moved = keep_f ? index_g : index_f;
+			Node& stays = keep_f ? f : g;
+			Node& moved = keep_f ? g : f;
+
+			up.Child2 = keep_f ? index_f : index_g;
+			if (up_is_child1)
+			{
+				a.Child1 = index_moved;
+			}
+			else
+			{
+				a.Child2 = index_moved;
+			}
+			moved.Parent = index_a;
+
+			a.Bounds = BoundingBox::Union(kept.Bounds, moved.Bounds);
+			a.Height = 1 + std::max(kept.Height, moved.Height);
+			up.Bounds = BoundingBox::Union(a.Bounds, stays.Bounds);
+			up.Height = 1 + std::max(a.Height, stays.Height);
+		};
+
+		int32_t balance = c.Height - b.Height;
+		if (balance > 1)
+		{
+			rotate_up(index_c, c, b, false);
+			return index_c;
+		}
+		if (balance < -1)
+		{
+			rotate_up(index_b, b, c, true);
+			return index_b;
+		}
+		return index_a;
+	}
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <vector>
+#include "Math.h"
+
+namespace Engine::Math {
+
+	// Bounding volume hierarchy over boxes that move, after Box2D's b2DynamicTree. Leaves store a fattened copy of
+	// their box, so small movements cost nothing and only a box that leaves its fat bounds is reinserted. Insertion
+	// picks the sibling by surface area and tree rotations keep it balanced, so queries stay O(log n).
+	//
+	// Query callbacks return false to stop the traversal early.
+	class DynamicAABBTree
+	{
+	public:
+		static constexpr int32_t Null = -1;
+
+		// margin is added around every box, moving boxes are extended further along their displacement
+		explicit DynamicAABBTree(float margin = 0.1f, float displacement_multiplier = 4.0f);
+
+		int32_t CreateProxy(const BoundingBox& bounds, uint64_t user_data);
+		void DestroyProxy(int32_t proxy);
+		// Returns true when the proxy had to be reinserted, false when its fat bounds still hold the new box
+		bool MoveProxy(int32_t proxy, const BoundingBox& bounds, const glm::vec3& displacement);
+		void Clear();
+
+		uint64_t GetUserData(int32_t proxy) const { return m_Nodes[proxy].UserData; }
+		const BoundingBox& GetFatBounds(int32_t proxy) const { return m_Nodes[proxy].Bounds; }
+		uint32_t GetProxyCount() const { return m_ProxyCount; }
+		int32_t GetHeight() const { return m_Root == Null ? 0 : m_Nodes[m_Root].Height; }
+
+		// func(int32_t proxy) for every fat box that overlaps bounds
+		template<typename Func>
+		void Query(const BoundingBox& bounds, Func&& func) const
+		{
+			Traverse([&bounds](const BoundingBox& node_bounds) { return node_bounds.Intersects(bounds); }, func);
+		}
+
+		template<typename Func>
+		void QuerySphere(const glm::vec3& center, float radius, Func&& func) const
+		{
+			Traverse([&center, radius](const BoundingBox& node_bounds) { return node_bounds.IntersectsSphere(center, radius); }, func);
+		}
+
+		// Subtrees entirely inside the frustum are reported without testing their leaves
+		template<typename Func>
+		void QueryFrustum(const Frustum& frustum, Func&& func) const
+		{
+			if (m_Root == Null)
+			{
+				return;
+			}
+
+			TraversalStack stack;
+			stack.Push(m_Root, false);
+			while (!stack.Empty())
+			{
+				auto [index, inside] = stack.Pop();
+				const Node& node = m_Nodes[index];
+				if (!inside)
+				{
+					if (!frustum.IntersectsAABB(node.Bounds))
+					{
+						continue;
+					}
+					inside = !node.IsLeaf() && frustum.ContainsAABB(node.Bounds);
+				}
+
+				if (node.IsLeaf())
+				{
+					if (!func(index))
+					{
+						return;
+					}
+					continue;
+				}
+				stack.Push(node.Child1, inside);
+				stack.Push(node.Child2, inside);
+			}
+		}
+
+		// func(int32_t proxy, float t) gets the distance at which the ray enters the proxy's fat box and returns the new
+		// maximum distance. Return max_distance to keep going, t to only look for closer boxes, or a negative value to stop.
+		template<typename Func>
+		void RayCast(const Ray& ray, float max_distance, Func&& func) const
+		{
+			if (m_Root == Null)
+			{
+				return;
+			}
+
+			TraversalStack stack;
+			stack.Push(m_Root, false);
+			while (!stack.Empty())
+			{
+				int32_t index = stack.Pop().Index;
+				const Node& node = m_Nodes[index];
+
+				float t;
+				if (!ray.IntersectsAABB(node.Bounds, t) || t > max_distance)
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					max_distance = func(index, t);
+					if (max_distance < 0.0f)
+					{
+						return;
+					}
+					continue;
+				}
+				stack.Push(node.Child1, false);
+				stack.Push(node.Child2, false);
+			}
+		}
+
+	private:
+		struct Node
+		{
+			BoundingBox Bounds;
+			uint64_t UserData = 0;
+			// Doubles as the next link of the free list
+			int32_t Parent = Null;
+			int32_t Child1 = Null;
+			int32_t Child2 = Null;
+			// Leaves are 0, free nodes -1
+			int32_t Height = -1;
+
+			bool IsLeaf() const { return Child1 == Null; }
+		};
+
+		// Depth first traversal without allocating for any tree of sensible height
+		class TraversalStack
+		{
+		public:
+			struct Entry
+			{
+				int32_t Index;
+				bool Flag;
+			};
+
+			void Push(int32_t index, bool flag)
+			{
+				if (m_Size < InlineCapacity)
+				{
+					m_Inline[m_Size] = { index, flag };
+				}
+				else
+				{
+					m_Overflow.push_back({ index, flag });
+				}
+				m_Size++;
+			}
+
+			Entry Pop()
+			{
+				m_Size--;
+				if (m_Size < InlineCapacity)
+				{
+					return m_Inline[m_Size];
+				}
+				Entry entry = m_Overflow.back();
+				m_Overflow.pop_back();
+				return entry;
+			}
+
+			bool Empty() const { return m_Size == 0; }
+
+		private:
+			static constexpr size_t InlineCapacity = 64;
+			Entry m_Inline[InlineCapacity];
+			std::vector<Entry> m_Overflow;
+			size_t m_Size = 0;
+		};
+
+		template<typename Overlaps, typename Func>
+		void Traverse(Overlaps&& overlaps, Func& func) const
+		{
+			if (m_Root == Null)
+			{
+				return;
+			}
+
+			TraversalStack stack;
+			stack.Push(m_Root, false);
+			while (!stack.Empty())
+			{
+				int32_t index = stack.Pop().Index;
+				const Node& node = m_Nodes[index];
+				if (!overlaps(node.Bounds))
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					if (!func(index))
+					{
+						return;
+					}
+					continue;
+				}
+				stack.Push(node.Child1, false);
+				stack.Push(node.Child2, false);
+			}
+		}
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t index);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		// Rotates the subtree at index if its children differ in height by more than one, returns the new subtree root
+		int32_t Balance(int32_t index);
+		// Refits bounds and heights from index up to the root, balancing on the way
+		void Refit(int32_t index);
+
+	private:
+		std::vector<Node> m_Nodes;
+		int32_t m_Root = Null;
+		int32_t m_FreeList = Null;
+		uint32_t m_ProxyCount = 0;
+
+		float m_Margin;
+		float m_DisplacementMultiplier;
+	};
+}
@@ -1,11 +1,80 @@
 #include "pch.h"
 #include "Math.h"
+#include "SIMD.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/matrix_decompose.hpp>
 
 namespace Engine::Math {
 
+	void BoundingBox::TransformBy(const glm::mat4& matrix)
+	{
+		TransformBoundingBoxes(this, &matrix, this, 1);
+	}
+
+	Frustum Frustum::FromMatrix(const glm::mat4& view_projection)
+	{
+		// Gribb and Hartmann, every plane is the last row of the matrix plus or minus one of the others
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++)
+		{
+			rows[i] = { view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] };
+		}
+
+		Frustum frustum;
+		frustum.Planes[0] = rows[3] + rows[0];
+		frustum.Planes[1] = rows[3] - rows[0];
+		frustum.Planes[2] = rows[3] + rows[1];
+		frustum.Planes[3] = rows[3] - rows[1];
+		frustum.Planes[4] = rows[3] + rows[2];
+		frustum.Planes[5] = rows[3] - rows[2];
+
+		for (auto& plane : frustum.Planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return frustum;
+	}
+
+	bool Frustum::IntersectsAABB(const BoundingBox& box) const
+	{
+		for (const auto& plane : Planes)
+		{
+			// The corner furthest along the normal, if even that one is behind the plane the box is outside
+			glm::vec3 positive = glm::mix(box.Min, box.Max, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::ContainsAABB(const BoundingBox& box) const
+	{
+		for (const auto& plane : Planes)
+		{
+			glm::vec3 negative = glm::mix(box.Max, box.Min, glm::greaterThanEqual(glm::vec3(plane), glm::vec3(0.0f)));
+			if (glm::dot(glm::vec3(plane), negative) + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (const auto& plane : Planes)
+		{
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
 	bool DecomposeTransform(const glm::mat4& transform, glm::vec3& translation, glm::vec3& rotation, glm::vec3& scale)
 	{
 		// From glm::decompose in matrix_decompose.inl
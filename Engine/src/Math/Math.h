@@ -21,27 +21,55 @@ namespace Engine::Math {
 			ExpandBy(other.Max);
 		}
 
-		void TransformBy(const glm::mat4& matrix)
+		// Bounds of the box after the matrix, see TransformBoundingBoxes in SIMD.h
+		void TransformBy(const glm::mat4& matrix);
+
+		// Default constructed boxes are empty until something is added
+		bool IsEmpty() const { return Min.x > Max.x || Min.y > Max.y || Min.z > Max.z; }
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+		float GetSurfaceArea() const
 		{
-			std::vector<glm::vec3> points = {
-				{ Min.x, Min.y, Min.z },
-				{ Max.x, Min.y, Min.z },
-				{ Min.x, Max.y, Min.z },
-				{ Max.x, Max.y, Min.z },
-				{ Min.x, Min.y, Max.z },
-				{ Max.x, Min.y, Max.z },
-				{ Min.x, Max.y, Max.z },
-				{ Max.x, Max.y, Max.z }
-			};
-			Min = glm::vec3(FLT_MAX);
-			Max = glm::vec3(-FLT_MAX);
-
-			for (const auto& point : points)
-			{
-				glm::vec4 transformedPoint = matrix * glm::vec4(point, 1.0f);
-				ExpandBy(glm::vec3(transformedPoint));
-			}
+			glm::vec3 size = Max - Min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
 		}
+
+		bool Contains(const BoundingBox& other) const
+		{
+			return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+		}
+
+		bool Intersects(const BoundingBox& other) const
+		{
+			return glm::all(glm::lessThanEqual(Min, other.Max)) && glm::all(glm::greaterThanEqual(Max, other.Min));
+		}
+
+		bool IntersectsSphere(const glm::vec3& center, float radius) const
+		{
+			glm::vec3 closest = glm::clamp(center, Min, Max);
+			glm::vec3 offset = closest - center;
+			return glm::dot(offset, offset) <= radius * radius;
+		}
+
+		static BoundingBox Union(const BoundingBox& a, const BoundingBox& b)
+		{
+			return { glm::min(a.Min, b.Min), glm::max(a.Max, b.Max) };
+		}
+	};
+
+	// Six planes with their normals facing inwards
+	struct Frustum
+	{
+		glm::vec4 Planes[6];
+
+		// Works on the clip space of OpenGL, z from -w to w
+		static Frustum FromMatrix(const glm::mat4& view_projection);
+
+		// Conservative, a box just outside a corner of the frustum can still be reported as intersecting
+		bool IntersectsAABB(const BoundingBox& box) const;
+		bool ContainsAABB(const BoundingBox& box) const;
+		bool IntersectsSphere(const glm::vec3& center, float radius) const;
 	};
 
 	struct Ray
@@ -0,0 +1,594 @@
+#include "pch.h"
+#include "SIMD.h"
+
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define HVE_SIMD_X86 1
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		// MSVC emits any intrinsic regardless of /arch, GCC and Clang need the target enabled per function
+		#define HVE_TARGET_AVX2
+	#else
+		#include <cpuid.h>
+		#define HVE_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#else
+	#define HVE_SIMD_X86 0
+#endif
+
+namespace Engine::Math {
+
+	static_assert(sizeof(BoundingBox) == 6 * sizeof(float) && offsetof(BoundingBox, Max) == 3 * sizeof(float),
+		"The bounds kernels load Min and Max as one run of six floats");
+
+	namespace {
+
+		using ComposeTransformsFn = void(*)(const glm::vec3*, const glm::quat*, const glm::vec3*, glm::mat4*, size_t);
+		using MultiplyTransformsFn = void(*)(const glm::mat4*, const glm::mat4*, glm::mat4*, size_t);
+		using TransformBoundingBoxesFn = void(*)(const BoundingBox*, const glm::mat4*, BoundingBox*, size_t);
+		using IntersectRayAABBsFn = size_t(*)(const Ray&, const BoundingBoxSoA&, float*);
+
+		struct Kernels
+		{
+			SIMDLevel Level;
+			ComposeTransformsFn ComposeTransforms;
+			MultiplyTransformsFn MultiplyTransforms;
+			TransformBoundingBoxesFn TransformBoundingBoxes;
+			IntersectRayAABBsFn IntersectRayAABBs;
+		};
+
+		// Scalar kernels, the reference every other path has to match bit for bit
+
+		// Same expressions as glm::mat3_cast, then scaled per column
+		void ComposeTransformScalar(const glm::vec3& t, const glm::quat& q, const glm::vec3& s, glm::mat4& out)
+		{
+			float qxx = q.x * q.x, qyy = q.y * q.y, qzz = q.z * q.z;
+			float qxz = q.x * q.z, qxy = q.x * q.y, qyz = q.y * q.z;
+			float qwx = q.w * q.x, qwy = q.w * q.y, qwz = q.w * q.z;
+
+			out[0] = glm::vec4((1.0f - 2.0f * (qyy + qzz)) * s.x, (2.0f * (qxy + qwz)) * s.x, (2.0f * (qxz - qwy)) * s.x, 0.0f);
+			out[1] = glm::vec4((2.0f * (qxy - qwz)) * s.y, (1.0f - 2.0f * (qxx + qzz)) * s.y, (2.0f * (qyz + qwx)) * s.y, 0.0f);
+			out[2] = glm::vec4((2.0f * (qxz + qwy)) * s.z, (2.0f * (qyz - qwx)) * s.z, (1.0f - 2.0f * (qxx + qyy)) * s.z, 0.0f);
+			out[3] = glm::vec4(t, 1.0f);
+		}
+
+		void ComposeTransformsScalar(const glm::vec3* translations, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				ComposeTransformScalar(translations[i], rotations[i], scales[i], out[i]);
+			}
+		}
+
+		// Summed left to right like glm's operator*
+		void MultiplyTransformsScalar(const glm::mat4* parents, const glm::mat4* locals, glm::mat4* out, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const glm::mat4 a = parents[i];
+				const glm::mat4 b = locals[i];
+				for (int c = 0; c < 4; c++)
+				{
+					out[i][c] = a[0] * b[c][0] + a[1] * b[c][1] + a[2] * b[c][2] + a[3] * b[c][3];
+				}
+			}
+		}
+
+		bool IsEmpty(const BoundingBox& box)
+		{
+			return box.Min.x > box.Max.x || box.Min.y > box.Max.y || box.Min.z > box.Max.z;
+		}
+
+		// Arvo's method, transform the center and project the half extents onto the absolute axes
+		void TransformBoundingBoxesScalar(const BoundingBox* boxes, const glm::mat4* matrices, BoundingBox* out, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const BoundingBox& box = boxes[i];
+				if (IsEmpty(box))
+				{
+					out[i] = BoundingBox();
+					continue;
+				}
+
+				const glm::mat4& m = matrices[i];
+				glm::vec3 center = (box.Min + box.Max) * 0.5f;
+				glm::vec3 extent = (box.Max - box.Min) * 0.5f;
+
+				glm::vec3 new_center = glm::vec3(m[0]) * center.x + glm::vec3(m[1]) * center.y + glm::vec3(m[2]) * center.z + glm::vec3(m[3]);
+				glm::vec3 new_extent = glm::abs(glm::vec3(m[0])) * extent.x + glm::abs(glm::vec3(m[1])) * extent.y + glm::abs(glm::vec3(m[2])) * extent.z;
+
+				out[i].Min = new_center - new_extent;
+				out[i].Max = new_center + new_extent;
+			}
+		}
+
+		size_t IntersectRayAABBsScalarRange(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t, size_t begin)
+		{
+			size_t hits = 0;
+			for (size_t i = begin; i < boxes.Size(); i++)
+			{
+				BoundingBox box;
+				box.Min = { boxes.MinX[i], boxes.MinY[i], boxes.MinZ[i] };
+				box.Max = { boxes.MaxX[i], boxes.MaxY[i], boxes.MaxZ[i] };
+
+				float t;
+				if (ray.IntersectsAABB(box, t))
+				{
+					out_t[i] = t;
+					hits++;
+				}
+				else
+				{
+					out_t[i] = FLT_MAX;
+				}
+			}
+			return hits;
+		}
+
+		size_t IntersectRayAABBsScalar(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t)
+		{
+			return IntersectRayAABBsScalarRange(ray, boxes, out_t, 0);
+		}
+
+#if HVE_SIMD_X86
+
+		// SSE2, part of every x86-64 CPU so it needs no detection
+
+		void ComposeTransformsSSE(const glm::vec3* translations, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+		{
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 two = _mm_set1_ps(2.0f);
+
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const glm::quat* q = rotations + i;
+				const glm::vec3* s = scales + i;
+				const glm::vec3* t = translations + i;
+
+				// Read by name so the kernel does not care whether glm stores w first or last
+				__m128 qx = _mm_setr_ps(q[0].x, q[1].x, q[2].x, q[3].x);
+				__m128 qy = _mm_setr_ps(q[0].y, q[1].y, q[2].y, q[3].y);
+				__m128 qz = _mm_setr_ps(q[0].z, q[1].z, q[2].z, q[3].z);
+				__m128 qw = _mm_setr_ps(q[0].w, q[1].w, q[2].w, q[3].w);
+				__m128 sx = _mm_setr_ps(s[0].x, s[1].x, s[2].x, s[3].x);
+				__m128 sy = _mm_setr_ps(s[0].y, s[1].y, s[2].y, s[3].y);
+				__m128 sz = _mm_setr_ps(s[0].z, s[1].z, s[2].z, s[3].z);
+
+				__m128 qxx = _mm_mul_ps(qx, qx), qyy = _mm_mul_ps(qy, qy), qzz = _mm_mul_ps(qz, qz);
+				__m128 qxz = _mm_mul_ps(qx, qz), qxy = _mm_mul_ps(qx, qy), qyz = _mm_mul_ps(qy, qz);
+				__m128 qwx = _mm_mul_ps(qw, qx), qwy = _mm_mul_ps(qw, qy), qwz = _mm_mul_ps(qw, qz);
+
+				__m128 columns[4][4];
+				columns[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qyy, qzz))), sx);
+				columns[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qxy, qwz)), sx);
+				columns[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qxz, qwy)), sx);
+				columns[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qxy, qwz)), sy);
+				columns[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qzz))), sy);
+				columns[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qyz, qwx)), sy);
+				columns[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qxz, qwy)), sz);
+				columns[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qyz, qwx)), sz);
+				columns[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qyy))), sz);
+				columns[0][3] = columns[1][3] = columns[2][3] = _mm_setzero_ps();
+				columns[3][0] = _mm_setr_ps(t[0].x, t[1].x, t[2].x, t[3].x);
+				columns[3][1] = _mm_setr_ps(t[0].y, t[1].y, t[2].y, t[3].y);
+				columns[3][2] = _mm_setr_ps(t[0].z, t[1].z, t[2].z, t[3].z);
+				columns[3][3] = one;
+
+				// Back from one register per element to one register per column of each matrix
+				for (int c = 0; c < 4; c++)
+				{
+					__m128 r0 = columns[c][0], r1 = columns[c][1], r2 = columns[c][2], r3 = columns[c][3];
+					_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+					_mm_storeu_ps(&out[i + 0][c][0], r0);
+					_mm_storeu_ps(&out[i + 1][c][0], r1);
+					_mm_storeu_ps(&out[i + 2][c][0], r2);
+					_mm_storeu_ps(&out[i + 3][c][0], r3);
+				}
+			}
+
+			ComposeTransformsScalar(translations + i, rotations + i, scales + i, out + i, count - i);
+		}
+
+		void MultiplyTransformsSSE(const glm::mat4* parents, const glm::mat4* locals, glm::mat4* out, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const float* a = &parents[i][0][0];
+				const float* b = &locals[i][0][0];
+				__m128 a0 = _mm_loadu_ps(a + 0);
+				__m128 a1 = _mm_loadu_ps(a + 4);
+				__m128 a2 = _mm_loadu_ps(a + 8);
+				__m128 a3 = _mm_loadu_ps(a + 12);
+
+				// Everything is loaded before the first store, so out may be one of the inputs
+				__m128 result[4];
+				for (int c = 0; c < 4; c++)
+				{
+					__m128 column = _mm_loadu_ps(b + c * 4);
+					__m128 sum = _mm_mul_ps(a0, _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)));
+					sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1))));
+					sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2))));
+					sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3))));
+					result[c] = sum;
+				}
+
+				float* o = &out[i][0][0];
+				for (int c = 0; c < 4; c++)
+				{
+					_mm_storeu_ps(o + c * 4, result[c]);
+				}
+			}
+		}
+
+		// Min as lanes 0-2 of the first six floats and Max moved down into lanes 0-2, neither load reads past the box
+		inline void LoadBoundingBox(const BoundingBox& box, __m128& min, __m128& max)
+		{
+			min = _mm_loadu_ps(&box.Min.x);
+			__m128 high = _mm_loadu_ps(&box.Min.z);
+			max = _mm_shuffle_ps(high, high, _MM_SHUFFLE(3, 3, 2, 1));
+		}
+
+		inline void StoreBoundingBox(BoundingBox& box, __m128 min, __m128 max)
+		{
+			// The first store spills into Max.x, which the second one then overwrites
+			_mm_storeu_ps(&box.Min.x, min);
+			__m128 low = _mm_shuffle_ps(min, max, _MM_SHUFFLE(0, 0, 2, 2));
+			_mm_storeu_ps(&box.Min.z, _mm_shuffle_ps(low, max, _MM_SHUFFLE(2, 1, 2, 0)));
+		}
+
+		inline __m128 Abs(__m128 value)
+		{
+			return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+		}
+
+		void TransformBoundingBoxesSSE(const BoundingBox* boxes, const glm::mat4* matrices, BoundingBox* out, size_t count)
+		{
+			const __m128 half = _mm_set1_ps(0.5f);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				__m128 min, max;
+				LoadBoundingBox(boxes[i], min, max);
+				if ((_mm_movemask_ps(_mm_cmpgt_ps(min, max)) & 0x7) != 0)
+				{
+					out[i] = BoundingBox();
+					continue;
+				}
+
+				const float* m = &matrices[i][0][0];
+				__m128 m0 = _mm_loadu_ps(m + 0);
+				__m128 m1 = _mm_loadu_ps(m + 4);
+				__m128 m2 = _mm_loadu_ps(m + 8);
+				__m128 m3 = _mm_loadu_ps(m + 12);
+
+				__m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+				__m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+				__m128 new_center = _mm_mul_ps(m0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0)));
+				new_center = _mm_add_ps(new_center, _mm_mul_ps(m1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1))));
+				new_center = _mm_add_ps(new_center, _mm_mul_ps(m2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))));
+				new_center = _mm_add_ps(new_center, m3);
+
+				__m128 new_extent = _mm_mul_ps(Abs(m0), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0)));
+				new_extent = _mm_add_ps(new_extent, _mm_mul_ps(Abs(m1), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1))));
+				new_extent = _mm_add_ps(new_extent, _mm_mul_ps(Abs(m2), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2))));
+
+				StoreBoundingBox(out[i], _mm_sub_ps(new_center, new_extent), _mm_add_ps(new_center, new_extent));
+			}
+		}
+
+		size_t IntersectRayAABBsSSERange(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t, size_t begin)
+		{
+			const __m128 ox = _mm_set1_ps(ray.Origin.x), oy = _mm_set1_ps(ray.Origin.y), oz = _mm_set1_ps(ray.Origin.z);
+			const __m128 dx = _mm_set1_ps(1.0f / ray.Direction.x), dy = _mm_set1_ps(1.0f / ray.Direction.y), dz = _mm_set1_ps(1.0f / ray.Direction.z);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 miss_value = _mm_set1_ps(FLT_MAX);
+
+			size_t hits = 0;
+			size_t i = begin;
+			for (; i + 4 <= boxes.Size(); i += 4)
+			{
+				__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.MinX[i]), ox), dx);
+				__m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.MaxX[i]), ox), dx);
+				__m128 t3 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.MinY[i]), oy), dy);
+				__m128 t4 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.MaxY[i]), oy), dy);
+				__m128 t5 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.MinZ[i]), oz), dz);
+				__m128 t6 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&boxes.MaxZ[i]), oz), dz);
+
+				// glm::min(a, b) is _mm_min_ps(b, a) and likewise for max, including which operand wins on NaN
+				__m128 tmin = _mm_max_ps(_mm_min_ps(t6, t5), _mm_max_ps(_mm_min_ps(t4, t3), _mm_min_ps(t2, t1)));
+				__m128 tmax = _mm_min_ps(_mm_max_ps(t6, t5), _mm_min_ps(_mm_max_ps(t4, t3), _mm_max_ps(t2, t1)));
+
+				__m128 miss = _mm_or_ps(_mm_cmplt_ps(tmax, zero), _mm_cmpgt_ps(tmin, tmax));
+				_mm_storeu_ps(out_t + i, _mm_or_ps(_mm_and_ps(miss, miss_value), _mm_andnot_ps(miss, tmin)));
+				hits += 4 - std::popcount(static_cast<uint32_t>(_mm_movemask_ps(miss)));
+			}
+
+			return hits + IntersectRayAABBsScalarRange(ray, boxes, out_t, i);
+		}
+
+		size_t IntersectRayAABBsSSE(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t)
+		{
+			return IntersectRayAABBsSSERange(ray, boxes, out_t, 0);
+		}
+
+		// AVX2, eight transforms or rays at a time and two matrix columns per register
+
+		HVE_TARGET_AVX2 inline __m256 Combine(__m128 low, __m128 high)
+		{
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+		}
+
+		HVE_TARGET_AVX2 void ComposeTransformsAVX2(const glm::vec3* translations, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+		{
+			const __m256 one = _mm256_set1_ps(1.0f);
+			const __m256 two = _mm256_set1_ps(2.0f);
+			// Element strides in floats, quaternions are four apart and vectors three
+			const __m256i quat_index = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+			const __m256i vec3_index = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+			static_assert(sizeof(glm::quat) == 4 * sizeof(float) && sizeof(glm::vec3) == 3 * sizeof(float));
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const glm::quat* q = rotations + i;
+				const glm::vec3* s = scales + i;
+				const glm::vec3* t = translations + i;
+
+				__m256 qx = _mm256_i32gather_ps(&q->x, quat_index, 4);
+				__m256 qy = _mm256_i32gather_ps(&q->y, quat_index, 4);
+				__m256 qz = _mm256_i32gather_ps(&q->z, quat_index, 4);
+				__m256 qw = _mm256_i32gather_ps(&q->w, quat_index, 4);
+				__m256 sx = _mm256_i32gather_ps(&s->x, vec3_index, 4);
+				__m256 sy = _mm256_i32gather_ps(&s->y, vec3_index, 4);
+				__m256 sz = _mm256_i32gather_ps(&s->z, vec3_index, 4);
+
+				__m256 qxx = _mm256_mul_ps(qx, qx), qyy = _mm256_mul_ps(qy, qy), qzz = _mm256_mul_ps(qz, qz);
+				__m256 qxz = _mm256_mul_ps(qx, qz), qxy = _mm256_mul_ps(qx, qy), qyz = _mm256_mul_ps(qy, qz);
+				__m256 qwx = _mm256_mul_ps(qw, qx), qwy = _mm256_mul_ps(qw, qy), qwz = _mm256_mul_ps(qw, qz);
+
+				__m256 columns[4][4];
+				columns[0][0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qyy, qzz))), sx);
+				columns[0][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(qxy, qwz)), sx);
+				columns[0][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(qxz, qwy)), sx);
+				columns[1][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(qxy, qwz)), sy);
+				columns[1][1] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qxx, qzz))), sy);
+				columns[1][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(qyz, qwx)), sy);
+				columns[2][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(qxz, qwy)), sz);
+				columns[2][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(qyz, qwx)), sz);
+				columns[2][2] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qxx, qyy))), sz);
+				columns[0][3] = columns[1][3] = columns[2][3] = _mm256_setzero_ps();
+				columns[3][0] = _mm256_i32gather_ps(&t->x, vec3_index, 4);
+				columns[3][1] = _mm256_i32gather_ps(&t->y, vec3_index, 4);
+				columns[3][2] = _mm256_i32gather_ps(&t->z, vec3_index, 4);
+				columns[3][3] = one;
+
+				// The transpose works within each 128 bit half, so the low half holds matrices 0-3 and the high half 4-7
+				for (int c = 0; c < 4; c++)
+				{
+					__m256 t0 = _mm256_unpacklo_ps(columns[c][0], columns[c][1]);
+					__m256 t1 = _mm256_unpackhi_ps(columns[c][0], columns[c][1]);
+					__m256 t2 = _mm256_unpacklo_ps(columns[c][2], columns[c][3]);
+					__m256 t3 = _mm256_unpackhi_ps(columns[c][2], columns[c][3]);
+					__m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+					__m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+					__m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+					__m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+					_mm_storeu_ps(&out[i + 0][c][0], _mm256_castps256_ps128(r0));
+					_mm_storeu_ps(&out[i + 1][c][0], _mm256_castps256_ps128(r1));
+					_mm_storeu_ps(&out[i + 2][c][0], _mm256_castps256_ps128(r2));
+					_mm_storeu_ps(&out[i + 3][c][0], _mm256_castps256_ps128(r3));
+					_mm_storeu_ps(&out[i + 4][c][0], _mm256_extractf128_ps(r0, 1));
+					_mm_storeu_ps(&out[i + 5][c][0], _mm256_extractf128_ps(r1, 1));
+					_mm_storeu_ps(&out[i + 6][c][0], _mm256_extractf128_ps(r2, 1));
+					_mm_storeu_ps(&out[i + 7][c][0], _mm256_extractf128_ps(r3, 1));
+				}
+			}
+
+			ComposeTransformsSSE(translations + i, rotations + i, scales + i, out + i, count - i);
+		}
+
+		HVE_TARGET_AVX2 void MultiplyTransformsAVX2(const glm::mat4* parents, const glm::mat4* locals, glm::mat4* out, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				const float* a = &parents[i][0][0];
+				const float* b = &locals[i][0][0];
+				__m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+				__m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+				__m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+				__m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+
+				// Columns 0 and 1 in the first register, 2 and 3 in the second
+				__m256 b01 = _mm256_loadu_ps(b + 0);
+				__m256 b23 = _mm256_loadu_ps(b + 8);
+
+				__m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+				r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1))));
+				r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2))));
+				r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3))));
+
+				__m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)));
+				r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1))));
+				r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2))));
+				r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3))));
+
+				float* o = &out[i][0][0];
+				_mm256_storeu_ps(o + 0, r01);
+				_mm256_storeu_ps(o + 8, r23);
+			}
+		}
+
+		HVE_TARGET_AVX2 void TransformBoundingBoxesAVX2(const BoundingBox* boxes, const glm::mat4* matrices, BoundingBox* out, size_t count)
+		{
+			const __m256 half = _mm256_set1_ps(0.5f);
+			const __m256 sign = _mm256_set1_ps(-0.0f);
+
+			// Two boxes per iteration, one in each half
+			size_t i = 0;
+			for (; i + 2 <= count; i += 2)
+			{
+				__m128 min_a, max_a, min_b, max_b;
+				LoadBoundingBox(boxes[i], min_a, max_a);
+				LoadBoundingBox(boxes[i + 1], min_b, max_b);
+				if (((_mm_movemask_ps(_mm_cmpgt_ps(min_a, max_a)) | _mm_movemask_ps(_mm_cmpgt_ps(min_b, max_b))) & 0x7) != 0)
+				{
+					// Rare enough to not be worth a masked path
+					TransformBoundingBoxesSSE(boxes + i, matrices + i, out + i, 2);
+					continue;
+				}
+
+				const float* ma = &matrices[i][0][0];
+				const float* mb = &matrices[i + 1][0][0];
+				__m256 m0 = Combine(_mm_loadu_ps(ma + 0), _mm_loadu_ps(mb + 0));
+				__m256 m1 = Combine(_mm_loadu_ps(ma + 4), _mm_loadu_ps(mb + 4));
+				__m256 m2 = Combine(_mm_loadu_ps(ma + 8), _mm_loadu_ps(mb + 8));
+				__m256 m3 = Combine(_mm_loadu_ps(ma + 12), _mm_loadu_ps(mb + 12));
+
+				__m256 min = Combine(min_a, min_b);
+				__m256 max = Combine(max_a, max_b);
+				__m256 center = _mm256_mul_ps(_mm256_add_ps(min, max), half);
+				__m256 extent = _mm256_mul_ps(_mm256_sub_ps(max, min), half);
+
+				__m256 new_center = _mm256_mul_ps(m0, _mm256_permute_ps(center, _MM_SHUFFLE(0, 0, 0, 0)));
+				new_center = _mm256_add_ps(new_center, _mm256_mul_ps(m1, _mm256_permute_ps(center, _MM_SHUFFLE(1, 1, 1, 1))));
+				new_center = _mm256_add_ps(new_center, _mm256_mul_ps(m2, _mm256_permute_ps(center, _MM_SHUFFLE(2, 2, 2, 2))));
+				new_center = _mm256_add_ps(new_center, m3);
+
+				__m256 new_extent = _mm256_mul_ps(_mm256_andnot_ps(sign, m0), _mm256_permute_ps(extent, _MM_SHUFFLE(0, 0, 0, 0)));
+				new_extent = _mm256_add_ps(new_extent, _mm256_mul_ps(_mm256_andnot_ps(sign, m1), _mm256_permute_ps(extent, _MM_SHUFFLE(1, 1, 1, 1))));
+				new_extent = _mm256_add_ps(new_extent, _mm256_mul_ps(_mm256_andnot_ps(sign, m2), _mm256_permute_ps(extent, _MM_SHUFFLE(2, 2, 2, 2))));
+
+				__m256 new_min = _mm256_sub_ps(new_center, new_extent);
+				__m256 new_max = _mm256_add_ps(new_center, new_extent);
+				StoreBoundingBox(out[i], _mm256_castps256_ps128(new_min), _mm256_castps256_ps128(new_max));
+				StoreBoundingBox(out[i + 1], _mm256_extractf128_ps(new_min, 1), _mm256_extractf128_ps(new_max, 1));
+			}
+
+			TransformBoundingBoxesSSE(boxes + i, matrices + i, out + i, count - i);
+		}
+
+		HVE_TARGET_AVX2 size_t IntersectRayAABBsAVX2(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t)
+		{
+			const __m256 ox = _mm256_set1_ps(ray.Origin.x), oy = _mm256_set1_ps(ray.Origin.y), oz = _mm256_set1_ps(ray.Origin.z);
+			const __m256 dx = _mm256_set1_ps(1.0f / ray.Direction.x), dy = _mm256_set1_ps(1.0f / ray.Direction.y), dz = _mm256_set1_ps(1.0f / ray.Direction.z);
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 miss_value = _mm256_set1_ps(FLT_MAX);
+
+			size_t hits = 0;
+			size_t i = 0;
+			for (; i + 8 <= boxes.Size(); i += 8)
+			{
+				__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.MinX[i]), ox), dx);
+				__m256 t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.MaxX[i]), ox), dx);
+				__m256 t3 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.MinY[i]), oy), dy);
+				__m256 t4 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.MaxY[i]), oy), dy);
+				__m256 t5 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.MinZ[i]), oz), dz);
+				__m256 t6 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&boxes.MaxZ[i]), oz), dz);
+
+				__m256 tmin = _mm256_max_ps(_mm256_min_ps(t6, t5), _mm256_max_ps(_mm256_min_ps(t4, t3), _mm256_min_ps(t2, t1)));
+				__m256 tmax = _mm256_min_ps(_mm256_max_ps(t6, t5), _mm256_min_ps(_mm256_max_ps(t4, t3), _mm256_max_ps(t2, t1)));
+
+				__m256 miss = _mm256_or_ps(_mm256_cmp_ps(tmax, zero, _CMP_LT_OQ), _mm256_cmp_ps(tmin, tmax, _CMP_GT_OQ));
+				_mm256_storeu_ps(out_t + i, _mm256_blendv_ps(tmin, miss_value, miss));
+				hits += 8 - std::popcount(static_cast<uint32_t>(_mm256_movemask_ps(miss)));
+			}
+
+			return hits + IntersectRayAABBsSSERange(ray, boxes, out_t, i);
+		}
+
+		bool HasAVX2()
+		{
+			// AVX2 needs the CPU flag and an OS that saves the upper halves of the ymm registers
+			int leaf1[4], leaf7[4];
+#ifdef _MSC_VER
+			__cpuid(leaf1, 1);
+			__cpuidex(leaf7, 7, 0);
+#else
+			__cpuid_count(1, 0, leaf1[0], leaf1[1], leaf1[2], leaf1[3]);
+			if (__get_cpuid_max(0, nullptr) < 7)
+			{
+				return false;
+			}
+			__cpuid_count(7, 0, leaf7[0], leaf7[1], leaf7[2], leaf7[3]);
+#endif
+			bool osxsave = (leaf1[2] & (1 << 27)) != 0;
+			bool avx = (leaf1[2] & (1 << 28)) != 0;
+			bool avx2 = (leaf7[1] & (1 << 5)) != 0;
+			if (!osxsave || !avx || !avx2)
+			{
+				return false;
+			}
+#ifdef _MSC_VER
+			unsigned long long xcr0 = _xgetbv(0);
+#else
+			uint32_t eax, edx;
+			__asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			unsigned long long xcr0 = (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+			return (xcr0 & 0x6) == 0x6;
+		}
+
+#endif
+
+		Kernels SelectKernels()
+		{
+#if HVE_SIMD_X86
+			if (HasAVX2())
+			{
+				return { SIMDLevel::AVX2, ComposeTransformsAVX2, MultiplyTransformsAVX2, TransformBoundingBoxesAVX2, IntersectRayAABBsAVX2 };
+			}
+			return { SIMDLevel::SSE2, ComposeTransformsSSE, MultiplyTransformsSSE, TransformBoundingBoxesSSE, IntersectRayAABBsSSE };
+#else
+			return { SIMDLevel::Scalar, ComposeTransformsScalar, MultiplyTransformsScalar, TransformBoundingBoxesScalar, IntersectRayAABBsScalar };
+#endif
+		}
+
+		const Kernels& GetKernels()
+		{
+			static const Kernels kernels = SelectKernels();
+			return kernels;
+		}
+	}
+
+	SIMDLevel GetSIMDLevel()
+	{
+		return GetKernels().Level;
+	}
+
+	const char* SIMDLevelToString(SIMDLevel level)
+	{
+		switch (level)
+		{
+		case SIMDLevel::Scalar: return "Scalar";
+		case SIMDLevel::SSE2: return "SSE2";
+		case SIMDLevel::AVX2: return "AVX2";
+		}
+		return "Unknown";
+	}
+
+	void ComposeTransforms(const glm::vec3* translations, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count)
+	{
+		GetKernels().ComposeTransforms(translations, rotations, scales, out, count);
+	}
+
+	void MultiplyTransforms(const glm::mat4* parents, const glm::mat4* locals, glm::mat4* out, size_t count)
+	{
+		GetKernels().MultiplyTransforms(parents, locals, out, count);
+	}
+
+	void TransformBoundingBoxes(const BoundingBox* boxes, const glm::mat4* matrices, BoundingBox* out, size_t count)
+	{
+		GetKernels().TransformBoundingBoxes(boxes, matrices, out, count);
+	}
+
+	size_t IntersectRayAABBs(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t)
+	{
+		return GetKernels().IntersectRayAABBs(ray, boxes, out_t);
+	}
+}
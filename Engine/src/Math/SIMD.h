@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "Math.h"
+
+namespace Engine::Math {
+
+	enum class SIMDLevel
+	{
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+	// Detected once on first use, every kernel below dispatches on it
+	SIMDLevel GetSIMDLevel();
+	const char* SIMDLevelToString(SIMDLevel level);
+
+	// Boxes stored as one array per coordinate, so a single ray can be tested against 4 or 8 of them at once
+	struct BoundingBoxSoA
+	{
+		std::vector<float> MinX, MinY, MinZ;
+		std::vector<float> MaxX, MaxY, MaxZ;
+
+		void Add(const BoundingBox& box)
+		{
+			MinX.push_back(box.Min.x); MinY.push_back(box.Min.y); MinZ.push_back(box.Min.z);
+			MaxX.push_back(box.Max.x); MaxY.push_back(box.Max.y); MaxZ.push_back(box.Max.z);
+		}
+
+		void Clear()
+		{
+			MinX.clear(); MinY.clear(); MinZ.clear();
+			MaxX.clear(); MaxY.clear(); MaxZ.clear();
+		}
+
+		void Reserve(size_t count)
+		{
+			MinX.reserve(count); MinY.reserve(count); MinZ.reserve(count);
+			MaxX.reserve(count); MaxY.reserve(count); MaxZ.reserve(count);
+		}
+
+		size_t Size() const { return MinX.size(); }
+	};
+
+	// Batched kernels. Every array holds count elements. Each kernel uses the same operations in the same order on
+	// every path, without fused multiply adds, so the result does not depend on the CPU it runs on.
+
+	// out[i] = translate(translations[i]) * mat4(rotations[i]) * scale(scales[i])
+	void ComposeTransforms(const glm::vec3* translations, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* out, size_t count);
+	// out[i] = parents[i] * locals[i], out may alias either input
+	void MultiplyTransforms(const glm::mat4* parents, const glm::mat4* locals, glm::mat4* out, size_t count);
+	// Axis aligned bounds of each box after its matrix, without going through the 8 corners. Empty boxes stay empty.
+	void TransformBoundingBoxes(const BoundingBox* boxes, const glm::mat4* matrices, BoundingBox* out, size_t count);
+	// Writes the entry distance of every box the ray hits to out_t and FLT_MAX for the others, returns the hit count.
+	// Same rules as Ray::IntersectsAABB, a ray starting inside a box hits it with a negative distance.
+	size_t IntersectRayAABBs(const Ray& ray, const BoundingBoxSoA& boxes, float* out_t);
+
+	inline glm::mat4 ComposeTransform(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		glm::mat4 result;
+		ComposeTransforms(&translation, &rotation, &scale, &result, 1);
+		return result;
+	}
+
+	inline glm::mat4 MultiplyTransform(const glm::mat4& parent, const glm::mat4& local)
+	{
+		glm::mat4 result;
+		MultiplyTransforms(&parent, &local, &result, 1);
+		return result;
+	}
+}
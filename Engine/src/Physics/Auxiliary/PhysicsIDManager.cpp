@@ -3,10 +3,14 @@
 
 namespace Engine {
 
-	HBodyID::HBodyID(UUID entity_id, JPH::BodyID value)
+	HBodyID::HBodyID(EntityId entity_id, JPH::BodyID value)
 	{
 		mID = entity_id;
-		s_idMap[entity_id] = value;
+		if (entity_id.Index >= s_idMap.size())
+		{
+			s_idMap.resize(entity_id.Index + 1);
+		}
+		s_idMap[entity_id.Index] = { entity_id.Generation, value };
 	}
 
 	/*UUID HBodyID::InsertNewID(JPH::BodyID value)
@@ -19,14 +23,18 @@ namespace Engine {
 		return sID++;
 	}*/
 
-	JPH::BodyID HBodyID::GetBodyID(UUID id)
+	JPH::BodyID HBodyID::GetBodyID(EntityId id)
 	{
-		return s_idMap[id];
+		if (!HasEntry(id))
+		{
+			return JPH::BodyID();
+		}
+		return s_idMap[id.Index].Body;
 	}
 
 	JPH::BodyID HBodyID::GetBodyID()
 	{
-		return s_idMap[this->mID];
+		return GetBodyID(this->mID);
 	}
 
 	void HBodyID::EmptyMap()
@@ -34,14 +42,19 @@ namespace Engine {
 		s_idMap.clear();
 	}
 
-	void HBodyID::RemoveEntry(UUID entity_id)
+	void HBodyID::RemoveEntry(EntityId entity_id)
 	{
-		s_idMap.erase(entity_id);
+		if (HasEntry(entity_id))
+		{
+			s_idMap[entity_id.Index].Body = JPH::BodyID();
+		}
 	}
 
-	std::unordered_map<UUID, JPH::BodyID>& HBodyID::GetMap()
+	bool HBodyID::HasEntry(EntityId entity_id)
 	{
-		return s_idMap;
+		return entity_id.Index < s_idMap.size()
+			&& s_idMap[entity_id.Index].Generation == entity_id.Generation
+			&& !s_idMap[entity_id.Index].Body.IsInvalid();
 	}
 
 	
@@ -5,28 +5,35 @@
 
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 
-
+#include "Scene/EntityId.h"
 
 namespace Engine {
 	class HBodyID
 	{
 		public:
-			HBodyID(UUID entity_id, JPH::BodyID value);
+			HBodyID(EntityId entity_id, JPH::BodyID value);
 			// static UUID InsertNewID(JPH::BodyID value);
-			static JPH::BodyID GetBodyID(UUID id);
+			static JPH::BodyID GetBodyID(EntityId id);
 			JPH::BodyID GetBodyID();
 
 			static void EmptyMap();
 
-			static void RemoveEntry(UUID entity_id);
+			static void RemoveEntry(EntityId entity_id);
 
-			static std::unordered_map<UUID, JPH::BodyID>& GetMap();
+			static bool HasEntry(EntityId entity_id);
 
 
 		private:
-			UUID mID;
+			struct BodySlot
+			{
+				uint32_t Generation = 0;
+				JPH::BodyID Body{};
+			};
+
+			EntityId mID;
 
-			static inline std::unordered_map<UUID, JPH::BodyID> s_idMap = std::unordered_map<UUID, JPH::BodyID>();
+			// Indexed by EntityId::Index, an invalid JPH::BodyID marks an empty slot
+			static inline std::vector<BodySlot> s_idMap = std::vector<BodySlot>();
 
 	};
 
@@ -53,4 +60,3 @@ namespace Engine {
 	};
 
 }
-
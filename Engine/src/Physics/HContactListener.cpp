@@ -21,7 +21,7 @@ namespace Engine {
 		std::uint64_t data1 = (std::uint64_t)inBody1.GetUserData();
 		std::uint64_t data2 = (std::uint64_t)inBody2.GetUserData();
 
-		this->m_CurrentScene->AddNewContact(data1, data2);
+		this->m_CurrentScene->AddNewContact(EntityId::Unpack(data1), EntityId::Unpack(data2));
 
 		if (typeid(inBody1.GetShape()) == typeid(JPH::CapsuleShape))
 			HVE_CORE_TRACE("A contact was added");
@@ -45,8 +45,8 @@ namespace Engine {
 			return;
 		}
 
-		UUID data1 = body1->GetUserData();
-		UUID data2 = body2->GetUserData();
+		EntityId data1 = EntityId::Unpack(body1->GetUserData());
+		EntityId data2 = EntityId::Unpack(body2->GetUserData());
 
 		this->m_CurrentScene->AddRemoveContact(data1, data2);
 		HVE_CORE_TRACE("A contact was removed");
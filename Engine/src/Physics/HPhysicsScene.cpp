@@ -11,6 +11,26 @@ namespace Engine {
 	static ObjectVsBroadPhaseLayerFilterImpl s_object_vs_broadphase_layer_filter;
 	static ObjectLayerPairFilterImpl s_object_vs_object_layer_filter;
 
+	template<typename T>
+	static T* FindSlot(std::vector<std::pair<EntityId, T*>>& slots, EntityId entity_id)
+	{
+		if (entity_id.Index < slots.size() && slots[entity_id.Index].first == entity_id)
+		{
+			return slots[entity_id.Index].second;
+		}
+		return nullptr;
+	}
+
+	template<typename T>
+	static void SetSlot(std::vector<std::pair<EntityId, T*>>& slots, EntityId entity_id, T* value)
+	{
+		if (entity_id.Index >= slots.size())
+		{
+			slots.resize(entity_id.Index + 1, { EntityId(), nullptr });
+		}
+		slots[entity_id.Index] = { entity_id, value };
+	}
+
 	HPhysicsScene::HPhysicsScene(Scene* scene, JPH::TempAllocator* temporariesAllocator = nullptr, JPH::JobSystemThreadPool* jobThreadPool = nullptr) : m_scene(scene)
 	{
 		if (s_temporariesAllocator == nullptr || s_jobThreadPool == nullptr)
@@ -74,106 +94,107 @@ namespace Engine {
 		);
 
 
-		// post simulation
+		// post simulation, destroyed entities have already been cleaned up by OnEntitiesDestroyed
 		for (auto& [entity_id, character] : m_characterMap)
 		{
-			if (m_scene->GetEntity(entity_id)) 
+			if (character)
 			{
-				character->PostSimulation(0.01f);        // TODO: check if this works on removed but undeleted characters
-			}
-			else {
-				DestroyCharacter(entity_id);
+				character->PostSimulation(0.01f);
 			}
 		}
 
 		for (auto& [id1, id2] : this->m_newContact)
 		{
-			ScriptEngine::CallMethod<uint64_t>(id1, "OnNewCollision", id2);
-			ScriptEngine::CallMethod<uint64_t>(id2, "OnNewCollision", id1);
+			ScriptEngine::CallMethod<uint64_t>(id1, "OnNewCollision", id2.Pack());
+			ScriptEngine::CallMethod<uint64_t>(id2, "OnNewCollision", id1.Pack());
 		}
 
 		for (auto& [id1, id2] : this->m_persistContact)
 		{
-			ScriptEngine::CallMethod<uint64_t>(id1, "OnPersistCollision", id2);
-			ScriptEngine::CallMethod<uint64_t>(id2, "OnPersistCollision", id1);
+			ScriptEngine::CallMethod<uint64_t>(id1, "OnPersistCollision", id2.Pack());
+			ScriptEngine::CallMethod<uint64_t>(id2, "OnPersistCollision", id1.Pack());
 		}
 
 		for (auto& [id1, id2] : this->m_removedContact)
 		{
-			ScriptEngine::CallMethod<uint64_t>(id1, "OnRemovedCollision", id2);
-			ScriptEngine::CallMethod<uint64_t>(id2, "OnRemovedCollision", id1);
+			ScriptEngine::CallMethod<uint64_t>(id1, "OnRemovedCollision", id2.Pack());
+			ScriptEngine::CallMethod<uint64_t>(id2, "OnRemovedCollision", id1.Pack());
 		}
+	}
 
-		std::vector<UUID> entities_to_destroy;
-
-		for (auto& [entity_id, body] : m_bodyMap) {
-			if (!m_scene->GetEntity(entity_id))
+	void HPhysicsScene::OnEntitiesDestroyed(std::span<const EntityId> entity_ids)
+	{
+		for (EntityId entity_id : entity_ids)
+		{
+			if (FindSlot(m_characterMap, entity_id))
+			{
+				DestroyCharacter(entity_id);
+			}
+			if (FindSlot(m_bodyMap, entity_id))
 			{
 				RemoveShape(entity_id);
-				entities_to_destroy.push_back(entity_id);
+				DestroyShape(entity_id);
 			}
 		}
-
-		for (auto entity : entities_to_destroy) {
-			DestroyShape(entity);
-		}
 	}
 
-	std::vector<HBodyID> HPhysicsScene::CreateBody(Entity* entity)
+	std::vector<HBodyID> HPhysicsScene::CreateBody(Entity entity)
 	{
 		std::vector<HBodyID> res;
+		// Entities marked static in the editor always get static bodies, whatever their collider says
+		bool is_static = entity.HasComponent<TransformComponent>() && entity.GetComponent<TransformComponent>()->IsStatic();
 
-		BoxColliderComponent* boxComponent = entity->GetComponent<BoxColliderComponent>();
+		BoxColliderComponent* boxComponent = entity.GetComponent<BoxColliderComponent>();
 		if (boxComponent)
 		{
-			glm::vec3 position = entity->GetComponent<TransformComponent>()->world_transform.translation;
-			glm::quat rotation = entity->GetComponent<TransformComponent>()->world_transform.RotationVecToQuat();
-			glm::vec3 scale = entity->GetComponent<TransformComponent>()->world_transform.scale;
+			glm::vec3 position = entity.GetComponent<TransformComponent>()->world_transform.translation;
+			glm::quat rotation = entity.GetComponent<TransformComponent>()->world_transform.rotation;
+			glm::vec3 scale = entity.GetComponent<TransformComponent>()->world_transform.scale;
 
 			glm::vec3 dimensions = glm::vec3(boxComponent->HalfSize.x * scale.x, boxComponent->HalfSize.y * scale.y, boxComponent->HalfSize.z * scale.z);
 
 			res.push_back(this->CreateBox(
-				entity->GetID(),
+				entity.GetID(),
 				boxComponent->Mass,
 				dimensions,
 				rotation,
 				position,
-				boxComponent->MotionType,
+				is_static ? HEMotionType::Static : boxComponent->MotionType,
 				boxComponent->Offset,
 				true,
 				boxComponent->Friction,
 				boxComponent->Restitution
 			));
 		}
-		SphereColliderComponent* sphereComponent = entity->GetComponent<SphereColliderComponent>();
+		SphereColliderComponent* sphereComponent = entity.GetComponent<SphereColliderComponent>();
 		if (sphereComponent)
 		{
-			glm::vec3 position = entity->GetComponent<TransformComponent>()->world_transform.translation;
-			glm::quat rotation = entity->GetComponent<TransformComponent>()->world_transform.RotationVecToQuat();
-			glm::vec3 scale = entity->GetComponent<TransformComponent>()->world_transform.scale;
+			glm::vec3 position = entity.GetComponent<TransformComponent>()->world_transform.translation;
+			glm::quat rotation = entity.GetComponent<TransformComponent>()->world_transform.rotation;
+			glm::vec3 scale = entity.GetComponent<TransformComponent>()->world_transform.scale;
 			float biggest_scale = std::max(scale.z, std::max(scale.x, scale.y));
 			res.push_back(this->CreateSphere(
-				entity->GetID(),
+				entity.GetID(),
 				sphereComponent->Mass,
 				biggest_scale * sphereComponent->Radius,
 				position,
 				rotation,
-				sphereComponent->MotionType,
+				is_static ? HEMotionType::Static : sphereComponent->MotionType,
 				sphereComponent->Offset,
 				true,
 				sphereComponent->Friction,
 				sphereComponent->Restitution
 			));
 		}
-		CharacterControllerComponent* characterComponent = entity->GetComponent <CharacterControllerComponent>();
+		CharacterControllerComponent* characterComponent = entity.GetComponent <CharacterControllerComponent>();
 		if (characterComponent)
 		{
-			glm::vec3 position = entity->GetComponent<TransformComponent>()->world_transform.translation;
-			glm::quat rotation = entity->GetComponent<TransformComponent>()->world_transform.RotationVecToQuat();
-			glm::vec3 scale = entity->GetComponent<TransformComponent>()->world_transform.scale;
+			glm::vec3 position = entity.GetComponent<TransformComponent>()->world_transform.translation;
+			glm::quat rotation = entity.GetComponent<TransformComponent>()->world_transform.rotation;
+			glm::vec3 scale = entity.GetComponent<TransformComponent>()->world_transform.scale;
 			float biggest_scale = std::max(scale.z, std::max(scale.x, scale.y));
 			res.push_back(this->CreateCharacter(
-				entity->GetID(),
+				entity.GetID(),
 				characterComponent->Mass,
 				scale.y * characterComponent->HalfHeight,
 				biggest_scale * characterComponent->Radius,
@@ -187,7 +208,7 @@ namespace Engine {
 		return res;
 	}
 
-	HBodyID HPhysicsScene::CreateBox(UUID entity_id, float mass, glm::vec3 dimensions, glm::quat rotation, glm::vec3 position, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution)
+	HBodyID HPhysicsScene::CreateBox(EntityId entity_id, float mass, glm::vec3 dimensions, glm::quat rotation, glm::vec3 position, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution)
 	{
 		HVE_ASSERT(friction >= 0.f && restitution >= 0.f && mass >= 0.f);
 		HVE_ASSERT(dimensions.x >= 0.f && dimensions.y >= 0.f && dimensions.z >= 0.f);
@@ -229,7 +250,7 @@ namespace Engine {
 		box_settings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
 
 		JPH::Body* box_body = (this->m_body_interface)->CreateBody(box_settings);
-		box_body->SetUserData(entity_id);
+		box_body->SetUserData(entity_id.Pack());
 		box_body->SetFriction(friction);
 		box_body->SetRestitution(restitution);
 		// Add it to the world
@@ -248,12 +269,12 @@ namespace Engine {
 
 		//this->m_numberOfBodies++;
 		this->s_hasOptimized = false;
-		this->m_bodyMap[entity_id] = box_body;
+		SetSlot(this->m_bodyMap, entity_id, box_body);
 
 		return HBodyID(entity_id, box_body->GetID());
 	}
 
-	HBodyID HPhysicsScene::CreateSphere(UUID entity_id, float mass, float radius, glm::vec3 position, glm::quat rotation, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution)
+	HBodyID HPhysicsScene::CreateSphere(EntityId entity_id, float mass, float radius, glm::vec3 position, glm::quat rotation, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution)
 	{
 		HVE_ASSERT(friction >= 0.f && restitution >= 0.f && mass >= 0.f && radius >= 0.f);
 
@@ -286,7 +307,7 @@ namespace Engine {
 		sphere_settings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
 
 		JPH::Body* sphere_body = (this->m_body_interface)->CreateBody(sphere_settings);
-		sphere_body->SetUserData(entity_id);
+		sphere_body->SetUserData(entity_id.Pack());
 		sphere_body->SetFriction(friction);
 		sphere_body->SetRestitution(restitution);
 		if (activate)
@@ -304,12 +325,12 @@ namespace Engine {
 
 		//this->m_numberOfBodies++;
 		this->s_hasOptimized = false;
-		this->m_bodyMap[entity_id] = sphere_body;
+		SetSlot(this->m_bodyMap, entity_id, sphere_body);
 
 		return HBodyID(entity_id, sphere_body->GetID());
 	}
 
-	HBodyID HPhysicsScene::CreateCharacter(UUID entity_id, float mass, float halfHeight, float radius, glm::vec3 position, glm::quat rotation, glm::vec3 offset, float friction, float restitution)
+	HBodyID HPhysicsScene::CreateCharacter(EntityId entity_id, float mass, float halfHeight, float radius, glm::vec3 position, glm::quat rotation, glm::vec3 offset, float friction, float restitution)
 	{
 		//HVE_ASSERT(friction >= 0.f && restitution >= 0.f && mass >= 0.f && halfHeight >= 0.f && radius Destroy>= 0.f);
 
@@ -325,7 +346,7 @@ namespace Engine {
 		
 		JPH::RotatedTranslatedShapeSettings capsuleTransSettings(jolt_offset, JPH::Quat::sIdentity(), capsuleResult.Get());
 		JPH::Shape* capsule = capsuleTransSettings.Create().Get();
-		capsule->SetUserData(entity_id);
+		capsule->SetUserData(entity_id.Pack());
 		
 		character_settings->mShape = capsule;
 		character_settings->mMass = mass;
@@ -333,7 +354,7 @@ namespace Engine {
 			character_settings.get(),
 			HPhysicsScene::makeRVec3(position),
 			rot,
-			entity_id,
+			entity_id.Pack(),
 			this->m_physics_system.get()
 		);
 		
@@ -343,13 +364,13 @@ namespace Engine {
 
 		delete capShapeSettings;
 
-		m_characterMap[entity_id] = character;
+		SetSlot(m_characterMap, entity_id, character);
 		this->m_body_interface->SetFriction(character->GetBodyID(), friction);
 		this->m_body_interface->SetRestitution(character->GetBodyID(), restitution);
 		return HBodyID(entity_id, character->GetBodyID());
 	}
 
-	void HPhysicsScene::InsertObjectByID(UUID entity_id, bool activate)
+	void HPhysicsScene::InsertObjectByID(EntityId entity_id, bool activate)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		if (activate)
@@ -362,7 +383,7 @@ namespace Engine {
 		}
 	}
 
-	void HPhysicsScene::SetPosition(UUID entity_id, glm::vec3 position, bool activate)
+	void HPhysicsScene::SetPosition(EntityId entity_id, glm::vec3 position, bool activate)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 
@@ -377,7 +398,7 @@ namespace Engine {
 		}
 	}
 
-	void HPhysicsScene::SetLinearVelocity(UUID entity_id, glm::vec3& velocity)
+	void HPhysicsScene::SetLinearVelocity(EntityId entity_id, glm::vec3& velocity)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 vel = HPhysicsScene::makeVec3(velocity);
@@ -385,7 +406,7 @@ namespace Engine {
 		(this->m_body_interface)->SetLinearVelocity(jolt_id, vel);
 	}
 
-	void HPhysicsScene::SetAngularVelocity(UUID entity_id, glm::vec3& velocity)
+	void HPhysicsScene::SetAngularVelocity(EntityId entity_id, glm::vec3& velocity)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 vel = HPhysicsScene::makeVec3(velocity);
@@ -393,7 +414,7 @@ namespace Engine {
 		(this->m_body_interface)->SetAngularVelocity(jolt_id, vel);
 	}
 
-	void HPhysicsScene::SetLinearAndAngularVelocity(UUID entity_id, glm::vec3& linaerVelocity, glm::vec3& angularVelocity)
+	void HPhysicsScene::SetLinearAndAngularVelocity(EntityId entity_id, glm::vec3& linaerVelocity, glm::vec3& angularVelocity)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 lVel = HPhysicsScene::makeVec3(linaerVelocity);
@@ -402,7 +423,7 @@ namespace Engine {
 		(this->m_body_interface)->SetLinearAndAngularVelocity(jolt_id, lVel, aVel);
 	}
 
-	void HPhysicsScene::AddLinearVelocity(UUID entity_id, glm::vec3& velocity)
+	void HPhysicsScene::AddLinearVelocity(EntityId entity_id, glm::vec3& velocity)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 vel = HPhysicsScene::makeVec3(velocity);
@@ -410,7 +431,7 @@ namespace Engine {
 		(this->m_body_interface)->AddLinearVelocity(jolt_id, vel);
 	}
 
-	void HPhysicsScene::AddLinearImpulse(UUID entity_id, glm::vec3& impulse)
+	void HPhysicsScene::AddLinearImpulse(EntityId entity_id, glm::vec3& impulse)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 imp = HPhysicsScene::makeVec3(impulse);
@@ -418,7 +439,7 @@ namespace Engine {
 		(this->m_body_interface)->AddImpulse(jolt_id, imp);
 	}
 
-	void HPhysicsScene::AddAngularImpulse(UUID entity_id, glm::vec3& impulse)
+	void HPhysicsScene::AddAngularImpulse(EntityId entity_id, glm::vec3& impulse)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 imp = HPhysicsScene::makeVec3(impulse);
@@ -426,7 +447,7 @@ namespace Engine {
 		(this->m_body_interface)->AddAngularImpulse(jolt_id, imp);
 	}
 
-	void HPhysicsScene::AddLinearAndAngularImpulse(UUID entity_id, glm::vec3& linear, glm::vec3& angular)
+	void HPhysicsScene::AddLinearAndAngularImpulse(EntityId entity_id, glm::vec3& linear, glm::vec3& angular)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 		JPH::Vec3 linear_imp = HPhysicsScene::makeVec3(linear);
@@ -436,22 +457,22 @@ namespace Engine {
 		(this->m_body_interface)->AddAngularImpulse(jolt_id, angular_imp);
 	}
 
-	glm::vec3 HPhysicsScene::GetRotation(UUID entity_id)
+	glm::vec3 HPhysicsScene::GetRotation(EntityId entity_id)
 	{
-		JPH::Quat jph_quat = m_characterMap[entity_id]->GetRotation();
+		JPH::Quat jph_quat = FindSlot(m_characterMap, entity_id)->GetRotation();
 		JPH::Vec3 jph_euler = jph_quat.GetEulerAngles();
 		glm::vec3 rotation_vec = glm::vec3(jph_euler.GetX(), jph_euler.GetY(), jph_euler.GetZ());
 		return rotation_vec;
 	}
 
-	void HPhysicsScene::SetRotation(UUID entity_id, glm::vec3& rotation)
+	void HPhysicsScene::SetRotation(EntityId entity_id, glm::vec3& rotation)
 	{
 		glm::quat quat_rot = glm::quat(rotation);
 		JPH::Quat jph_quat = JPH::Quat(quat_rot.x, quat_rot.y, quat_rot.z, quat_rot.w);
-		m_characterMap[entity_id]->SetRotation(jph_quat);
+		FindSlot(m_characterMap, entity_id)->SetRotation(jph_quat);
 	}
 
-	void HPhysicsScene::Rotate(UUID entity_id, glm::vec3& delta)
+	void HPhysicsScene::Rotate(EntityId entity_id, glm::vec3& delta)
 	{
 		glm::vec3 curr_rot = GetRotation(entity_id);
 		curr_rot += delta;
@@ -473,72 +494,70 @@ namespace Engine {
 		this->m_physics_system->OptimizeBroadPhase();
 	}
 
-	void HPhysicsScene::RemoveShape(UUID entity_id)
+	void HPhysicsScene::RemoveShape(EntityId entity_id)
 	{
 		JPH::BodyID h_id = HBodyID::GetBodyID(entity_id);
 		(this->m_body_interface)->RemoveBody(h_id);
 	}
 
-	void HPhysicsScene::DestroyShape(UUID entity_id)
+	void HPhysicsScene::DestroyShape(EntityId entity_id)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 
 		(this->m_body_interface)->DeactivateBody(jolt_id);
 		(this->m_body_interface)->DestroyBody(jolt_id);
 		HBodyID::RemoveEntry(entity_id);
-		m_bodyMap.erase(entity_id);
+		SetSlot<JPH::Body>(m_bodyMap, entity_id, nullptr);
 	}
 
 	void HPhysicsScene::DestroyAllShapes()
 	{
-		std::vector<UUID> toKill = std::vector<UUID>();
 		for (auto& [entity_id, body] : m_bodyMap)
 		{
+			if (!body)
+			{
+				continue;
+			}
 			(this->m_body_interface)->RemoveBody(body->GetID());
 			(this->m_body_interface)->DestroyBody(body->GetID());
 			HBodyID::RemoveEntry(entity_id);
-			toKill.push_back(entity_id);
-		}
-		for (auto& entity_id : toKill)
-		{
-			m_bodyMap.erase(entity_id);
 		}
+		m_bodyMap.clear();
 		//HBodyID::EmptyMap();
 	}
 
-	void HPhysicsScene::RemoveCharacter(UUID entity_id)
+	void HPhysicsScene::RemoveCharacter(EntityId entity_id)
 	{
-		m_characterMap[entity_id]->RemoveFromPhysicsSystem();
+		FindSlot(m_characterMap, entity_id)->RemoveFromPhysicsSystem();
 	}
 
-	void HPhysicsScene::DestroyCharacter(UUID entity_id)
+	void HPhysicsScene::DestroyCharacter(EntityId entity_id)
 	{
 		this->RemoveCharacter(entity_id);
-		delete m_characterMap[entity_id];
-		m_characterMap.erase(entity_id);
+		delete FindSlot(m_characterMap, entity_id);
+		SetSlot<JPH::Character>(m_characterMap, entity_id, nullptr);
 		HBodyID::RemoveEntry(entity_id);
 	}
 
-	bool HPhysicsScene::IsCharacterGrounded(UUID entity_id)
+	bool HPhysicsScene::IsCharacterGrounded(EntityId entity_id)
 	{
-		JPH::Character* character = m_characterMap[entity_id];
+		JPH::Character* character = FindSlot(m_characterMap, entity_id);
 		return (JPH::CharacterBase::EGroundState::OnGround == character->GetGroundState());
 	}
 
 	void HPhysicsScene::DestroyAllCharacters()
 	{
-		std::vector<UUID> toKill = std::vector<UUID>();
 		for (auto& [entity_id, character] : m_characterMap)
 		{
-			toKill.push_back(entity_id);
+			if (!character)
+			{
+				continue;
+			}
 			character->RemoveFromPhysicsSystem();
-		}
-		for (auto& entity_id : toKill)
-		{
-			delete m_characterMap[entity_id];
-			m_characterMap.erase(entity_id);
+			delete character;
 			HBodyID::RemoveEntry(entity_id);
 		}
+		m_characterMap.clear();
 	}
 
 	void HPhysicsScene::DestroyAll()
@@ -548,7 +567,7 @@ namespace Engine {
 	}
 
 
-	bool HPhysicsScene::IsActive(UUID entity_id)
+	bool HPhysicsScene::IsActive(EntityId entity_id)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 
@@ -562,11 +581,9 @@ namespace Engine {
 		return (this->m_body_interface)->IsActive(jolt_id);
 	}
 
-	bool HPhysicsScene::HasCollider(UUID entity_id)
+	bool HPhysicsScene::HasCollider(EntityId entity_id)
 	{
-		auto& entity_map = HBodyID::GetMap();
-
-		return entity_map.find(entity_id) != entity_map.end();
+		return HBodyID::HasEntry(entity_id);
 	}
 
 	void HPhysicsScene::SetCollisionAndIntegrationSteps(int collisionSteps, int integrationSubSteps)
@@ -581,42 +598,42 @@ namespace Engine {
 		}
 	}
 
-	void HPhysicsScene::AddNewContact(UUID id1, UUID id2)
+	void HPhysicsScene::AddNewContact(EntityId id1, EntityId id2)
 	{
-		this->m_newContact.push_back(std::pair<UUID, UUID>(id1, id2));
+		this->m_newContact.push_back(std::pair<EntityId, EntityId>(id1, id2));
 	}
 
-	void HPhysicsScene::AddPersistContact(UUID id1, UUID id2)
+	void HPhysicsScene::AddPersistContact(EntityId id1, EntityId id2)
 	{
-		this->m_persistContact.push_back(std::pair<UUID, UUID>(id1, id2));
+		this->m_persistContact.push_back(std::pair<EntityId, EntityId>(id1, id2));
 	}
 
-	void HPhysicsScene::AddRemoveContact(UUID id1, UUID id2)
+	void HPhysicsScene::AddRemoveContact(EntityId id1, EntityId id2)
 	{
-		this->m_removedContact.push_back(std::pair<UUID, UUID>(id1, id2));
+		this->m_removedContact.push_back(std::pair<EntityId, EntityId>(id1, id2));
 	}
 
-	std::vector<std::pair<UUID, UUID>> HPhysicsScene::GetNewContacts()
+	std::vector<std::pair<EntityId, EntityId>> HPhysicsScene::GetNewContacts()
 	{
 		return this->m_newContact;
 	}
 
-	std::vector<std::pair<UUID, UUID>> HPhysicsScene::GetPersistContacts()
+	std::vector<std::pair<EntityId, EntityId>> HPhysicsScene::GetPersistContacts()
 	{
 		return this->m_persistContact;
 	}
 
-	UUID HPhysicsScene::GetUserData(JPH::BodyID id)
+	EntityId HPhysicsScene::GetUserData(JPH::BodyID id)
 	{
-		return this->m_body_interface->GetShape(id)->GetUserData();
+		return EntityId::Unpack(this->m_body_interface->GetShape(id)->GetUserData());
 	}
 
-	std::vector<std::pair<UUID, UUID>> HPhysicsScene::GetRemovedContacts()
+	std::vector<std::pair<EntityId, EntityId>> HPhysicsScene::GetRemovedContacts()
 	{
 		return this->m_removedContact;
 	}
 
-	glm::vec3 HPhysicsScene::GetCenterOfMassPosition(UUID id)
+	glm::vec3 HPhysicsScene::GetCenterOfMassPosition(EntityId id)
 	{
 		if (!HasCollider(id))
 		{
@@ -629,7 +646,7 @@ namespace Engine {
 		return HPhysicsScene::makeGLMVec3(vec);
 	}
 
-	glm::vec3 HPhysicsScene::GetPosition(UUID id)
+	glm::vec3 HPhysicsScene::GetPosition(EntityId id)
 	{
 		if (!HasCollider(id))
 		{
@@ -642,7 +659,7 @@ namespace Engine {
 		return HPhysicsScene::makeGLMVec3(vec);
 	}
 
-	glm::mat4x4 HPhysicsScene::GetCenterOfMassTransform(UUID id)
+	glm::mat4x4 HPhysicsScene::GetCenterOfMassTransform(EntityId id)
 	{
 		if (!HasCollider(id))
 		{
@@ -654,7 +671,7 @@ namespace Engine {
 		return HPhysicsScene::makeMat4x4(vec);
 	}
 
-	glm::mat4 HPhysicsScene::GetTransform(UUID id)
+	glm::mat4 HPhysicsScene::GetTransform(EntityId id)
 	{
 		if (!HasCollider(id))
 		{
@@ -666,7 +683,7 @@ namespace Engine {
 		return HPhysicsScene::makeMat4x4(vec);
 	}
 
-	glm::vec3 HPhysicsScene::GetLinearVelocity(UUID entity_id)
+	glm::vec3 HPhysicsScene::GetLinearVelocity(EntityId entity_id)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 
@@ -674,7 +691,7 @@ namespace Engine {
 		return HPhysicsScene::makeGLMVec3(vec);
 	}
 
-	glm::vec3 HPhysicsScene::GetAngularVelocity(UUID entity_id)
+	glm::vec3 HPhysicsScene::GetAngularVelocity(EntityId entity_id)
 	{
 		JPH::BodyID jolt_id = HBodyID::GetBodyID(entity_id);
 
@@ -124,56 +124,58 @@ namespace Engine {
 		glm::vec3 GetGravity();
 		void SetGravity(glm::vec3);
 		void Update(float deltaTime);
-
-		std::vector<HBodyID> CreateBody(Entity* entity);
-		HBodyID CreateBox(UUID entity_id, float mass, glm::vec3 dimensions, glm::quat rotation, glm::vec3 position, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution);
-		HBodyID CreateSphere(UUID entity_id, float mass, float radius, glm::vec3 position, glm::quat rotation, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution);
-		HBodyID CreateCharacter(UUID entity_id, float mass, float halfHeight, float radius, glm::vec3 position, glm::quat rotation, glm::vec3 offset, float friction, float restitution);
-		void InsertObjectByID(UUID entity_id, bool activate);
-		void SetPosition(UUID entity_id, glm::vec3 position, bool activate);
-		void SetLinearVelocity(UUID entity_id, glm::vec3& velocity);
-		void SetAngularVelocity(UUID entity_id, glm::vec3& velocity);
-		void SetLinearAndAngularVelocity(UUID entity_id, glm::vec3& linaerVelocity, glm::vec3& angularVelocity);
-		void AddLinearVelocity(UUID entity_id, glm::vec3& velocity);
-
-		void AddLinearImpulse(UUID entity_id, glm::vec3& impulse);
-		void AddAngularImpulse(UUID entity_id, glm::vec3& impulse);
-		void AddLinearAndAngularImpulse(UUID entity_id, glm::vec3& linear, glm::vec3& angular);
-		glm::vec3 GetRotation(UUID entity_id);
-		void SetRotation(UUID entity_id, glm::vec3& rotation);
-		void Rotate(UUID entity_id, glm::vec3& delta);
+		// Batch sent by Scene::DestroyEntities before the entities are removed from the registry
+		void OnEntitiesDestroyed(std::span<const EntityId> entity_ids);
+
+		std::vector<HBodyID> CreateBody(Entity entity);
+		HBodyID CreateBox(EntityId entity_id, float mass, glm::vec3 dimensions, glm::quat rotation, glm::vec3 position, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution);
+		HBodyID CreateSphere(EntityId entity_id, float mass, float radius, glm::vec3 position, glm::quat rotation, HEMotionType movability, glm::vec3& offset, bool activate, float friction, float restitution);
+		HBodyID CreateCharacter(EntityId entity_id, float mass, float halfHeight, float radius, glm::vec3 position, glm::quat rotation, glm::vec3 offset, float friction, float restitution);
+		void InsertObjectByID(EntityId entity_id, bool activate);
+		void SetPosition(EntityId entity_id, glm::vec3 position, bool activate);
+		void SetLinearVelocity(EntityId entity_id, glm::vec3& velocity);
+		void SetAngularVelocity(EntityId entity_id, glm::vec3& velocity);
+		void SetLinearAndAngularVelocity(EntityId entity_id, glm::vec3& linaerVelocity, glm::vec3& angularVelocity);
+		void AddLinearVelocity(EntityId entity_id, glm::vec3& velocity);
+
+		void AddLinearImpulse(EntityId entity_id, glm::vec3& impulse);
+		void AddAngularImpulse(EntityId entity_id, glm::vec3& impulse);
+		void AddLinearAndAngularImpulse(EntityId entity_id, glm::vec3& linear, glm::vec3& angular);
+		glm::vec3 GetRotation(EntityId entity_id);
+		void SetRotation(EntityId entity_id, glm::vec3& rotation);
+		void Rotate(EntityId entity_id, glm::vec3& delta);
 
 		bool IsOptimized();
 		void SetOptimized(bool optimized);
 		void OptimizeBroadPhase();
-		void RemoveShape(UUID entity_id);
-		void DestroyShape(UUID entity_id);
+		void RemoveShape(EntityId entity_id);
+		void DestroyShape(EntityId entity_id);
 		void DestroyAllShapes();
-		void RemoveCharacter(UUID entity_id);
-		void DestroyCharacter(UUID entity_id);
-		bool IsCharacterGrounded(UUID entity_id);
+		void RemoveCharacter(EntityId entity_id);
+		void DestroyCharacter(EntityId entity_id);
+		bool IsCharacterGrounded(EntityId entity_id);
 		void DestroyAllCharacters();
 		void DestroyAll();
-		bool IsActive(UUID entity_id);
+		bool IsActive(EntityId entity_id);
 		bool IsActive(HBodyID h_id);
-		bool HasCollider(UUID entity_id);
+		bool HasCollider(EntityId entity_id);
 		void SetCollisionAndIntegrationSteps(int collisionSteps, int integrationSubSteps);
 
-		UUID GetUserData(JPH::BodyID id);	// This is actually internal, do not use
+		EntityId GetUserData(JPH::BodyID id);	// This is actually internal, do not use
 
-		void AddNewContact(UUID id1, UUID id2);
-		void AddPersistContact(UUID id1, UUID id2);
-		void AddRemoveContact(UUID id1, UUID id2);
-		std::vector<std::pair<UUID, UUID>> GetNewContacts();
-		std::vector<std::pair<UUID, UUID>> GetPersistContacts();
-		std::vector<std::pair<UUID, UUID>> GetRemovedContacts();
+		void AddNewContact(EntityId id1, EntityId id2);
+		void AddPersistContact(EntityId id1, EntityId id2);
+		void AddRemoveContact(EntityId id1, EntityId id2);
+		std::vector<std::pair<EntityId, EntityId>> GetNewContacts();
+		std::vector<std::pair<EntityId, EntityId>> GetPersistContacts();
+		std::vector<std::pair<EntityId, EntityId>> GetRemovedContacts();
 
-		glm::vec3 GetCenterOfMassPosition(UUID id);
-		glm::vec3 GetPosition(UUID id);
-		glm::mat4x4 GetCenterOfMassTransform(UUID id);
-		glm::mat4 GetTransform(UUID id);
-		glm::vec3 GetLinearVelocity(UUID entity_id);
-		glm::vec3 GetAngularVelocity(UUID entity_id);
+		glm::vec3 GetCenterOfMassPosition(EntityId id);
+		glm::vec3 GetPosition(EntityId id);
+		glm::mat4x4 GetCenterOfMassTransform(EntityId id);
+		glm::mat4 GetTransform(EntityId id);
+		glm::vec3 GetLinearVelocity(EntityId entity_id);
+		glm::vec3 GetAngularVelocity(EntityId entity_id);
 
 
 		Ref<JPH::PhysicsSystem> GetSystem() { return m_physics_system; }
@@ -205,11 +207,12 @@ namespace Engine {
 
 		inline static bool s_hasOptimized = false;
 
-		std::map<UUID, JPH::Body*> m_bodyMap = std::map<UUID, JPH::Body*>();
-		std::map<UUID, JPH::Character*> m_characterMap = std::map<UUID, JPH::Character*>();
-		std::vector<std::pair<UUID, UUID>> m_newContact = std::vector<std::pair<UUID, UUID>>();
-		std::vector<std::pair<UUID, UUID>> m_persistContact = std::vector<std::pair<UUID, UUID>>();
-		std::vector<std::pair<UUID, UUID>> m_removedContact = std::vector<std::pair<UUID, UUID>>();
+		// Indexed by EntityId::Index, a slot is empty when its pointer is null
+		std::vector<std::pair<EntityId, JPH::Body*>> m_bodyMap = std::vector<std::pair<EntityId, JPH::Body*>>();
+		std::vector<std::pair<EntityId, JPH::Character*>> m_characterMap = std::vector<std::pair<EntityId, JPH::Character*>>();
+		std::vector<std::pair<EntityId, EntityId>> m_newContact = std::vector<std::pair<EntityId, EntityId>>();
+		std::vector<std::pair<EntityId, EntityId>> m_persistContact = std::vector<std::pair<EntityId, EntityId>>();
+		std::vector<std::pair<EntityId, EntityId>> m_removedContact = std::vector<std::pair<EntityId, EntityId>>();
 
 		static JPH::RVec3 makeRVec3(glm::vec3 arr);
 		static JPH::Vec3 makeVec3(glm::vec3 arr);
@@ -1,11 +1,37 @@
 #include "pch.h"
 #include "Material.h"
 #include "Renderer.h"
+#include "MaterialBuffer.h"
 
 namespace Engine {
+	static constexpr std::string_view s_ConstantPrefix = "u_MaterialUniforms.";
+
+	// Scalars convert between each other the way glUniform would, anything else keeps the field's default
+	template<typename T>
+	static T ConvertUniform(const UniformValue& value)
+	{
+		return std::visit([](auto&& arg) -> T
+		{
+			if constexpr (std::is_convertible_v<std::decay_t<decltype(arg)>, T>)
+			{
+				return (T)arg;
+			}
+			else
+			{
+				return T();
+			}
+		}, value);
+	}
+
 	Material::Material(Ref<ShaderProgram> program) : m_Program(program)
 	{
-		
+		m_BufferSlot = MaterialBuffer::Allocate();
+		m_MaterialIndexLocation = m_Program->GetUniformLocation("u_MaterialIndex");
+	}
+
+	Material::~Material()
+	{
+		MaterialBuffer::Free(m_BufferSlot);
 	}
 	
 	void Material::ApplyMaterial()
@@ -15,75 +41,115 @@ namespace Engine {
 			item.second->Bind(item.first);
 		}
 
+		// Constants are already in the MaterialBuffer, only uniforms of other shaders are set again
 		for (const auto& uniform : m_Uniforms)
 		{
+			if (uniform.second.Constant)
+			{
+				continue;
+			}
 			std::visit([&](auto&& arg) {
-				m_Program->Set(uniform.first, arg);
-			}, uniform.second);
+				m_Program->Set(uniform.second.Location, arg);
+			}, uniform.second.Value);
 		}
 
+		m_Program->Set(m_MaterialIndexLocation, m_BufferSlot);
 		m_Program->Activate();
 
     }
+
+	void Material::SetProgram(Ref<ShaderProgram> program)
+	{
+		m_Program = program;
+		m_MaterialIndexLocation = m_Program->GetUniformLocation("u_MaterialIndex");
+		for (auto& [name, uniform] : m_Uniforms)
+		{
+			uniform.Location = uniform.Constant ? -1 : m_Program->GetUniformLocation(name);
+		}
+	}
+
+	bool Material::IsConstant(std::string_view name)
+	{
+		return name.starts_with(s_ConstantPrefix);
+	}
+
+	void Material::SetConstant(std::string_view name, const UniformValue& value)
+	{
+		std::string_view field = name.substr(s_ConstantPrefix.size());
+		MaterialConstants& constants = MaterialBuffer::Edit(m_BufferSlot);
+		if (field == "AlbedoColor")
+		{
+			constants.AlbedoColor = std::holds_alternative<glm::vec3>(value) ? std::get<glm::vec3>(value) : glm::vec3(ConvertUniform<float>(value));
+		}
+		else if (field == "Metalness")
+		{
+			constants.Metalness = ConvertUniform<float>(value);
+		}
+		else if (field == "Roughness")
+		{
+			constants.Roughness = ConvertUniform<float>(value);
+		}
+		else if (field == "Emission")
+		{
+			constants.Emission = ConvertUniform<float>(value);
+		}
+		else if (field == "UseNormalMap")
+		{
+			constants.UseNormalMap = ConvertUniform<int>(value);
+		}
+		else
+		{
+			HVE_CORE_WARN("Material has no constant named {}", field);
+		}
+	}
+
 	void Material::Set(const std::string& name, float value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, int value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, uint32_t value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, bool value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::ivec2& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::ivec3& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::ivec4& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::vec2& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::vec3& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::vec4& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::mat3& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const glm::mat4& value)
 	{
-		m_Uniforms[name] = value;
-		m_Program->Set(name, value);
+		SetUniform(name, value);
 	}
 	void Material::Set(const std::string& name, const Ref<Texture2D>& texture, uint32_t slot)
 	{
@@ -68,11 +68,19 @@ namespace Engine {
 	public:
 
 		Material(Ref<ShaderProgram> program);
+		~Material();
+		// A material owns its slot in the MaterialBuffer
+		Material(const Material&) = delete;
+		Material& operator=(const Material&) = delete;
 
+		// Binds the textures and points the program at this material's constants
 		void ApplyMaterial();
 
+		uint32_t GetBufferSlot() const { return m_BufferSlot; }
+
 		Ref<ShaderProgram> GetProgram() { return m_Program; }
-		void SetProgram(Ref<ShaderProgram> program) { m_Program = program; }
+		// Resolves the uniform locations again for the new program
+		void SetProgram(Ref<ShaderProgram> program);
 
 		void Set(const std::string& name, float value);
 		void Set(const std::string& name, int value);
@@ -94,7 +102,7 @@ namespace Engine {
 			auto it = m_Uniforms.find(uniform_name);
 			if (it != m_Uniforms.end())
 			{
-				const UniformValue& value = it->second;
+				const UniformValue& value = it->second.Value;
 
 				if (std::holds_alternative<T>(value))
 				{
@@ -105,9 +113,44 @@ namespace Engine {
 			return GetDefaultValue<T>();
 		}
 
+	protected:
+		// Location is resolved once, when the uniform is first set, ApplyMaterial never looks names up.
+		// Constant uniforms are fields of u_MaterialUniforms, they live in the MaterialBuffer instead of the program.
+		struct MaterialUniform
+		{
+			UniformValue Value;
+			GLint Location = -1;
+			bool Constant = false;
+		};
+
+		template<typename T>
+		void SetUniform(const std::string& name, const T& value)
+		{
+			auto [it, inserted] = m_Uniforms.try_emplace(name);
+			if (inserted)
+			{
+				it->second.Constant = IsConstant(name);
+				it->second.Location = it->second.Constant ? -1 : m_Program->GetUniformLocation(name);
+			}
+			it->second.Value = value;
+			if (it->second.Constant)
+			{
+				SetConstant(name, it->second.Value);
+			}
+			else
+			{
+				m_Program->Set(it->second.Location, value);
+			}
+		}
+
+		static bool IsConstant(std::string_view name);
+		void SetConstant(std::string_view name, const UniformValue& value);
+
 	protected:
 		Ref<ShaderProgram> m_Program;
 		std::unordered_map<uint32_t, Ref<Texture2D>> m_Textures;
-		std::unordered_map<std::string, UniformValue> m_Uniforms;
+		std::unordered_map<std::string, MaterialUniform> m_Uniforms;
+		uint32_t m_BufferSlot = 0;
+		GLint m_MaterialIndexLocation = -1;
 	};
 }
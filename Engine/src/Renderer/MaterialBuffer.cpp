@@ -0,0 +1,102 @@
+#include "pch.h"
+#include "MaterialBuffer.h"
+#include "UniformBuffer.h"
+#include <mutex>
+
+namespace Engine {
+
+	static constexpr uint32_t s_MaterialBufferBinding = 4;
+
+	struct MaterialBufferData
+	{
+		std::mutex Mutex;
+		std::vector<MaterialConstants> Constants;
+		std::vector<uint32_t> FreeSlots;
+
+		Ref<ShaderStorageBuffer> Buffer;
+		uint32_t Capacity = 0;
+		// Range of slots edited since the last flush, empty when DirtyBegin >= DirtyEnd
+		uint32_t DirtyBegin = UINT32_MAX;
+		uint32_t DirtyEnd = 0;
+	};
+
+	static MaterialBufferData* s_Data = new MaterialBufferData();
+
+	static void MarkDirty(uint32_t slot)
+	{
+		s_Data->DirtyBegin = std::min(s_Data->DirtyBegin, slot);
+		s_Data->DirtyEnd = std::max(s_Data->DirtyEnd, slot + 1);
+	}
+
+	uint32_t MaterialBuffer::Allocate()
+	{
+		std::lock_guard lock(s_Data->Mutex);
+		uint32_t slot;
+		if (!s_Data->FreeSlots.empty())
+		{
+			slot = s_Data->FreeSlots.back();
+			s_Data->FreeSlots.pop_back();
+			s_Data->Constants[slot] = MaterialConstants();
+		}
+		else
+		{
+			slot = (uint32_t)s_Data->Constants.size();
+			s_Data->Constants.emplace_back();
+		}
+		MarkDirty(slot);
+		return slot;
+	}
+
+	void MaterialBuffer::Free(uint32_t slot)
+	{
+		// Materials can be released off the main thread together with the asset holding them
+		std::lock_guard lock(s_Data->Mutex);
+		s_Data->FreeSlots.push_back(slot);
+	}
+
+	const MaterialConstants& MaterialBuffer::Get(uint32_t slot)
+	{
+		return s_Data->Constants[slot];
+	}
+
+	MaterialConstants& MaterialBuffer::Edit(uint32_t slot)
+	{
+		std::lock_guard lock(s_Data->Mutex);
+		MarkDirty(slot);
+		return s_Data->Constants[slot];
+	}
+
+	void MaterialBuffer::Flush()
+	{
+		HVE_PROFILE_FUNC();
+		std::lock_guard lock(s_Data->Mutex);
+		uint32_t count = (uint32_t)s_Data->Constants.size();
+		if (count > s_Data->Capacity)
+		{
+			// A new buffer starts out empty, everything goes up again
+			s_Data->Capacity = std::max(count, std::max(s_Data->Capacity * 2, 64u));
+			s_Data->Buffer = CreateRef<ShaderStorageBuffer>(s_Data->Capacity * (uint32_t)sizeof(MaterialConstants), s_MaterialBufferBinding);
+			s_Data->DirtyBegin = 0;
+			s_Data->DirtyEnd = count;
+		}
+
+		if (s_Data->Buffer)
+		{
+			s_Data->Buffer->Bind();
+		}
+		if (s_Data->DirtyBegin < s_Data->DirtyEnd)
+		{
+			uint32_t end = std::min(s_Data->DirtyEnd, count);
+			s_Data->Buffer->SetData(s_Data->Constants.data() + s_Data->DirtyBegin, (end - s_Data->DirtyBegin) * sizeof(MaterialConstants), s_Data->DirtyBegin * sizeof(MaterialConstants));
+		}
+		s_Data->DirtyBegin = UINT32_MAX;
+		s_Data->DirtyEnd = 0;
+	}
+
+	void MaterialBuffer::Shutdown()
+	{
+		std::lock_guard lock(s_Data->Mutex);
+		s_Data->Buffer = nullptr;
+		s_Data->Capacity = 0;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+	// One material's entry of the Materials block in the shaders, std430
+	struct MaterialConstants
+	{
+		glm::vec3 AlbedoColor = glm::vec3(1.0f);
+		float Metalness = 0.0f;
+		float Roughness = 1.0f;
+		float Emission = 0.0f;
+		int UseNormalMap = 0;
+		float Padding = 0.0f;
+	};
+
+	// The constants of every material in one shader storage buffer at binding 4, a slot per material. Editing a
+	// slot only changes the CPU copy, Flush uploads the slots edited since the last flush in one go. Shaders
+	// pick their entry with the u_MaterialIndex uniform.
+	class MaterialBuffer
+	{
+	public:
+		static uint32_t Allocate();
+		static void Free(uint32_t slot);
+
+		static const MaterialConstants& Get(uint32_t slot);
+		// Marks the slot for the next upload
+		static MaterialConstants& Edit(uint32_t slot);
+
+		// Called by the renderer before it draws, grows the GPU buffer when slots were added
+		static void Flush();
+		static void Shutdown();
+	};
+}
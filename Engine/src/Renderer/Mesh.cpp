@@ -2,6 +2,35 @@
 #include "Mesh.h"
 
 namespace Engine {
+	void MeshSource::SetSubmeshes(std::vector<Submesh> submeshes)
+	{
+		m_Submeshes = submeshes;
+		m_LODCount = 1;
+		for (const Submesh& submesh : m_Submeshes)
+		{
+			m_LODCount = std::max(m_LODCount, (uint32_t)submesh.LODs.size());
+		}
+	}
+
+	uint32_t MeshSource::SelectLOD(float screen_size, uint32_t current_lod, float hysteresis) const
+	{
+		// The thresholds shrink with the level, so the levels a size is below form a prefix. The mesh has to be at
+		// least as coarse as the levels it is clearly below and at most as coarse as the ones it is not clearly above.
+		uint32_t min_lod = 0, max_lod = 0;
+		for (uint32_t lod = 1; lod < m_LODCount; lod++)
+		{
+			if (screen_size < m_LODScreenSizes[lod] * (1.0f - hysteresis))
+			{
+				min_lod = lod;
+			}
+			if (screen_size < m_LODScreenSizes[lod] * (1.0f + hysteresis))
+			{
+				max_lod = lod;
+			}
+		}
+		return std::clamp(current_lod, min_lod, max_lod);
+	}
+
 	Mesh::Mesh(Ref<MeshSource> source) : m_MeshSource(source)
 	{
 	
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <glad/gl.h>
 #include "VertexArray.h"
 #include "Material.h"
@@ -21,6 +22,15 @@ namespace Engine {
 		Vertex V0, V1, V2;
 	};
 
+	// One level of detail of a submesh, a range of the submesh's index buffer. All levels index the same vertices.
+	struct SubmeshLOD
+	{
+		uint32_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+		// Distinct vertices the range references
+		uint32_t VertexCount = 0;
+	};
+
 	class Submesh
 	{
 	public:
@@ -35,6 +45,19 @@ namespace Engine {
 		std::string MeshName;
 
 		Math::BoundingBox Bounds;
+
+		// LODs[0] is the full submesh, every level after it has roughly a quarter of the triangles of the one before
+		std::vector<SubmeshLOD> LODs;
+
+		// Range to draw at lod, a level the submesh does not have falls back to its coarsest
+		SubmeshLOD GetLOD(uint32_t lod) const
+		{
+			if (LODs.empty())
+			{
+				return { 0, VertexArray ? VertexArray->GetIndexBuffer()->GetCount() : 0, 0 };
+			}
+			return LODs[std::min(lod, (uint32_t)LODs.size() - 1)];
+		}
 	};
 
 	struct MeshNode
@@ -49,17 +72,28 @@ namespace Engine {
 	class MeshSource : public Asset
 	{
 	public:
+		static constexpr uint32_t MaxLODs = 4;
+
 		int VertexSize() { return m_VertexCount; }
 		int IndexSize() { return m_IndexCount; }
 		std::vector<Submesh>& GetSubmeshes() { return m_Submeshes; }
 		std::vector<Ref<Material>>& GetMaterials() { return m_Materials; }
 		void SetNodes(std::vector<MeshNode> nodes) { m_Nodes = nodes; }
-		void SetSubmeshes(std::vector<Submesh> submeshes) { m_Submeshes = submeshes; }
+		void SetSubmeshes(std::vector<Submesh> submeshes);
 		void SetMaterials(std::vector<Ref<Material>> materials) { m_Materials = materials; }
 		const std::vector<Triangle> GetTriangleCache(uint32_t index) const { return m_TriangleCache.at(index); }
 		void AddTriangleCache(uint32_t index, Triangle triangle) { m_TriangleCache[index].push_back(triangle); }
 		Math::BoundingBox* GetBounds() { return &m_Bounds; }
 
+		// Levels of the submesh with the most of them, at least 1
+		uint32_t GetLODCount() const { return m_LODCount; }
+		// LOD i is drawn once the mesh covers less than this fraction of the viewport height
+		float GetLODScreenSize(uint32_t lod) const { return m_LODScreenSizes[lod]; }
+		void SetLODScreenSize(uint32_t lod, float screen_size) { m_LODScreenSizes[lod] = screen_size; }
+		// Level for a mesh covering screen_size of the viewport height that draws current_lod now. The level only
+		// changes once the size is a hysteresis fraction past a threshold, a mesh sitting on one does not flicker.
+		uint32_t SelectLOD(float screen_size, uint32_t current_lod, float hysteresis = 0.1f) const;
+
 
 		static AssetType GetStaticType() { return AssetType::MeshSource; } // Good for templated functions
 		AssetType GetType() const { return GetStaticType(); }
@@ -72,6 +106,8 @@ namespace Engine {
 		int m_VertexCount = 0;
 		int m_IndexCount = 0;
 		Math::BoundingBox m_Bounds;
+		uint32_t m_LODCount = 1;
+		std::array<float, MaxLODs> m_LODScreenSizes = { 1.0f, 0.3f, 0.15f, 0.075f };
 	};
 
 	class Mesh: public Asset
@@ -84,7 +120,11 @@ namespace Engine {
 		void SetTransform(glm::mat4 transform);
 
 		Ref<MeshSource> GetMeshSource() { return m_MeshSource; }
-		void SetMeshSource(Ref<MeshSource> mesh_source) { m_MeshSource = mesh_source; }
+		void SetMeshSource(Ref<MeshSource> mesh_source) { m_MeshSource = mesh_source; m_LOD = 0; }
+
+		// Level the renderer draws, picked each frame by the scene's MeshLOD system
+		uint32_t GetLOD() const { return m_LOD; }
+		void SetLOD(uint32_t lod) { m_LOD = lod; }
 
 		static AssetType GetStaticType() { return AssetType::Mesh; } // Good for templated functions
 		AssetType GetType() const { return GetStaticType(); }
@@ -92,5 +132,6 @@ namespace Engine {
 	private:
 		Ref<MeshSource> m_MeshSource;
 		glm::mat4 m_Transform;
+		uint32_t m_LOD = 0;
 	};
 }
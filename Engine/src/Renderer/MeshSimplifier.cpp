@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "MeshSimplifier.h"
+
+namespace Engine {
+
+	// Meshes this small cost nothing to draw whole
+	static constexpr uint32_t s_MinLODTriangles = 64;
+	// A level has to drop at least this share of the triangles of the level before it
+	static constexpr float s_MinLODReduction = 0.4f;
+
+	void MeshSimplifier::GenerateLODs(std::span<const Vertex> vertices, std::vector<uint32_t>& indices, const Math::BoundingBox& bounds, std::vector<SubmeshLOD>& lods, uint32_t max_lods)
+	{
+		HVE_PROFILE_FUNC();
+		if (lods.empty() || bounds.IsEmpty())
+		{
+			return;
+		}
+
+		// Copied, the levels are appended to the same vector
+		const std::vector<uint32_t> source(indices.begin() + lods[0].IndexOffset, indices.begin() + lods[0].IndexOffset + lods[0].IndexCount);
+		std::vector<uint8_t> used(vertices.size());
+
+		uint32_t previous_triangles = lods[0].IndexCount / 3;
+		while (lods.size() < max_lods && previous_triangles > s_MinLODTriangles)
+		{
+			uint32_t target = previous_triangles / 4;
+
+			// Clustering a surface on an n^3 grid leaves a few triangles per cell it passes through, so about n^2
+			// of them. Start from that and correct the resolution by the count the first attempts come out at.
+			uint32_t resolution = std::max((uint32_t)std::sqrt(target * 0.5f), 2u);
+			std::vector<uint32_t> simplified;
+			for (uint32_t attempt = 0; attempt < 3; attempt++)
+			{
+				simplified = Cluster(vertices, source, bounds, resolution);
+				uint32_t triangles = (uint32_t)simplified.size() / 3;
+				if (triangles <= target + target / 2 || resolution == 2)
+				{
+					break;
+				}
+				resolution = std::max((uint32_t)(resolution * std::sqrt((float)target / triangles)), 2u);
+			}
+
+			uint32_t triangles = (uint32_t)simplified.size() / 3;
+			if (triangles == 0 || triangles > previous_triangles * (1.0f - s_MinLODReduction))
+			{
+				break;
+			}
+
+			SubmeshLOD lod;
+			lod.IndexOffset = (uint32_t)indices.size();
+			lod.IndexCount = (uint32_t)simplified.size();
+			std::fill(used.begin(), used.end(), 0);
+			for (uint32_t index : simplified)
+			{
+				lod.VertexCount += used[index] ? 0 : 1;
+				used[index] = 1;
+			}
+
+			indices.insert(indices.end(), simplified.begin(), simplified.end());
+			lods.push_back(lod);
+			previous_triangles = triangles;
+		}
+	}
+
+	std::vector<uint32_t> MeshSimplifier::Cluster(std::span<const Vertex> vertices, std::span<const uint32_t> indices, const Math::BoundingBox& bounds, uint32_t resolution)
+	{
+		glm::vec3 size = glm::max(bounds.Max - bounds.Min, glm::vec3(1e-6f));
+		float cell_size = std::max(size.x, std::max(size.y, size.z)) / resolution;
+		glm::uvec3 cells = glm::max(glm::uvec3(glm::ceil(size / cell_size)), glm::uvec3(1));
+
+		// Vertex standing in for each cell, and for each vertex the one standing in for its cell
+		std::unordered_map<uint64_t, uint32_t> representatives;
+		std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size() / 2);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			uint32_t corners[3];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				uint32_t index = indices[i + c];
+				if (remap[index] == UINT32_MAX)
+				{
+					glm::uvec3 cell = glm::clamp((vertices[index].coordinates - bounds.Min) / cell_size, glm::vec3(0.0f), glm::vec3(cells - 1u));
+					uint64_t key = ((uint64_t)cell.z * cells.y + cell.y) * cells.x + cell.x;
+					remap[index] = representatives.try_emplace(key, index).first->second;
+				}
+				corners[c] = remap[index];
+			}
+
+			if (corners[0] != corners[1] && corners[1] != corners[2] && corners[0] != corners[2])
+			{
+				result.insert(result.end(), corners, corners + 3);
+			}
+		}
+		return result;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "Mesh.h"
+
+namespace Engine {
+
+	// Builds the coarser levels of detail of a submesh by vertex clustering: vertices are snapped to a grid over the
+	// submesh bounds, every grid cell keeps one of its vertices and the triangles that collapse are dropped. It runs
+	// on any triangle soup, but ignores UV seams and hard edges, which only matters up close where LOD 0 is drawn.
+	class MeshSimplifier
+	{
+	public:
+		// indices holds LOD 0, described by lods[0]. Each new level is appended to indices and to lods, until
+		// max_lods is reached or a level would not save enough triangles to be worth drawing.
+		static void GenerateLODs(std::span<const Vertex> vertices, std::vector<uint32_t>& indices, const Math::BoundingBox& bounds, std::vector<SubmeshLOD>& lods, uint32_t max_lods);
+
+		// Triangles of indices after collapsing the vertices onto a grid of resolution cells along the longest axis
+		static std::vector<uint32_t> Cluster(std::span<const Vertex> vertices, std::span<const uint32_t> indices, const Math::BoundingBox& bounds, uint32_t resolution);
+	};
+}
@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "RenderQueue.h"
+#include <bit>
+
+namespace Engine {
+
+	// Non-negative floats order the same as their bit patterns, anything behind the viewer counts as depth 0
+	static uint32_t DepthToBits(float depth)
+	{
+		return std::bit_cast<uint32_t>(std::max(depth, 0.0f));
+	}
+
+	uint64_t RenderQueue::MakeOpaqueKey(RenderPass pass, uint32_t program, uint32_t material, uint32_t vertex_array, float depth)
+	{
+		// The top half of the float keeps the exponent and 7 bits of mantissa, depth to within about 1%
+		return ((uint64_t)pass << 60)
+			| ((uint64_t)(program & 0xfff) << 48)
+			| ((uint64_t)(material & 0xffff) << 32)
+			| ((uint64_t)(vertex_array & 0xffff) << 16)
+			| (uint64_t)(DepthToBits(depth) >> 16);
+	}
+
+	uint64_t RenderQueue::MakeDepthKey(RenderPass pass, float depth, uint32_t vertex_array)
+	{
+		return ((uint64_t)pass << 60)
+			| ((uint64_t)DepthToBits(depth) << 28)
+			| ((uint64_t)(vertex_array & 0xffff) << 12);
+	}
+
+	void RenderQueue::Sort()
+	{
+		HVE_PROFILE_FUNC();
+		const size_t count = m_Packets.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		// Least significant byte first, all eight histograms come out of a single sweep
+		uint32_t histograms[8][256] = {};
+		for (const DrawPacket& packet : m_Packets)
+		{
+			for (uint32_t digit = 0; digit < 8; digit++)
+			{
+				histograms[digit][(packet.Key >> (digit * 8)) & 0xff]++;
+			}
+		}
+
+		m_Scratch.resize(count);
+		DrawPacket* source = m_Packets.data();
+		DrawPacket* destination = m_Scratch.data();
+		for (uint32_t digit = 0; digit < 8; digit++)
+		{
+			uint32_t* histogram = histograms[digit];
+			// Most of the key is the same for every packet, a byte that never changes needs no pass
+			if (histogram[(source[0].Key >> (digit * 8)) & 0xff] == count)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < 256; bucket++)
+			{
+				uint32_t bucket_count = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucket_count;
+			}
+			for (size_t i = 0; i < count; i++)
+			{
+				destination[histogram[(source[i].Key >> (digit * 8)) & 0xff]++] = source[i];
+			}
+			std::swap(source, destination);
+		}
+
+		if (source != m_Packets.data())
+		{
+			m_Packets.swap(m_Scratch);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+
+namespace Engine {
+
+	enum class RenderPass : uint8_t
+	{
+		Depth = 0,
+		Shadow = 1,
+		Opaque = 2
+	};
+
+	// A draw and the key it is ordered by, DrawIndex is left to the owner of the queue
+	struct DrawPacket
+	{
+		uint64_t Key = 0;
+		uint32_t DrawIndex = 0;
+	};
+
+	// Draws of one pass, radix sorted by a 64 bit key before they are submitted. The state that costs the most to
+	// change sits in the highest bits of the key, so sorting groups draws by program, then material, then vertex
+	// array and orders each group front to back.
+	class RenderQueue
+	{
+	public:
+		// [pass:4][program:12][material:16][vertex array:16][depth:16]
+		static uint64_t MakeOpaqueKey(RenderPass pass, uint32_t program, uint32_t material, uint32_t vertex_array, float depth);
+		// [pass:4][depth:32][vertex array:16][unused:12], for passes that draw with a single program
+		static uint64_t MakeDepthKey(RenderPass pass, float depth, uint32_t vertex_array);
+
+		void Clear() { m_Packets.clear(); }
+		void Push(uint64_t key, uint32_t draw_index) { m_Packets.push_back({ key, draw_index }); }
+		// Stable, draws with equal keys keep the order they were pushed in
+		void Sort();
+
+		const std::vector<DrawPacket>& GetPackets() const { return m_Packets; }
+		size_t Size() const { return m_Packets.size(); }
+
+	private:
+		std::vector<DrawPacket> m_Packets;
+		std::vector<DrawPacket> m_Scratch;
+	};
+}
@@ -2,6 +2,8 @@
 #include "Renderer.h"
 #include "Core/Application.h"
 #include "Framebuffer.h"
+#include "Math/SIMD.h"
+#include "MaterialBuffer.h"
 
 namespace Engine
 {
@@ -157,6 +159,8 @@ namespace Engine
 		ResizeBuffers();
 
 		m_LightMatricesBuffer = UniformBuffer::Create(sizeof(glm::mat4x4) * 16, 0);
+		m_FrameUniformBuffer = UniformBuffer::Create(sizeof(FrameUniforms), 1);
+		m_ViewUniformBuffer = UniformBuffer::Create(sizeof(ViewUniforms), 2);
 
 		CreateSkybox(m_Settings.Skybox);
 
@@ -187,6 +191,7 @@ namespace Engine
     }
 
     Renderer::~Renderer() {
+		MaterialBuffer::Shutdown();
 		delete s_DefaultTextures;
     }
 
@@ -309,8 +314,7 @@ namespace Engine
 			return;
 		}
 		m_Meshes.push_back(mesh);
-		m_Stats.vertices_count += mesh->GetMeshSource()->VertexSize();
-		m_Stats.index_count += mesh->GetMeshSource()->IndexSize();
+		m_Stats.lod_mesh_count[std::min(mesh->GetLOD(), MeshSource::MaxLODs - 1)]++;
 	}
 
 	void Renderer::SubmitDebugLine(Line line)
@@ -369,18 +373,37 @@ namespace Engine
 		m_Settings.Skybox = settings;
 	}
 
+	void Renderer::UploadFrameUniforms()
+	{
+		FrameUniforms frame{};
+		frame.sun_view = m_Settings.ShadowSettings.DirLightView;
+		frame.sun_projection = m_Settings.ShadowSettings.DirLightProjection;
+		frame.environment_brightness = m_Settings.Skybox.Brightness;
+		frame.num_directional_lights = (int)m_DirectionalLights.size();
+		m_FrameUniformBuffer->SetData(&frame, sizeof(FrameUniforms));
+	}
+
+	void Renderer::UploadViewUniforms()
+	{
+		ViewUniforms view{};
+		view.view = m_CurrentCamera->GetView();
+		view.projection = m_CurrentCamera->GetProjection();
+		view.position = m_CurrentCamera->CalculatePosition();
+		view.far_plane = m_CurrentCamera->GetFar();
+		m_ViewUniformBuffer->SetData(&view, sizeof(ViewUniforms));
+	}
+
 	void Renderer::DepthPrePass()
 	{
 		HVE_PROFILE_FUNC();
 		m_DepthFramebuffer->Bind();
 		m_RendererAPI.ClearDepth();
 		Ref<ShaderProgram> shader = m_ShaderLibrary.Get("forward_plus_depth_pre_pass");
-		shader->Set("u_CameraView", m_CurrentCamera->GetView());
-		shader->Set("u_CameraProjection", m_CurrentCamera->GetProjection());
 		shader->Activate();
 		m_RendererAPI.SetViewport(0, 0, current_window_width, current_window_height);
-		for (Ref<Mesh> mesh : m_Meshes) {
-			DrawIndexed(mesh, false);
+		BuildBatches(m_DepthQueue, false, m_Batches);
+		for (const DrawBatch& batch : m_Batches) {
+			DrawInstances(batch, false);
 		}
 
 		m_DepthFramebuffer->Unbind();
@@ -475,13 +498,24 @@ namespace Engine
 			m_LightMatricesBuffer->SetData(&lightMatrices[i], sizeof(glm::mat4x4), i * sizeof(glm::mat4x4));
 		}
 
+		// Casters outside the camera frustum still throw shadows into it, each cascade is tested on its own
+		std::vector<Math::Frustum> cascade_frusta;
+		for (const glm::mat4& light_matrix : lightMatrices)
+		{
+			cascade_frusta.push_back(Math::Frustum::FromMatrix(light_matrix));
+		}
+		CullSubmeshes(cascade_frusta, m_ShadowSubmeshes);
+		m_Stats.shadow_culled_submeshes += (int)(m_SubmeshDraws.size() - m_ShadowSubmeshes.size());
+		BuildShadowQueue(m_DirectionalLights[0]->GetDirection());
+
 		auto dir_shader = m_ShaderLibrary.Get("dir_light_shadows");
 		dir_shader->Activate();
 		m_RendererAPI.SetViewport(0, 0, m_Settings.ShadowSettings.Resolution, m_Settings.ShadowSettings.Resolution);
 		m_RendererAPI.SetCull(CullOption::FRONT);
-		for (Ref<Mesh> mesh : m_Meshes)
+		BuildBatches(m_ShadowQueue, false, m_Batches);
+		for (const DrawBatch& batch : m_Batches)
 		{
-			DrawIndexed(mesh, false);
+			DrawInstances(batch, false);
 		}
 		m_RendererAPI.SetCull(CullOption::BACK);
 		m_SunShadowBuffer->Unbind();
@@ -506,8 +540,19 @@ namespace Engine
 	{
 		HVE_PROFILE_FUNC();
 		m_RendererAPI.SetViewport(0, 0, current_window_width, current_window_height);
-		for (size_t i = 0; i < m_Meshes.size(); i++) {
-			DrawIndexed(m_Meshes[i], true);
+		// Image based lighting is the same for every material, materials only use the slots below 10
+		m_Settings.Skybox.IrradianceTexture->Bind(10);
+		m_Settings.Skybox.PrefilterMap->Bind(11);
+		m_RendererAPI.BindTexture(m_BRDFBuffer->GetColorAttachmentRendererID(), 12);
+
+		// The queue keeps each material's draws together, it is applied once per run of them
+		BuildBatches(m_OpaqueQueue, true, m_Batches);
+		const Material* applied_material = nullptr;
+		for (const DrawBatch& batch : m_Batches) {
+			const SubmeshDraw& draw = m_SubmeshDraws[batch.draw_index];
+			const Material* material = draw.mesh->GetMeshSource()->GetMaterials()[draw.mesh->GetMeshSource()->GetSubmeshes()[draw.submesh_index].MaterialIndex].get();
+			DrawInstances(batch, material != applied_material);
+			applied_material = material;
 		}
 		
 	}
@@ -546,10 +591,7 @@ namespace Engine
 			m_RendererAPI.SetDepthFunction(LEqual);
 			m_Settings.Skybox.Texture->Bind();
 			auto shader = m_ShaderLibrary.Get("skybox_shader");
-			glm::mat4 view = glm::mat4(glm::mat3(m_CurrentCamera->GetView()));
-			shader->Set("u_CameraView", view);
 			shader->Set("u_Brightness", m_Settings.Skybox.Brightness);
-			shader->Set("u_CameraProjection", m_CurrentCamera->GetProjection());
 			shader->Activate();
 			m_RendererAPI.DrawCube();
 			m_RendererAPI.SetDepthFunction(Less);
@@ -570,44 +612,216 @@ namespace Engine
 		m_SunShadowBuffer = Framebuffer::Create(sunSpec);
 	}
 
-	void Renderer::DrawIndexed(Ref<Mesh> mesh, bool use_material)
+	void Renderer::CullSubmeshes()
 	{
 		HVE_PROFILE_FUNC();
-		for (size_t i = 0; i < mesh->GetMeshSource()->GetSubmeshes().size(); i++)
+		m_SubmeshDraws.clear();
+		std::vector<Math::BoundingBox> local_bounds;
+		for (const Ref<Mesh>& mesh : m_Meshes)
 		{
-			Ref<Material> material = mesh->GetMeshSource()->GetMaterials()[mesh->GetMeshSource()->GetSubmeshes()[i].MaterialIndex];
-			if (use_material)
+			const std::vector<Submesh>& submeshes = mesh->GetMeshSource()->GetSubmeshes();
+			for (uint32_t i = 0; i < submeshes.size(); i++)
 			{
-				m_Settings.Skybox.IrradianceTexture->Bind(10);
-				m_Settings.Skybox.PrefilterMap->Bind(11);
-				m_RendererAPI.BindTexture(m_BRDFBuffer->GetColorAttachmentRendererID(), 12);
-				/*m_RendererAPI.BindTexture(m_SunShadowBuffer->GetDepthAttachmentID(), 13);
-				material->Set("u_CascadeCount", (int)m_Settings.ShadowSettings.ShadowCascadeLevels.size());
-				for (size_t i = 0; i < m_Settings.ShadowSettings.ShadowCascadeLevels.size(); ++i)
+				if (submeshes[i].Bounds.IsEmpty())
 				{
-					material->Set("u_CascadePlaneDistances[" + std::to_string(i) + "]", m_Settings.ShadowSettings.ShadowCascadeLevels[i]);
-				}*/
-				material->Set("u_CameraFarPlane", m_CurrentCamera->GetFar());
-				material->Set("u_SunView", m_Settings.ShadowSettings.DirLightView);
-				material->Set("u_SunProjection", m_Settings.ShadowSettings.DirLightProjection);
-				material->Set("u_EnvironmentBrightness", m_Settings.Skybox.Brightness);
-				material->Set("u_CameraPos", m_CurrentCamera->CalculatePosition());
-				material->Set("u_CameraView", m_CurrentCamera->GetView());
-				material->Set("u_CameraProjection", m_CurrentCamera->GetProjection());
-				material->Set("u_NumDirectionalLights", (int)m_DirectionalLights.size());
-				if (!material->GetUniformValue<int>("u_UseNormalMap"))
+					continue;
+				}
+				m_SubmeshDraws.push_back({ mesh.get(), i, mesh->GetTransform() * submeshes[i].WorldTransform });
+				local_bounds.push_back(submeshes[i].Bounds);
+			}
+		}
+
+		std::vector<glm::mat4> transforms(m_SubmeshDraws.size());
+		for (size_t i = 0; i < m_SubmeshDraws.size(); i++)
+		{
+			transforms[i] = m_SubmeshDraws[i].transform;
+		}
+		m_SubmeshBounds.resize(m_SubmeshDraws.size());
+		Math::TransformBoundingBoxes(local_bounds.data(), transforms.data(), m_SubmeshBounds.data(), m_SubmeshDraws.size());
+
+		Math::Frustum camera_frustum = Math::Frustum::FromMatrix(m_CurrentCamera->GetProjection() * m_CurrentCamera->GetView());
+		CullSubmeshes({ &camera_frustum, 1 }, m_VisibleSubmeshes);
+		m_Stats.culled_submeshes += (int)(m_SubmeshDraws.size() - m_VisibleSubmeshes.size());
+
+		for (uint32_t index : m_VisibleSubmeshes)
+		{
+			const SubmeshDraw& draw = m_SubmeshDraws[index];
+			SubmeshLOD lod = draw.mesh->GetMeshSource()->GetSubmeshes()[draw.submesh_index].GetLOD(draw.mesh->GetLOD());
+			m_Stats.vertices_count += lod.VertexCount;
+			m_Stats.index_count += lod.IndexCount;
+		}
+
+		// Every visible submesh is drawn by the depth and the shading pass, any submesh by the shadow pass
+		m_InstanceTransforms.clear();
+		uint32_t max_instances = (uint32_t)(2 * m_VisibleSubmeshes.size() + m_SubmeshDraws.size());
+		if (max_instances > m_InstanceCapacity)
+		{
+			m_InstanceCapacity = std::max(max_instances, m_InstanceCapacity * 2);
+			m_InstanceSSBO = CreateRef<ShaderStorageBuffer>(m_InstanceCapacity * (uint32_t)sizeof(glm::mat4), 3);
+		}
+
+		BuildCameraQueues();
+	}
+
+	void Renderer::BuildCameraQueues()
+	{
+		HVE_PROFILE_FUNC();
+		m_DepthQueue.Clear();
+		m_OpaqueQueue.Clear();
+		m_MaterialKeys.clear();
+		const glm::mat4& view = m_CurrentCamera->GetView();
+		for (uint32_t index : m_VisibleSubmeshes)
+		{
+			const SubmeshDraw& draw = m_SubmeshDraws[index];
+			const Submesh& submesh = draw.mesh->GetMeshSource()->GetSubmeshes()[draw.submesh_index];
+			Material* material = draw.mesh->GetMeshSource()->GetMaterials()[submesh.MaterialIndex].get();
+			uint32_t material_key = m_MaterialKeys.try_emplace(material, (uint32_t)m_MaterialKeys.size()).first->second;
+			uint32_t vertex_array = submesh.VertexArray->GetRendererID();
+
+			// View space looks down -z
+			float depth = -(view * glm::vec4(m_SubmeshBounds[index].GetCenter(), 1.0f)).z;
+			m_DepthQueue.Push(RenderQueue::MakeDepthKey(RenderPass::Depth, depth, vertex_array), index);
+			m_OpaqueQueue.Push(RenderQueue::MakeOpaqueKey(RenderPass::Opaque, material->GetProgram()->GetProgram(), material_key, vertex_array, depth), index);
+		}
+		m_DepthQueue.Sort();
+		m_OpaqueQueue.Sort();
+	}
+
+	void Renderer::BuildShadowQueue(const glm::vec3& light_direction)
+	{
+		HVE_PROFILE_FUNC();
+		m_ShadowQueue.Clear();
+		if (m_ShadowSubmeshes.empty())
+		{
+			return;
+		}
+
+		// Distance along the light's direction, measured from the caster closest to the light
+		glm::vec3 direction = glm::normalize(light_direction);
+		float nearest = FLT_MAX;
+		for (uint32_t index : m_ShadowSubmeshes)
+		{
+			nearest = std::min(nearest, glm::dot(m_SubmeshBounds[index].GetCenter(), direction));
+		}
+		for (uint32_t index : m_ShadowSubmeshes)
+		{
+			const SubmeshDraw& draw = m_SubmeshDraws[index];
+			uint32_t vertex_array = draw.mesh->GetMeshSource()->GetSubmeshes()[draw.submesh_index].VertexArray->GetRendererID();
+			float depth = glm::dot(m_SubmeshBounds[index].GetCenter(), direction) - nearest;
+			m_ShadowQueue.Push(RenderQueue::MakeDepthKey(RenderPass::Shadow, depth, vertex_array), index);
+		}
+		m_ShadowQueue.Sort();
+	}
+
+	void Renderer::CullSubmeshes(std::span<const Math::Frustum> frusta, std::vector<uint32_t>& visible)
+	{
+		HVE_PROFILE_FUNC();
+		visible.clear();
+		for (uint32_t i = 0; i < m_SubmeshBounds.size(); i++)
+		{
+			for (const Math::Frustum& frustum : frusta)
+			{
+				if (frustum.IntersectsAABB(m_SubmeshBounds[i]))
 				{
-					glEnable(GL_NORMALIZE);
+					visible.push_back(i);
+					break;
 				}
-				material->ApplyMaterial();
 			}
+		}
+	}
 
-			auto current_shader = m_ShaderLibrary.GetByShaderID(m_RendererAPI.GetCurrentShaderProgram());
-			current_shader->Set("u_Transform", mesh->GetTransform() * mesh->GetMeshSource()->GetSubmeshes()[i].WorldTransform);
-			current_shader->Activate();
+	void Renderer::BuildBatches(const RenderQueue& queue, bool by_material, std::vector<DrawBatch>& batches)
+	{
+		HVE_PROFILE_FUNC();
+		struct BatchKey
+		{
+			const VertexArray* vertex_array;
+			uint32_t index_offset;
+			const Material* material;
 
-			m_RendererAPI.DrawIndexed(mesh->GetMeshSource()->GetSubmeshes()[i].VertexArray);
-			m_Stats.draw_calls++;
+			bool operator==(const BatchKey& other) const = default;
+		};
+		struct BatchKeyHash
+		{
+			size_t operator()(const BatchKey& key) const
+			{
+				return std::hash<const void*>()(key.vertex_array) ^ ((size_t)key.index_offset << 1) ^ (std::hash<const void*>()(key.material) << 3);
+			}
+		};
+
+		batches.clear();
+		const std::vector<DrawPacket>& packets = queue.GetPackets();
+		if (packets.empty())
+		{
+			return;
+		}
+
+		std::unordered_map<BatchKey, uint32_t, BatchKeyHash> lookup;
+		std::vector<uint32_t> packet_batches(packets.size());
+		for (size_t i = 0; i < packets.size(); i++)
+		{
+			const SubmeshDraw& draw = m_SubmeshDraws[packets[i].DrawIndex];
+			const Submesh& submesh = draw.mesh->GetMeshSource()->GetSubmeshes()[draw.submesh_index];
+			SubmeshLOD lod = submesh.GetLOD(draw.mesh->GetLOD());
+			const Material* material = by_material ? draw.mesh->GetMeshSource()->GetMaterials()[submesh.MaterialIndex].get() : nullptr;
+
+			auto [it, inserted] = lookup.try_emplace({ submesh.VertexArray.get(), lod.IndexOffset, material }, (uint32_t)batches.size());
+			if (inserted)
+			{
+				batches.push_back({ packets[i].DrawIndex, lod, 0, 0 });
+			}
+			batches[it->second].instance_count++;
+			packet_batches[i] = it->second;
+		}
+
+		// Every pass appends to the frame's instance buffer, earlier passes may still be reading their part of it
+		uint32_t first_instance = (uint32_t)m_InstanceTransforms.size();
+		uint32_t next_instance = first_instance;
+		for (DrawBatch& batch : batches)
+		{
+			batch.first_instance = next_instance;
+			next_instance += batch.instance_count;
+			batch.instance_count = 0;
+		}
+		m_InstanceTransforms.resize(next_instance);
+		for (size_t i = 0; i < packets.size(); i++)
+		{
+			DrawBatch& batch = batches[packet_batches[i]];
+			m_InstanceTransforms[batch.first_instance + batch.instance_count++] = m_SubmeshDraws[packets[i].DrawIndex].transform;
+		}
+
+		HVE_CORE_ASSERT(next_instance <= m_InstanceCapacity, "Instance buffer was sized for fewer draws");
+		m_InstanceSSBO->Bind();
+		m_InstanceSSBO->SetData(m_InstanceTransforms.data() + first_instance, (next_instance - first_instance) * sizeof(glm::mat4), first_instance * sizeof(glm::mat4));
+	}
+
+	void Renderer::DrawInstances(const DrawBatch& batch, bool use_material)
+	{
+		const SubmeshDraw& draw = m_SubmeshDraws[batch.draw_index];
+		Mesh* mesh = draw.mesh;
+		const Submesh& submesh = mesh->GetMeshSource()->GetSubmeshes()[draw.submesh_index];
+		Ref<Material> material = mesh->GetMeshSource()->GetMaterials()[submesh.MaterialIndex];
+		if (use_material)
+		{
+			/*m_RendererAPI.BindTexture(m_SunShadowBuffer->GetDepthAttachmentID(), 13);
+			material->Set("u_CascadeCount", (int)m_Settings.ShadowSettings.ShadowCascadeLevels.size());
+			for (size_t i = 0; i < m_Settings.ShadowSettings.ShadowCascadeLevels.size(); ++i)
+			{
+				material->Set("u_CascadePlaneDistances[" + std::to_string(i) + "]", m_Settings.ShadowSettings.ShadowCascadeLevels[i]);
+			}*/
+			if (!material->GetUniformValue<int>("u_UseNormalMap"))
+			{
+				glEnable(GL_NORMALIZE);
+			}
+			material->ApplyMaterial();
+		}
+
+		m_RendererAPI.DrawIndexedInstanced(submesh.VertexArray, batch.lod.IndexCount, batch.lod.IndexOffset, batch.instance_count, batch.first_instance);
+		m_Stats.draw_calls++;
+		if (batch.instance_count > 1)
+		{
+			m_Stats.instanced_draw_calls++;
+			m_Stats.instances_count += batch.instance_count;
 		}
 	}
 
@@ -633,7 +847,12 @@ namespace Engine
 
 	void Renderer::BeginDrawing()
 	{
+		CullSubmeshes();
+		UploadViewUniforms();
 		DepthPrePass();
+		// After the shadow pass, which places the sun
+		UploadFrameUniforms();
+		MaterialBuffer::Flush();
 		UploadLightData();
 		CullLights();
 
@@ -896,8 +1115,6 @@ namespace Engine
 		}
 
 		Ref<ShaderProgram> shader = m_ShaderLibrary.Get("line_shader");
-		shader->Set("u_CameraView", m_CurrentCamera->GetView());
-		shader->Set("u_CameraProjection", m_CurrentCamera->GetProjection());
 		shader->Activate();
 		m_RendererAPI.DrawInstancedLines(m_DebugLines);
 		m_Stats.draw_calls++;
@@ -931,5 +1148,10 @@ namespace Engine
 		m_Stats.vertices_count = 0;
 		m_Stats.draw_calls = 0;
 		m_Stats.index_count = 0;
+		m_Stats.instanced_draw_calls = 0;
+		m_Stats.instances_count = 0;
+		m_Stats.culled_submeshes = 0;
+		m_Stats.shadow_culled_submeshes = 0;
+		m_Stats.lod_mesh_count.fill(0);
 	}
 }
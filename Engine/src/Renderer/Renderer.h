@@ -1,4 +1,5 @@
 #pragma once
+#include <span>
 #include "Camera.h"
 #include <glad/gl.h>
 #include "ShaderProgram.h"
@@ -11,6 +12,7 @@
 #include "UniformBuffer.h"
 #include "Framebuffer.h"
 #include "Shader.h"
+#include "RenderQueue.h"
 
 namespace Engine
 {
@@ -145,10 +147,43 @@ namespace Engine
 		glm::vec4 direction;
 	};
 
+	// std140 layout of the FrameData block at uniform binding 1, scene constants uploaded once per frame
+	struct FrameUniforms {
+		glm::mat4 sun_view;
+		glm::mat4 sun_projection;
+		float environment_brightness;
+		int num_directional_lights;
+		float padding[2];
+	};
+
+	// std140 layout of the ViewData block at uniform binding 2, uploaded once per camera the frame is drawn from
+	struct ViewUniforms {
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 position;
+		float far_plane;
+	};
+
 	struct VisibleIndex {
 		int index;
 	};
 
+	// One submesh of a submitted mesh, the unit the renderer culls and draws
+	struct SubmeshDraw {
+		Mesh* mesh;
+		uint32_t submesh_index;
+		glm::mat4 transform;
+	};
+
+	// Instances of one submesh at one level of detail, drawn with a single instanced call. Their transforms are
+	// consecutive in the instance buffer from first_instance on.
+	struct DrawBatch {
+		uint32_t draw_index;
+		SubmeshLOD lod;
+		uint32_t first_instance;
+		uint32_t instance_count;
+	};
+
 	struct TextureInfo {
 		GLuint texture;
 		int height;
@@ -165,6 +200,14 @@ namespace Engine
 		int draw_calls = 0;
 		int vertices_count = 0;
 		int index_count = 0;
+		// Draw calls with more than one instance, and the instances they drew
+		int instanced_draw_calls = 0;
+		int instances_count = 0;
+		// Submeshes left out of the camera passes and of the shadow pass by frustum culling
+		int culled_submeshes = 0;
+		int shadow_culled_submeshes = 0;
+		// Meshes submitted at each level of detail
+		std::array<int, MeshSource::MaxLODs> lod_mesh_count = {};
 
 		void UpdateFPS(double currentTime, double frameTime) {
 			frame_time_accumulator += frameTime;
@@ -197,7 +240,6 @@ namespace Engine
 		void SubmitDebugCapsule(DebugCapsule capsule);
 
 		void BeginFrame(Camera* camera);
-		void DrawIndexed(Ref<Mesh> mesh, bool use_material);
 
 
 		static Ref<Texture2D> GetWhiteTexture();
@@ -244,6 +286,19 @@ namespace Engine
 
 	private:
 
+		// Splits the submitted meshes into submeshes and keeps the ones inside the camera frustum
+		void CullSubmeshes();
+		// Submeshes inside any of the frusta, indices into m_SubmeshDraws
+		void CullSubmeshes(std::span<const Math::Frustum> frusta, std::vector<uint32_t>& visible);
+		// Fills and sorts the depth and opaque queues from m_VisibleSubmeshes
+		void BuildCameraQueues();
+		void BuildShadowQueue(const glm::vec3& light_direction);
+		// Merges the queue's draws of the same submesh and level, and of the same material when by_material is set,
+		// into batches and uploads their transforms. Batches keep the order of their first draw in the queue.
+		void BuildBatches(const RenderQueue& queue, bool by_material, std::vector<DrawBatch>& batches);
+		void DrawInstances(const DrawBatch& batch, bool use_material);
+		void UploadFrameUniforms();
+		void UploadViewUniforms();
 		void DepthPrePass();
 		void CullLights();
 		void ShadeAllObjects();
@@ -278,6 +333,8 @@ namespace Engine
 		Ref<ShaderStorageBuffer> m_VisibleLightsSSBO = nullptr;
 
 		Ref<UniformBuffer> m_LightMatricesBuffer = nullptr;
+		Ref<UniformBuffer> m_FrameUniformBuffer = nullptr;
+		Ref<UniformBuffer> m_ViewUniformBuffer = nullptr;
 
 		Ref<Framebuffer> m_SunShadowBuffer = nullptr;
 		Ref<Framebuffer> m_BRDFBuffer = nullptr;
@@ -292,6 +349,21 @@ namespace Engine
 		float current_window_width, current_window_height;
 
 		std::vector<Ref<Mesh>> m_Meshes{};
+		std::vector<SubmeshDraw> m_SubmeshDraws{};
+		std::vector<Math::BoundingBox> m_SubmeshBounds{};
+		// Shared by the depth pre-pass and the shading pass
+		std::vector<uint32_t> m_VisibleSubmeshes{};
+		std::vector<uint32_t> m_ShadowSubmeshes{};
+		RenderQueue m_DepthQueue{};
+		RenderQueue m_ShadowQueue{};
+		RenderQueue m_OpaqueQueue{};
+		std::vector<DrawBatch> m_Batches{};
+		// Per instance transforms of every pass this frame, read by the vertex shaders from binding 3
+		std::vector<glm::mat4> m_InstanceTransforms{};
+		Ref<ShaderStorageBuffer> m_InstanceSSBO = nullptr;
+		uint32_t m_InstanceCapacity = 0;
+		// Small per frame ids for the materials in the opaque queue keys
+		std::unordered_map<const Material*, uint32_t> m_MaterialKeys{};
 		std::vector<PointLight*> m_PointLights{};
 		std::vector<DirectionalLight*> m_DirectionalLights{};
 
@@ -202,11 +202,18 @@ namespace Engine {
 		glDepthFunc(Util::HeliosToNativeDepthFunction(func));
 	}
 
-	void RendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+	void RendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t firstIndex)
 	{
 		vertexArray->Bind();
 		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(uint32_t)));
+		vertexArray->Unbind();
+	}
+
+	void RendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t firstIndex, uint32_t instanceCount, uint32_t baseInstance)
+	{
+		vertexArray->Bind();
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(uint32_t)), instanceCount, baseInstance);
 		vertexArray->Unbind();
 	}
 
@@ -75,7 +75,9 @@ namespace Engine {
 
 		void SetDepthFunction(DepthFunction func);
 
-		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0);
+		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t firstIndex = 0);
+		// gl_BaseInstance is baseInstance in the shader, so instances can index a shared buffer
+		void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t firstIndex, uint32_t instanceCount, uint32_t baseInstance);
 		void DrawInstancedLines(std::vector<Line>& lines);
 		void DrawLine(const glm::vec3& start, const glm::vec3& end);
 		void DrawQuad();
@@ -42,6 +42,51 @@ namespace Engine {
             HVE_CORE_ERROR("Shader Linking Error: {0}, Perpetrator: {1}", infoLog, path);
             return;
         }
+
+		ReflectUniforms();
+	}
+
+	void ShaderProgram::ReflectUniforms()
+	{
+		GLint uniform_count = 0, max_name_length = 0;
+		glGetProgramiv(m_ShaderProgram, GL_ACTIVE_UNIFORMS, &uniform_count);
+		glGetProgramiv(m_ShaderProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+		std::string name(std::max(max_name_length, 1), '\0');
+		for (GLint i = 0; i < uniform_count; i++)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_ShaderProgram, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+			std::string uniform_name(name.data(), length);
+
+			// Members of uniform blocks have no location of their own
+			GLint location = glGetUniformLocation(m_ShaderProgram, uniform_name.c_str());
+			if (location < 0)
+			{
+				continue;
+			}
+			m_UniformLocations[uniform_name] = location;
+
+			// Arrays are reported as "name[0]", they can be set through "name" and through every element
+			if (uniform_name.ends_with("[0]"))
+			{
+				std::string base_name = uniform_name.substr(0, uniform_name.size() - 3);
+				m_UniformLocations[base_name] = location;
+				for (GLint element = 1; element < size; element++)
+				{
+					std::string element_name = base_name + "[" + std::to_string(element) + "]";
+					m_UniformLocations[element_name] = glGetUniformLocation(m_ShaderProgram, element_name.c_str());
+				}
+			}
+		}
+	}
+
+	GLint ShaderProgram::GetUniformLocation(std::string_view name) const
+	{
+		auto it = m_UniformLocations.find(name);
+		return it != m_UniformLocations.end() ? it->second : -1;
 	}
 
     ShaderProgram::~ShaderProgram()
@@ -60,94 +105,133 @@ namespace Engine {
 
 	void ShaderProgram::Set(const std::string& name, float value)
 	{
-		Activate();
-		glUniform1f(glGetUniformLocation(m_ShaderProgram, name.c_str()), value);
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, int value)
 	{
-		Activate();
-		glUniform1i(glGetUniformLocation(m_ShaderProgram, name.c_str()), value);
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, uint32_t value)
 	{
-		Activate();
-		glUniform1ui(glGetUniformLocation(m_ShaderProgram, name.c_str()), value);
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, bool value)
 	{
-		Activate();
-		glUniform1i(glGetUniformLocation(m_ShaderProgram, name.c_str()), (int)value);
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::ivec2& value)
 	{
-		Activate();
-		glUniform2iv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::ivec3& value)
 	{
-		Activate();
-		glUniform3iv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::ivec4& value)
 	{
-		Activate();
-		glUniform4iv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::vec2& value)
 	{
-		Activate();
-		glUniform2fv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::vec3& value)
 	{
-		Activate();
-		glUniform3fv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::vec4& value)
 	{
-		Activate();
-		glUniform4fv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::mat3& value)
 	{
-		Activate();
-		glUniformMatrix3fv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const glm::mat4& value)
 	{
-		Activate();
-		glUniformMatrix4fv(glGetUniformLocation(m_ShaderProgram, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
-		Deactivate();
+		Set(GetUniformLocation(name), value);
 	}
 
 	void ShaderProgram::Set(const std::string& name, const Ref<Texture2D>& texture, uint32_t slot)
 	{
-		Activate();
+		Set(GetUniformLocation(name), texture, slot);
+	}
+
+	void ShaderProgram::Set(GLint location, float value)
+	{
+		glProgramUniform1f(m_ShaderProgram, location, value);
+	}
+
+	void ShaderProgram::Set(GLint location, int value)
+	{
+		glProgramUniform1i(m_ShaderProgram, location, value);
+	}
+
+	void ShaderProgram::Set(GLint location, uint32_t value)
+	{
+		glProgramUniform1ui(m_ShaderProgram, location, value);
+	}
+
+	void ShaderProgram::Set(GLint location, bool value)
+	{
+		glProgramUniform1i(m_ShaderProgram, location, (int)value);
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::ivec2& value)
+	{
+		glProgramUniform2iv(m_ShaderProgram, location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::ivec3& value)
+	{
+		glProgramUniform3iv(m_ShaderProgram, location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::ivec4& value)
+	{
+		glProgramUniform4iv(m_ShaderProgram, location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::vec2& value)
+	{
+		glProgramUniform2fv(m_ShaderProgram, location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::vec3& value)
+	{
+		glProgramUniform3fv(m_ShaderProgram, location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::vec4& value)
+	{
+		glProgramUniform4fv(m_ShaderProgram, location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::mat3& value)
+	{
+		glProgramUniformMatrix3fv(m_ShaderProgram, location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const glm::mat4& value)
+	{
+		glProgramUniformMatrix4fv(m_ShaderProgram, location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::Set(GLint location, const Ref<Texture2D>& texture, uint32_t slot)
+	{
 		texture->Bind(slot);
-		glUniform1i(glGetUniformLocation(m_ShaderProgram, name.c_str()), slot);
-		Deactivate();
+		glProgramUniform1i(m_ShaderProgram, location, slot);
 	}
 
 	ShaderLibrary::ShaderLibrary()
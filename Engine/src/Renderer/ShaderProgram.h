@@ -16,6 +16,12 @@ namespace Engine {
 
 		void Activate();
 		void Deactivate();
+
+		// Location of an active uniform, -1 when the program has none of that name. Setting location -1 does
+		// nothing, as in GL. Hot code resolves its locations once and uses the location overloads of Set.
+		GLint GetUniformLocation(std::string_view name) const;
+
+		// Uniforms are written with glProgramUniform, the program does not need to be bound and the bound one is kept
 		void Set(const std::string& name, float value);
 		void Set(const std::string& name, int value);
 		void Set(const std::string& name, uint32_t value);
@@ -30,8 +36,34 @@ namespace Engine {
 		void Set(const std::string& name, const glm::mat4& value);
 		void Set(const std::string& name, const Ref<Texture2D>& texture, uint32_t slot);
 
+		void Set(GLint location, float value);
+		void Set(GLint location, int value);
+		void Set(GLint location, uint32_t value);
+		void Set(GLint location, bool value);
+		void Set(GLint location, const glm::ivec2& value);
+		void Set(GLint location, const glm::ivec3& value);
+		void Set(GLint location, const glm::ivec4& value);
+		void Set(GLint location, const glm::vec2& value);
+		void Set(GLint location, const glm::vec3& value);
+		void Set(GLint location, const glm::vec4& value);
+		void Set(GLint location, const glm::mat3& value);
+		void Set(GLint location, const glm::mat4& value);
+		void Set(GLint location, const Ref<Texture2D>& texture, uint32_t slot);
+
 	private:
+		// Fills m_UniformLocations from the active uniforms of the linked program
+		void ReflectUniforms();
+
+	private:
+		struct StringHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+		};
+
 		GLuint m_ShaderProgram;
+		// Looked up by string_view, setting a uniform by name does not build a std::string
+		std::unordered_map<std::string, GLint, StringHash, std::equal_to<>> m_UniformLocations;
 		std::vector<Scope<Shader>> shaders{};
 	};
 
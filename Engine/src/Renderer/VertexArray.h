@@ -10,6 +10,8 @@ namespace Engine {
 		VertexArray();
 		~VertexArray();
 
+		uint32_t GetRendererID() const { return m_RendererID; }
+
 		void Bind() const;
 		void Unbind() const;
 
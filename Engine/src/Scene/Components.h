@@ -1,11 +1,13 @@
 #pragma once
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include "Math/SIMD.h"
 #include "Renderer/Camera.h"
 #include "Renderer/Material.h"
 #include "Renderer/Mesh.h"
 #include "Lights/PointLight.h"
 #include "Lights/DirectionalLight.h"
+#include "Registry.h"
 #include <Script/ScriptEngine.h>
 #include <Physics/Auxiliary/HEMotionType.h>
 #include <Sound/GlobalSource.h>
@@ -41,53 +43,101 @@ namespace Engine {
 
 	struct LocalTransformComponent  {
 		glm::vec3 translation = { 0.0f, 0.0f, 0.0f };
-		glm::vec3 rotation = { 0.0f, 0.0f, 0.0f };
+		glm::quat rotation = glm::identity<glm::quat>();
 		glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
+		// Euler angles as last set, so the inspector does not jump between equivalent angles. Only the quaternion is used for maths.
+		glm::vec3 rotation_euler = { 0.0f, 0.0f, 0.0f };
+
+		// Cached T * R * S, rebuilt by the transform pass whenever the component has changed
+		glm::mat4 matrix = glm::mat4(1.0f);
 
 		LocalTransformComponent() = default;
 		LocalTransformComponent(const LocalTransformComponent&) = default;
-		LocalTransformComponent(const glm::vec3& new_translation) : translation(new_translation) {}
+		LocalTransformComponent(const glm::vec3& new_translation) : translation(new_translation) { UpdateMatrix(); }
 
-		glm::mat4 mat4() {
-			glm::mat4 Rotation = glm::toMat4(glm::quat(rotation));
+		void SetRotationEuler(const glm::vec3& euler) {
+			rotation_euler = euler;
+			rotation = glm::quat(euler);
+		}
 
-			return glm::translate(glm::mat4(1.0f), translation)
-				* Rotation
-				* glm::scale(glm::mat4(1.0f), scale);
+		void SetRotation(const glm::quat& new_rotation) {
+			rotation = new_rotation;
+			rotation_euler = glm::eulerAngles(new_rotation);
 		}
 
-		glm::quat RotationVecToQuat()
-		{
-			return glm::quat(rotation);
+		glm::mat4 mat4() const {
+			return Math::ComposeTransform(translation, rotation, scale);
 		}
+
+		void UpdateMatrix() { matrix = mat4(); }
 	};
 
+	// Written by the transform pass and by physics. Below a parent, rotation and scale are read back from the matrix,
+	// so they always describe what the renderer draws.
 	struct WorldTransformComponent  {
 		glm::vec3 translation = { 0.0f, 0.0f, 0.0f };
-		glm::vec3 rotation = { 0.0f, 0.0f, 0.0f };
+		glm::quat rotation = glm::identity<glm::quat>();
 		glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
 
+		// What the renderer draws with
+		glm::mat4 matrix = glm::mat4(1.0f);
+
 		WorldTransformComponent() = default;
 		WorldTransformComponent(const WorldTransformComponent&) = default;
-		WorldTransformComponent(const glm::vec3& new_translation) : translation(new_translation) {}
+		WorldTransformComponent(const glm::vec3& new_translation) : translation(new_translation) { UpdateMatrix(); }
 
-		glm::mat4 mat4() {
-			glm::mat4 Rotation = glm::toMat4(glm::quat(rotation));
+		glm::vec3 GetRotationEuler() const { return glm::eulerAngles(rotation); }
 
-			return glm::translate(glm::mat4(1.0f), translation)
-				* Rotation
-				* glm::scale(glm::mat4(1.0f), scale);
+		glm::mat4 mat4() const {
+			return Math::ComposeTransform(translation, rotation, scale);
 		}
 
-		glm::quat RotationVecToQuat()
-		{
-			return glm::quat(rotation);
+		void UpdateMatrix() { matrix = mat4(); }
+
+		// The inverse of UpdateMatrix. Scale is the length of each basis vector and rotation that of the normalized basis,
+		// which is the closest fit when a non uniformly scaled parent shears a rotated child.
+		void DecomposeMatrix() {
+			glm::mat3 basis(matrix);
+			translation = glm::vec3(matrix[3]);
+			scale = { glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]) };
+			// A mirrored basis is a rotation with one axis scaled by -1
+			if (glm::determinant(basis) < 0.0f) {
+				scale.x = -scale.x;
+			}
+			for (int axis = 0; axis < 3; axis++) {
+				if (scale[axis] != 0.0f) {
+					basis[axis] /= scale[axis];
+				}
+			}
+			rotation = glm::normalize(glm::quat_cast(basis));
 		}
 	};
 
+	// Static entities are placed once. Their world matrix and bounds are computed when they are placed or edited and
+	// the transform pass, physics and mesh updates skip them afterwards. A static entity under a dynamic parent moves
+	// with it and is treated as dynamic.
+	enum class Mobility : uint8_t
+	{
+		Dynamic,
+		Static
+	};
+
+	inline const char* MobilityToString(Mobility mobility)
+	{
+		return mobility == Mobility::Static ? "Static" : "Dynamic";
+	}
+
+	inline Mobility MobilityFromString(const std::string& mobility)
+	{
+		return mobility == "Static" ? Mobility::Static : Mobility::Dynamic;
+	}
+
 	struct TransformComponent  {
 		WorldTransformComponent world_transform{};
 		LocalTransformComponent local_transform{};
+		Mobility mobility = Mobility::Dynamic;
+
+		bool IsStatic() const { return mobility == Mobility::Static; }
 
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent&) = default;
@@ -96,6 +146,12 @@ namespace Engine {
 
 	struct MeshComponent  {
 		Ref<Mesh> mesh = CreateRef<Mesh>(nullptr);
+		// Bounds of the whole mesh in world space, updated together with the mesh transform
+		Math::BoundingBox world_bounds;
+		// Scales the screen size the level of detail is picked by, above 1 keeps the finer levels longer
+		float lod_bias = 1.0f;
+		// Level to draw regardless of screen size, -1 picks it automatically
+		int forced_lod = -1;
 
 		MeshComponent() = default;
 		MeshComponent(const MeshComponent&) = default;
@@ -221,6 +277,16 @@ namespace Engine {
 	{
 	};
 
+	template<typename T, typename Group>
+	struct ComponentGroupIndex;
+
+	template<typename T, typename... Rest>
+	struct ComponentGroupIndex<T, ComponentGroup<T, Rest...>> : std::integral_constant<uint32_t, 0> {};
+
+	template<typename T, typename First, typename... Rest>
+	struct ComponentGroupIndex<T, ComponentGroup<First, Rest...>>
+		: std::integral_constant<uint32_t, 1 + ComponentGroupIndex<T, ComponentGroup<Rest...>>::value> {};
+
 	using AllComponents =
 		ComponentGroup< IDComponent, ParentIDComponent, TagComponent,
 		TransformComponent, MeshComponent, CameraComponent,
@@ -228,4 +294,16 @@ namespace Engine {
 		GlobalSoundsComponent, LocalSoundsComponent, ScriptComponent,
 		SphereColliderComponent, BoxColliderComponent, CharacterControllerComponent >;
 
+	template<typename... Component>
+	constexpr size_t ComponentGroupSize(ComponentGroup<Component...>) { return sizeof...(Component); }
+
+	static_assert(ComponentGroupSize(AllComponents{}) <= MaxComponentTypes, "Raise MaxComponentTypes in Registry.h");
+
+	// Every registry pool lookup goes through this, only types listed in AllComponents can be stored
+	template<typename T>
+	struct ComponentTypeID
+	{
+		static constexpr uint32_t Value = ComponentGroupIndex<std::remove_cvref_t<T>, AllComponents>::value;
+	};
+
 }
@@ -1,5 +1,12 @@
 #include "pch.h"
 #include "Entity.h"
+#include "Components.h"
 
 namespace Engine {
+
+	UUID Entity::GetUUID()
+	{
+		auto id_component = GetComponent<IDComponent>();
+		return id_component ? id_component->id : UUID(0);
+	}
 }
\ No newline at end of file
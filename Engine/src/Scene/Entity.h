@@ -1,38 +1,35 @@
 #pragma once
 
 #include "Scene.h"
-#include "EntityHandle.h"
 
 namespace Engine {
 
+	// Value handle, an EntityId plus the scene that owns it. Copying one is two words and
+	// components are always looked up through the scene's registry, so nothing is cached here.
 	class Entity {
 	public:
-		Entity() : m_Scene(nullptr) {}
-		Entity(Scene* scene_ptr) :  m_Scene(scene_ptr) {
-			m_Handle = EntityHandle(UUID());
-		}
-		Entity(UUID id, Scene* scene_ptr) : m_Handle(EntityHandle(id)), m_Scene(scene_ptr) {}
-		~Entity() = default;
+		Entity() = default;
+		Entity(EntityId id, Scene* scene_ptr) : m_ID(id), m_Scene(scene_ptr) {}
 
 
 		template<typename Type>
 		void AddComponent(Type component) {
 			if (m_Scene != nullptr) {
-				m_Scene->GetRegistry()->Add<Type>(m_Handle.GetID(), component);
+				m_Scene->GetRegistry()->Add<Type>(m_ID, component);
 			}
 		}
 
 		template<typename Type>
 		void RemoveComponent() {
 			if (m_Scene != nullptr) {
-				m_Scene->GetRegistry()->Remove<Type>(m_Handle.GetID());
+				m_Scene->GetRegistry()->Remove<Type>(m_ID);
 			}
 		}
 
 		template<typename Type>
 		Type* GetComponent() {
 			if (m_Scene != nullptr) {
-				return m_Scene->GetRegistry()->Get<Type>(m_Handle.GetID());
+				return m_Scene->GetRegistry()->Get<Type>(m_ID);
 			}
 			return nullptr;
 		}
@@ -40,19 +37,27 @@ namespace Engine {
 		template<typename Type>
 		bool HasComponent() {
 			if (m_Scene != nullptr) {
-				return m_Scene->GetRegistry()->Get<Type>(m_Handle.GetID()) != nullptr ? true : false;
+				return m_Scene->GetRegistry()->Has<Type>(m_ID);
 			}
 			return false;
 		}
 
-		void ChangeScene(Scene* scene) { m_Scene = scene; }
+		// False for default constructed handles and for entities that have since been destroyed
+		bool IsValid() const { return m_Scene != nullptr && m_Scene->GetRegistry()->IsValid(m_ID); }
+		explicit operator bool() const { return IsValid(); }
 
-		UUID& GetID() { return m_Handle.GetID(); }
-		EntityHandle* GetHandle() { return &m_Handle; }
+		EntityId GetID() const { return m_ID; }
+		// Persistent id, only needed when saving or when matching entities across scenes
+		UUID GetUUID();
+		Scene* GetScene() const { return m_Scene; }
 
-	private:
-		EntityHandle m_Handle;
+		bool operator==(const Entity& other) const { return m_ID == other.m_ID && m_Scene == other.m_Scene; }
+		bool operator!=(const Entity& other) const { return !(*this == other); }
 
-		Scene* m_Scene;
+	private:
+		EntityId m_ID;
+		Scene* m_Scene = nullptr;
 	};
+
+	static_assert(std::is_trivially_copyable_v<Entity>, "Entity is passed around by value and must stay trivially copyable");
 }
@@ -0,0 +1,58 @@
+#include "pch.h"
+#include "EntityCommandBuffer.h"
+#include "Scene.h"
+#include "Entity.h"
+
+namespace Engine {
+
+	EntityCommandBuffer::PendingEntity EntityCommandBuffer::CreateEntity(std::string name, EntityId parent)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		PendingEntity pending{ m_PendingCount++ };
+		m_Commands.push_back([name = std::move(name), parent](Scene& scene, Registry&, std::vector<EntityId>& created) {
+			created.push_back(scene.CreateEntity(name, parent).GetID());
+		});
+		return pending;
+	}
+
+	void EntityCommandBuffer::DestroyEntity(EntityId entity_id)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Destroyed.push_back(entity_id);
+	}
+
+	bool EntityCommandBuffer::Empty()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Commands.empty() && m_Destroyed.empty();
+	}
+
+	void EntityCommandBuffer::Record(Command command)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Commands.push_back(std::move(command));
+	}
+
+	std::vector<EntityId> EntityCommandBuffer::Execute(Scene& scene)
+	{
+		std::vector<Command> commands;
+		std::vector<EntityId> destroyed;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			commands.swap(m_Commands);
+			destroyed.swap(m_Destroyed);
+			m_PendingCount = 0;
+		}
+
+		std::vector<EntityId> created;
+		for (auto& command : commands)
+		{
+			command(scene, *scene.GetRegistry(), created);
+		}
+
+		// The same entity may have been destroyed by several scripts in one frame
+		std::sort(destroyed.begin(), destroyed.end());
+		destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+		return destroyed;
+	}
+}
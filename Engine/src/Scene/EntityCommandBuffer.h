@@ -0,0 +1,65 @@
+#pragma once
+#include <mutex>
+#include "Registry.h"
+
+namespace Engine {
+
+	class Scene;
+
+	// Structural changes recorded while systems are running and applied by Scene::FlushCommands, so no
+	// component pool is resized underneath a view. Recording is thread safe.
+	class EntityCommandBuffer
+	{
+	public:
+		// Refers to an entity created by this buffer that does not exist until the next flush, and is
+		// only meaningful for commands recorded before that flush
+		struct PendingEntity
+		{
+			uint32_t Index;
+		};
+
+		PendingEntity CreateEntity(std::string name, EntityId parent = EntityId());
+		void DestroyEntity(EntityId entity_id);
+
+		template<typename T>
+		void AddComponent(EntityId entity_id, T component)
+		{
+			Record([entity_id, component = std::move(component)](Scene&, Registry& registry, std::vector<EntityId>&) mutable {
+				registry.Add<T>(entity_id, std::move(component));
+			});
+		}
+
+		template<typename T>
+		void AddComponent(PendingEntity entity, T component)
+		{
+			Record([entity, component = std::move(component)](Scene&, Registry& registry, std::vector<EntityId>& created) mutable {
+				registry.Add<T>(created[entity.Index], std::move(component));
+			});
+		}
+
+		template<typename T>
+		void RemoveComponent(EntityId entity_id)
+		{
+			Record([entity_id](Scene&, Registry& registry, std::vector<EntityId>&) {
+				registry.Remove<T>(entity_id);
+			});
+		}
+
+		bool Empty();
+
+		// Runs every recorded command in order, except destroys, which are returned as one batch for the
+		// scene to notify its subsystems about before removing anything
+		std::vector<EntityId> Execute(Scene& scene);
+
+	private:
+		using Command = std::function<void(Scene&, Registry&, std::vector<EntityId>&)>;
+
+		void Record(Command command);
+
+	private:
+		std::mutex m_Mutex;
+		std::vector<Command> m_Commands;
+		std::vector<EntityId> m_Destroyed;
+		uint32_t m_PendingCount = 0;
+	};
+}
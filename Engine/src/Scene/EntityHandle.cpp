@@ -1,6 +0,0 @@
-#include "pch.h"
-#include "EntityHandle.h"
-
-namespace Engine {
-
-}
\ No newline at end of file
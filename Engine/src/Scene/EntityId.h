@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <functional>
+
+namespace Engine {
+
+	// Runtime handle of an entity. Index addresses the registry's arrays directly, Generation is bumped
+	// every time an index is recycled so stale handles can be detected with a single compare.
+	// UUIDs are only used to identify entities across saves, see Scene::GetEntityByUUID.
+	struct EntityId
+	{
+		static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+		uint32_t Index = InvalidIndex;
+		uint32_t Generation = 0;
+
+		constexpr EntityId() = default;
+		constexpr EntityId(uint32_t index, uint32_t generation) : Index(index), Generation(generation) {}
+
+		constexpr bool IsValid() const { return Index != InvalidIndex; }
+
+		// Packed form handed to scripts and stored in physics body user data
+		constexpr uint64_t Pack() const { return ((uint64_t)Generation << 32) | Index; }
+		static constexpr EntityId Unpack(uint64_t packed) { return EntityId((uint32_t)(packed & 0xFFFFFFFF), (uint32_t)(packed >> 32)); }
+
+		constexpr bool operator==(const EntityId& other) const { return Index == other.Index && Generation == other.Generation; }
+		constexpr bool operator!=(const EntityId& other) const { return !(*this == other); }
+		constexpr bool operator<(const EntityId& other) const { return Pack() < other.Pack(); }
+	};
+}
+
+namespace std {
+
+	template <>
+	struct hash<Engine::EntityId>
+	{
+		std::size_t operator()(const Engine::EntityId& id) const
+		{
+			return hash<uint64_t>()(id.Pack());
+		}
+	};
+}
@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "Prefab.h"
+#include "Scene.h"
+#include "Entity.h"
+#include "SceneSerializer.h"
+
+namespace Engine {
+
+	Prefab::Prefab(Ref<Scene> scene)
+		: m_Scene(scene)
+	{
+		SceneHierarchy& hierarchy = m_Scene->GetHierarchy();
+		EntityId root = hierarchy.GetFirstChild(EntityId());
+		if (!root.IsValid())
+		{
+			HVE_CORE_WARN_TAG("Prefab", "Prefab {0} has no entities", m_Scene->GetName());
+			return;
+		}
+		if (hierarchy.GetChildCount(EntityId()) > 1)
+		{
+			HVE_CORE_WARN_TAG("Prefab", "Prefab {0} has more than one root entity, only the first one is used", m_Scene->GetName());
+		}
+		// Parents come first, so a child's parent already has its place in m_Entities when the child is reached
+		std::vector<uint32_t> positions(hierarchy.GetCapacity(), UINT32_MAX);
+		hierarchy.ForEachInSubtree(root, [&](EntityId entity)
+		{
+			positions[entity.Index] = (uint32_t)m_Entities.size();
+			m_ParentIndices.push_back(entity == root ? UINT32_MAX : positions[hierarchy.GetParentIndex(entity.Index)]);
+			m_Entities.push_back(entity);
+		});
+	}
+
+	Ref<Prefab> Prefab::LoadPrefab(AssetHandle handle, const AssetMetadata& metadata)
+	{
+		return SceneSerializer::DeserializePrefab(metadata.FilePath);
+	}
+
+	Ref<Prefab> Prefab::CreateFromEntity(Entity root)
+	{
+		return SceneSerializer::CopyToPrefab(root);
+	}
+
+	bool Prefab::SavePrefab(const std::filesystem::path& filepath)
+	{
+		if (m_Entities.empty())
+		{
+			return false;
+		}
+		SceneSerializer::SerializePrefab(filepath, Entity(GetRoot(), m_Scene.get()));
+		return true;
+	}
+}
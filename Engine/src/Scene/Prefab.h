@@ -1 +1,40 @@
 #pragma once
+#include "Assets/Asset.h"
+#include "Assets/AssetMetadata.h"
+#include "EntityId.h"
+
+namespace Engine {
+
+	class Scene;
+	class Entity;
+
+	// A saved entity subtree. The entities live in a scene of their own that is never updated, Scene::Instantiate
+	// copies them from there in bulk.
+	class Prefab : public Asset
+	{
+	public:
+		Prefab(Ref<Scene> scene);
+
+		static Ref<Prefab> LoadPrefab(AssetHandle handle, const AssetMetadata& metadata);
+		// Snapshots root and everything below it, the source scene is not modified
+		static Ref<Prefab> CreateFromEntity(Entity root);
+		bool SavePrefab(const std::filesystem::path& filepath);
+
+		Ref<Scene> GetScene() { return m_Scene; }
+		EntityId GetRoot() const { return m_Entities.empty() ? EntityId() : m_Entities[0]; }
+		uint32_t GetEntityCount() const { return (uint32_t)m_Entities.size(); }
+
+		static AssetType GetStaticType() { return AssetType::Prefab; } // Good for templated functions
+		AssetType GetType() const { return GetStaticType(); }
+
+	private:
+		Ref<Scene> m_Scene;
+
+		// Depth first, so m_Entities[0] is the root and every parent comes before its children.
+		// m_ParentIndices[i] points back into m_Entities and is unused for the root.
+		std::vector<EntityId> m_Entities;
+		std::vector<uint32_t> m_ParentIndices;
+
+		friend class Scene;
+	};
+}
@@ -1,93 +1,461 @@
-#include <unordered_map>
+#pragma once
+#include <vector>
+#include <span>
+#include <limits>
 #include <memory>
-#include <typeindex>
+#include <array>
+#include <tuple>
 #include <type_traits>
-#include "Core/UUID.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include "Core/Base.h"
 #include "Core/Log.h"
+#include "EntityId.h"
 
 namespace Engine {
 
+    // Dense per-type index into the registry's pool array, assigned from AllComponents in Components.h
+    template<typename T>
+    struct ComponentTypeID;
+
+    static constexpr size_t MaxComponentTypes = 32;
+
+    // Wrap safe "a is newer than b" for change ticks
+    inline bool IsNewerTick(uint32_t a, uint32_t b) { return (int32_t)(a - b) > 0; }
+
+    // Copies a packed array in one memcpy when the element type allows it
+    template<typename T>
+    void CopyPacked(const std::vector<T>& source, std::vector<T>& target) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            target.resize(source.size());
+            if (!source.empty()) {
+                std::memcpy(target.data(), source.data(), source.size() * sizeof(T));
+            }
+        }
+        else {
+            target = source;
+        }
+    }
+
+    // Sparse set bookkeeping shared by every pool. m_Sparse is indexed by EntityId::Index and points
+    // into the packed arrays, so lookups are two array loads and iteration is a linear walk.
     class IComponentContainer {
     public:
+        static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
         virtual ~IComponentContainer() = default;
-        virtual void Remove(UUID entityId) = 0;
+        virtual void Remove(uint32_t entityIndex) = 0;
+        // Same entities in the same slots, so the copy can be used with the registry's EntityIds unchanged
+        virtual Scope<IComponentContainer> Clone() const = 0;
+        virtual Scope<IComponentContainer> CreateEmpty() const = 0;
+        // Appends the components of the instanced entities to target, a pool of the same type, once per
+        // instance. localIndices maps an EntityId::Index of this pool to the entity's position in the
+        // instanced set, or InvalidIndex, and created holds localCount fresh entities per instance.
+        virtual void InstantiateInto(IComponentContainer& target, std::span<const uint32_t> localIndices,
+            std::span<const EntityId> created, uint32_t localCount, uint32_t tick) const = 0;
+
+        bool Contains(uint32_t entityIndex) const {
+            return entityIndex < m_Sparse.size() && m_Sparse[entityIndex] != InvalidIndex;
+        }
+
+        size_t Size() const { return m_Entities.size(); }
+
+        std::span<const EntityId> Entities() const { return m_Entities; }
+
+        // Tick of the last add or marked write, caller guarantees Contains(entityIndex)
+        uint32_t ChangedTick(uint32_t entityIndex) const { return m_ChangedTicks[m_Sparse[entityIndex]]; }
+        void MarkChanged(uint32_t entityIndex, uint32_t tick) { m_ChangedTicks[m_Sparse[entityIndex]] = tick; }
+
+    protected:
+        uint32_t Emplace(EntityId entityId, uint32_t tick) {
+            if (entityId.Index >= m_Sparse.size()) {
+                m_Sparse.resize(entityId.Index + 1, InvalidIndex);
+            }
+            m_Sparse[entityId.Index] = (uint32_t)m_Entities.size();
+            m_Entities.push_back(entityId);
+            m_ChangedTicks.push_back(tick);
+            return m_Sparse[entityId.Index];
+        }
+
+        // Swap-and-pop, returns the dense slot that was freed so the typed pool can mirror the move
+        uint32_t Erase(uint32_t entityIndex) {
+            uint32_t denseIndex = m_Sparse[entityIndex];
+            uint32_t lastIndex = (uint32_t)m_Entities.size() - 1;
+            if (denseIndex != lastIndex) {
+                m_Entities[denseIndex] = m_Entities[lastIndex];
+                m_ChangedTicks[denseIndex] = m_ChangedTicks[lastIndex];
+                m_Sparse[m_Entities[denseIndex].Index] = denseIndex;
+            }
+            m_Entities.pop_back();
+            m_ChangedTicks.pop_back();
+            m_Sparse[entityIndex] = InvalidIndex;
+            return denseIndex;
+        }
+
+        // One resize of the sparse array and one allocation per packed array for a whole batch
+        void Reserve(std::span<const EntityId> entityIds, size_t additional) {
+            uint32_t maxIndex = 0;
+            for (EntityId entityId : entityIds) {
+                maxIndex = std::max(maxIndex, entityId.Index);
+            }
+            if (!entityIds.empty() && maxIndex >= m_Sparse.size()) {
+                m_Sparse.resize(maxIndex + 1, InvalidIndex);
+            }
+            m_Entities.reserve(m_Entities.size() + additional);
+            m_ChangedTicks.reserve(m_ChangedTicks.size() + additional);
+        }
+
+        void CloneInto(IComponentContainer& target) const {
+            CopyPacked(m_Sparse, target.m_Sparse);
+            CopyPacked(m_Entities, target.m_Entities);
+            CopyPacked(m_ChangedTicks, target.m_ChangedTicks);
+        }
+
+    protected:
+        std::vector<uint32_t> m_Sparse{};
+        std::vector<EntityId> m_Entities{};
+        std::vector<uint32_t> m_ChangedTicks{};
     };
 
     template<typename T>
     class ComponentContainer : public IComponentContainer {
     public:
-        void Add(UUID entityId, T component) {
-            componentMap[entityId] = component;
+        void Add(EntityId entityId, T component, uint32_t tick) {
+            if (Contains(entityId.Index)) {
+                m_Dense[m_Sparse[entityId.Index]] = std::move(component);
+                MarkChanged(entityId.Index, tick);
+                return;
+            }
+            Emplace(entityId, tick);
+            m_Dense.push_back(std::move(component));
         }
 
-        T* Get(UUID entityId) {
-            auto it = componentMap.find(entityId);
-            if (it != componentMap.end()) {
-                return &it->second;
+        T* Get(uint32_t entityIndex) {
+            return Contains(entityIndex) ? &m_Dense[m_Sparse[entityIndex]] : nullptr;
+        }
+
+        // Caller guarantees Contains(entityIndex)
+        T& GetUnchecked(uint32_t entityIndex) { return m_Dense[m_Sparse[entityIndex]]; }
+
+        void Remove(uint32_t entityIndex) override {
+            if (!Contains(entityIndex)) {
+                return;
             }
-            return nullptr;
+            uint32_t denseIndex = Erase(entityIndex);
+            if (denseIndex != m_Dense.size() - 1) {
+                m_Dense[denseIndex] = std::move(m_Dense.back());
+            }
+            m_Dense.pop_back();
+        }
+
+        Scope<IComponentContainer> Clone() const override {
+            auto clone = CreateScope<ComponentContainer<T>>();
+            CloneInto(*clone);
+            CopyPacked(m_Dense, clone->m_Dense);
+            return clone;
         }
 
-        void Remove(UUID entityId) override {
-            auto it = componentMap.find(entityId);
-            if (it != componentMap.end()) {
-                componentMap.erase(entityId);
+        Scope<IComponentContainer> CreateEmpty() const override {
+            return CreateScope<ComponentContainer<T>>();
+        }
+
+        void InstantiateInto(IComponentContainer& target, std::span<const uint32_t> localIndices,
+            std::span<const EntityId> created, uint32_t localCount, uint32_t tick) const override {
+            auto& typed = static_cast<ComponentContainer<T>&>(target);
+            uint32_t instances = (uint32_t)(created.size() / localCount);
+            size_t additional = m_Entities.size() * instances;
+            typed.Reserve(created, additional);
+            typed.m_Dense.reserve(typed.m_Dense.size() + additional);
+
+            // The created entities are fresh, so none of them can already own a component of this type
+            for (uint32_t instance = 0; instance < instances; instance++) {
+                const EntityId* instanceIds = created.data() + (size_t)instance * localCount;
+                for (size_t slot = 0; slot < m_Entities.size(); slot++) {
+                    uint32_t entityIndex = m_Entities[slot].Index;
+                    uint32_t local = entityIndex < localIndices.size() ? localIndices[entityIndex] : InvalidIndex;
+                    if (local == InvalidIndex) {
+                        continue;
+                    }
+                    typed.Emplace(instanceIds[local], tick);
+                    typed.m_Dense.push_back(m_Dense[slot]);
+                }
             }
         }
 
-        std::unordered_map<UUID, T>* map() { return &componentMap; }
+        std::span<T> Components() { return m_Dense; }
 
     private:
-        std::unordered_map<UUID, T> componentMap{};
+        std::vector<T> m_Dense{};
+    };
+
+    // Iterates every entity that owns all of the given components. The smallest pool drives the loop
+    // and the others are resolved through their sparse arrays, so there is no hashing per entity.
+    // Components may be added or removed from the current entity inside the callback, but references
+    // handed to the callback are only valid until then. Writes through a view are not tracked, call
+    // Registry::Patch for components whose change should be visible to ChangedSince.
+    template<typename... Components>
+    class View {
+    public:
+        View(ComponentContainer<Components>*... containers) : m_Containers(containers...) {}
+
+        template<typename Func>
+        void Each(Func&& func) {
+            const IComponentContainer* driver = Driver();
+            if (!driver) {
+                return;
+            }
+
+            // Walk backwards so a swap-and-pop of the current entity never skips one
+            for (size_t i = driver->Size(); i-- > 0;) {
+                if (i >= driver->Size()) {
+                    continue;
+                }
+                Visit(driver->Entities()[i], func);
+            }
+        }
+
+        // Upper bound of matches, the size of the pool that drives iteration
+        size_t SizeHint() const {
+            const IComponentContainer* driver = Driver();
+            return driver ? driver->Size() : 0;
+        }
+
+        // Visits slots [begin, end) of the driving pool so one view can be split across jobs.
+        // No components may be added or removed anywhere while ranges are being visited.
+        template<typename Func>
+        void EachInRange(size_t begin, size_t end, Func&& func) const {
+            const IComponentContainer* driver = Driver();
+            if (!driver) {
+                return;
+            }
+            end = std::min(end, driver->Size());
+            for (size_t i = begin; i < end; i++) {
+                Visit(driver->Entities()[i], func);
+            }
+        }
+
+    private:
+        const IComponentContainer* Driver() const {
+            if ((!std::get<ComponentContainer<Components>*>(m_Containers) || ...)) {
+                return nullptr;
+            }
+
+            const IComponentContainer* smallest = nullptr;
+            ((smallest = (!smallest || std::get<ComponentContainer<Components>*>(m_Containers)->Size() < smallest->Size())
+                ? std::get<ComponentContainer<Components>*>(m_Containers) : smallest), ...);
+            return smallest;
+        }
+
+        template<typename Func>
+        void Visit(EntityId entityId, Func& func) const {
+            if ((std::get<ComponentContainer<Components>*>(m_Containers)->Contains(entityId.Index) && ...)) {
+                func(entityId, std::get<ComponentContainer<Components>*>(m_Containers)->GetUnchecked(entityId.Index)...);
+            }
+        }
+
+        std::tuple<ComponentContainer<Components>*...> m_Containers;
     };
 
     class Registry {
     public:
+        Registry() = default;
+        Registry(Registry&& other) noexcept { *this = std::move(other); }
+        Registry& operator=(Registry&& other) noexcept {
+            components = std::move(other.components);
+            m_Generations = std::move(other.m_Generations);
+            m_FreeIndices = std::move(other.m_FreeIndices);
+            m_Tick.store(other.m_Tick.load());
+            return *this;
+        }
+
+        // Deep copy with identical EntityIds. Pools of trivially copyable components are copied with a
+        // single memcpy each, the rest element by element.
+        Registry Clone() const {
+            Registry clone;
+            for (size_t i = 0; i < components.size(); i++) {
+                if (components[i]) {
+                    clone.components[i] = components[i]->Clone();
+                }
+            }
+            clone.m_Generations = m_Generations;
+            clone.m_FreeIndices = m_FreeIndices;
+            clone.m_Tick.store(GetTick());
+            return clone;
+        }
+
+        EntityId CreateEntity() {
+            if (!m_FreeIndices.empty()) {
+                uint32_t index = m_FreeIndices.back();
+                m_FreeIndices.pop_back();
+                return EntityId(index, m_Generations[index]);
+            }
+            m_Generations.push_back(0);
+            return EntityId((uint32_t)m_Generations.size() - 1, 0);
+        }
+
+        // Fills entityIds with new entities, reusing free indices first
+        void CreateEntities(std::span<EntityId> entityIds) {
+            size_t reused = std::min(entityIds.size(), m_FreeIndices.size());
+            for (size_t i = 0; i < reused; i++) {
+                uint32_t index = m_FreeIndices.back();
+                m_FreeIndices.pop_back();
+                entityIds[i] = EntityId(index, m_Generations[index]);
+            }
+
+            uint32_t first = (uint32_t)m_Generations.size();
+            m_Generations.resize(m_Generations.size() + (entityIds.size() - reused), 0);
+            for (size_t i = reused; i < entityIds.size(); i++) {
+                entityIds[i] = EntityId(first + (uint32_t)(i - reused), 0);
+            }
+        }
+
+        // Copies every component of sourceEntities, all owned by source, onto the fresh entities in created.
+        // created holds one run of sourceEntities.size() entities per instance, in the same order. Each pool is
+        // reserved once and filled in a single pass instead of going through Add for every component.
+        void Instantiate(const Registry& source, std::span<const EntityId> sourceEntities, std::span<const EntityId> created) {
+            HVE_CORE_ASSERT(&source != this, "Instantiating from a registry into itself is not supported");
+            if (sourceEntities.empty() || created.empty()) {
+                return;
+            }
+
+            std::vector<uint32_t> localIndices(source.m_Generations.size(), IComponentContainer::InvalidIndex);
+            for (uint32_t i = 0; i < sourceEntities.size(); i++) {
+                localIndices[sourceEntities[i].Index] = i;
+            }
+
+            uint32_t tick = GetTick();
+            for (size_t i = 0; i < components.size(); i++) {
+                if (!source.components[i]) {
+                    continue;
+                }
+                if (!components[i]) {
+                    components[i] = source.components[i]->CreateEmpty();
+                }
+                source.components[i]->InstantiateInto(*components[i], localIndices, created, (uint32_t)sourceEntities.size(), tick);
+            }
+        }
+
+        // Drops every component of the entity and invalidates all handles to it
+        void DestroyEntity(EntityId entityId) {
+            if (!IsValid(entityId)) {
+                return;
+            }
+            for (auto& container : components) {
+                if (container) {
+                    container->Remove(entityId.Index);
+                }
+            }
+            m_Generations[entityId.Index]++;
+            m_FreeIndices.push_back(entityId.Index);
+        }
+
+        bool IsValid(EntityId entityId) const {
+            return entityId.Index < m_Generations.size() && m_Generations[entityId.Index] == entityId.Generation;
+        }
+
         template<typename T>
-        void Add(UUID entityId, T component) {
-            const std::type_index typeIndex = std::type_index(typeid(T));
-            if (components.find(typeIndex) == components.end()) {
-                components[typeIndex] = std::make_shared<ComponentContainer<T>>();
+        void Add(EntityId entityId, T component) {
+            if (!IsValid(entityId)) {
+                return;
+            }
+            auto& container = components[ComponentTypeID<T>::Value];
+            if (!container) {
+                container = CreateScope<ComponentContainer<T>>();
             }
-            std::static_pointer_cast<ComponentContainer<T>>(components[typeIndex])->Add(entityId, std::move(component));
+            static_cast<ComponentContainer<T>*>(container.get())->Add(entityId, std::move(component), GetTick());
+        }
+
+        // Mutable access, counts as a change. Use GetReadOnly or a View when only reading
+        template<typename T>
+        T* Get(EntityId entityId) {
+            return Patch<T>(entityId);
         }
 
         template<typename T>
-        T* Get(UUID entityId) {
-            const std::type_index typeIndex = std::type_index(typeid(T));
-            auto it = components.find(typeIndex);
-            if (it != components.end()) {
-                return std::static_pointer_cast<ComponentContainer<T>>(it->second)->Get(entityId);
+        const T* GetReadOnly(EntityId entityId) {
+            auto container = GetContainer<T>();
+            if (container && IsValid(entityId)) {
+                return container->Get(entityId.Index);
             }
             return nullptr;
         }
 
         template<typename T>
-        void Remove(UUID entityId) {
-            const std::type_index typeIndex = std::type_index(typeid(T));
-            auto it = components.find(typeIndex);
-            if (it != components.end()) {
-                std::static_pointer_cast<ComponentContainer<T>>(it->second)->Remove(entityId);
-            }
+        bool Has(EntityId entityId) {
+            auto container = GetContainer<T>();
+            return container && IsValid(entityId) && container->Contains(entityId.Index);
         }
 
-        void RemoveAllFromEntity(UUID entityId) {
-            for (auto& [typeIndex, container] : components) {
-                container->Remove(entityId);
+        // Stamps the component with the current tick and returns it for writing
+        template<typename T>
+        T* Patch(EntityId entityId) {
+            auto container = GetContainer<T>();
+            if (!container || !IsValid(entityId) || !container->Contains(entityId.Index)) {
+                return nullptr;
             }
+            container->MarkChanged(entityId.Index, GetTick());
+            return &container->GetUnchecked(entityId.Index);
         }
 
+        // True if the component was added or patched after the given tick, see AdvanceTick
         template<typename T>
-        std::unordered_map<UUID, T>* GetComponentRegistry() {
-            const std::type_index typeIndex = std::type_index(typeid(T));
-            auto it = components.find(typeIndex);
-            if (it != components.end()) {
-                return std::static_pointer_cast<ComponentContainer<T>>(it->second)->map();
+        bool ChangedSince(EntityId entityId, uint32_t tick) {
+            auto container = GetContainer<T>();
+            return container && IsValid(entityId) && container->Contains(entityId.Index)
+                && IsNewerTick(container->ChangedTick(entityId.Index), tick);
+        }
+
+        uint32_t GetTick() const { return m_Tick.load(std::memory_order_acquire); }
+
+        // Returns the tick changes have been stamped with so far and moves on to the next one. A system
+        // stores the result when it finishes, its own writes then compare as old and all later ones as new.
+        uint32_t AdvanceTick() { return m_Tick.fetch_add(1, std::memory_order_acq_rel); }
+
+        template<typename T>
+        void Remove(EntityId entityId) {
+            auto container = GetContainer<T>();
+            if (container && IsValid(entityId)) {
+                container->Remove(entityId.Index);
             }
-            return nullptr;
+        }
+
+        template<typename... Components>
+        Engine::View<Components...> View() {
+            return Engine::View<Components...>(GetContainer<Components>()...);
+        }
+
+        template<typename... Components, typename Func>
+        void Each(Func&& func) {
+            View<Components...>().Each(std::forward<Func>(func));
+        }
+
+        // Packed components of one type, the entity owning element i is GetComponentEntities<T>()[i]
+        template<typename T>
+        std::span<T> GetComponentRegistry() {
+            auto container = GetContainer<T>();
+            return container ? container->Components() : std::span<T>();
+        }
+
+        template<typename T>
+        std::span<const EntityId> GetComponentEntities() {
+            auto container = GetContainer<T>();
+            return container ? container->Entities() : std::span<const EntityId>();
         }
 
     private:
-        std::unordered_map<std::type_index, std::shared_ptr<IComponentContainer>> components;
+        template<typename T>
+        ComponentContainer<T>* GetContainer() {
+            return static_cast<ComponentContainer<T>*>(components[ComponentTypeID<T>::Value].get());
+        }
+
+    private:
+        std::array<Scope<IComponentContainer>, MaxComponentTypes> components{};
+
+        std::vector<uint32_t> m_Generations;
+        std::vector<uint32_t> m_FreeIndices;
+
+        // Starts above zero so a system that has never run sees every component as changed
+        std::atomic<uint32_t> m_Tick = 1;
     };
 }
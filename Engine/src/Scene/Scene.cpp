@@ -2,7 +2,7 @@
 #include "Scene.h"
 #include "Components.h"
 #include "Entity.h"
-#include <glm/gtx/matrix_decompose.hpp>
+#include "Prefab.h"
 #include "Renderer/Renderer.h"
 #include "Assets/AssetManager.h"
 #include "Core/Application.h"
@@ -11,6 +11,22 @@
 
 namespace Engine {
 
+	// Below a parent the world matrix has to be final already, roots take their local transform as it is
+	static void FinishWorldTransform(WorldTransformComponent& world, const LocalTransformComponent& local, bool has_parent)
+	{
+		if (has_parent)
+		{
+			world.DecomposeMatrix();
+		}
+		else
+		{
+			world.matrix = local.matrix;
+			world.translation = local.translation;
+			world.rotation = local.rotation;
+			world.scale = local.scale;
+		}
+	}
+
 	Ref<Scene> Scene::CreateScene(std::string name)
 	{
 		return CreateRef<Scene>(name);
@@ -29,14 +45,23 @@ namespace Engine {
 
 		this->m_Name = std::move(new_scene->m_Name);
 		this->m_Registry = std::move(new_scene->m_Registry);
-		this->m_RootSceneNode = std::move(new_scene->m_RootSceneNode);
-		this->entities = std::move(new_scene->entities);
+		this->m_Hierarchy = std::move(new_scene->m_Hierarchy);
+		this->m_EntityIDs = std::move(new_scene->m_EntityIDs);
+		this->m_WorldPartition.CopyFrom(new_scene->m_WorldPartition);
 		this->m_IsReloading = true;
 
-		for (auto& entity : entities)
-		{
-			entity.second->ChangeScene(this);
-		}
+		// The new registry counts its ticks from scratch
+		ResetChangeTracking();
+	}
+
+	void Scene::ResetChangeTracking()
+	{
+		m_TransformsTick = 0;
+		m_PhysicsPushTick = 0;
+		m_MeshTransformsTick = 0;
+		m_StaticTransformsDirty = true;
+		// Rebuilt from scratch by the next MeshTransforms run, which now sees every mesh as changed
+		m_SpatialIndex.Clear();
 	}
 
 	bool Scene::SaveScene(const std::filesystem::path& folder_path)
@@ -56,190 +81,414 @@ namespace Engine {
 	Scene::Scene(std::string name)
 		: m_Name(name)
 	{
+		RegisterSystems();
 	}
 
-	Scene::~Scene() {
-		for (auto [key, entity] : entities) {
-			m_Registry.RemoveAllFromEntity(key);
-		}
-	}
-	EntityHandle* Scene::CreateEntity(std::string name, Entity* parent) {
-		return CreateEntity(name, parent->GetHandle());
-	}
-
-	EntityHandle* Scene::CreateEntity(std::string name, EntityHandle* parent)
+	void Scene::RegisterSystems()
 	{
-		UUID* id = &parent->GetID();
-		return CreateEntity(name, id);
-	}
+		// Registration order is the execution order wherever two systems touch the same components.
+		// Scripts can reach any component through the internal calls, so they are treated as writing all of them.
+		m_SimulationSystems.AddSystem({ "Scripts", {}, ComponentMask().set(), true, [this]()
+		{
+			if (m_SceneState == SceneRunType::Runtime)
+			{
+				ScriptEngine::OnUpdate(Application::Get().GetFrameData().FixedDeltaTime);
+			}
+		} });
 
-	EntityHandle* Scene::CreateEntity(std::string name, UUID* parent)
-	{
-		UUID new_id = UUID();
-		return CreateEntityByUUID(new_id, name, parent);
-	}
+		// Collider components stand in for the physics world, so pushing, stepping and syncing stay in order
+		m_SimulationSystems.AddSystem({ "PhysicsPush", MakeComponentMask<TransformComponent>(), MakeComponentMask<BoxColliderComponent>(), false, [this]()
+		{
+			if (m_SceneState == SceneRunType::Runtime)
+			{
+				// Only bodies whose transform was touched since the last sync, by scripts or the editor. Static level
+				// geometry is skipped, and a body is only woken up when it is really moved.
+				uint32_t since = m_PhysicsPushTick;
+				m_Registry.Each<BoxColliderComponent, TransformComponent>([this, since](EntityId entity_id, BoxColliderComponent&, TransformComponent& transform)
+				{
+					if (!transform.IsStatic() && m_Registry.ChangedSince<TransformComponent>(entity_id, since))
+					{
+						auto physics_scene = PhysicsEngine::Get()->GetCurrentScene();
+						const glm::vec3& translation = transform.world_transform.translation;
+						physics_scene->SetPosition(entity_id, translation, physics_scene->GetPosition(entity_id) != translation);
+					}
+				});
+			}
+		} });
 
-	EntityHandle* Scene::CreateEntity(std::string name, nullptr_t parent)
-	{
-		UUID root_id = 0;
-		return CreateEntity(name, &root_id);
-	}
+		// Contact callbacks call into the scripts, so the step inherits their access
+		m_SimulationSystems.AddSystem({ "PhysicsStep", {}, ComponentMask().set(), true, [this]()
+		{
+			if (m_SceneState == SceneRunType::Runtime && !m_Registry.GetComponentEntities<BoxColliderComponent>().empty())
+			{
+				PhysicsEngine::Get()->Step(Application::Get().GetFrameData().FixedDeltaTime);
+			}
+		} });
 
-	EntityHandle* Scene::CreateEntityByUUID(UUID id, std::string name, Entity* parent)
-	{
-		UUID* parent_id = &parent->GetID();
-		return CreateEntityByUUID(id, name, parent_id);
-	}
+		m_SimulationSystems.AddSystem({ "Transforms", {}, MakeComponentMask<TransformComponent, CameraComponent>(), false, [this]()
+		{
+			UpdateTransforms();
+		} });
 
-	EntityHandle* Scene::CreateEntityByUUID(UUID id, std::string name, EntityHandle* parent)
-	{
-		UUID* parent_id = &parent->GetID();
-		return CreateEntityByUUID(id, name, parent_id);
+		m_SimulationSystems.AddSystem({ "PhysicsSync", MakeComponentMask<BoxColliderComponent, SphereColliderComponent, CharacterControllerComponent>(),
+			MakeComponentMask<TransformComponent, CameraComponent>(), false, [this]()
+		{
+			if (m_SceneState == SceneRunType::Runtime)
+			{
+				SyncPhysicsTransforms();
+				// The poses written here come from the bodies, so the next push must not send them back
+				m_PhysicsPushTick = m_Registry.AdvanceTick();
+			}
+		} });
+
+		// Once per rendered frame, after the last simulation step
+		m_Systems.AddSystem({ "AudioListener", MakeComponentMask<TransformComponent, CameraComponent>(), {}, true, [this]()
+		{
+			SoundEngine::SetListenerPosition(GetCurrentCamera()->CalculatePosition());
+		} });
+
+		m_Systems.AddSystem({ "MeshTransforms", MakeComponentMask<TransformComponent>(), MakeComponentMask<MeshComponent>(), false, [this]()
+		{
+			uint32_t since = m_MeshTransformsTick;
+			ParallelEach<MeshComponent, TransformComponent>(m_Registry, [this, since](EntityId entity_id, MeshComponent& value, TransformComponent& transform)
+			{
+				// Static entities are not touched by the transform pass once placed, so they drop out here as well
+				if (value.mesh != nullptr && (m_Registry.ChangedSince<TransformComponent>(entity_id, since) || m_Registry.ChangedSince<MeshComponent>(entity_id, since)))
+				{
+					value.mesh->SetTransform(transform.world_transform.matrix);
+					if (auto mesh_source = value.mesh->GetMeshSource())
+					{
+						value.world_bounds = *mesh_source->GetBounds();
+						value.world_bounds.TransformBy(transform.world_transform.matrix);
+					}
+				}
+			});
+
+			// The tree is not thread safe, so it catches up on its own afterwards
+			m_Registry.Each<MeshComponent, TransformComponent>([this, since](EntityId entity_id, MeshComponent& value, TransformComponent&)
+			{
+				if (m_Registry.ChangedSince<TransformComponent>(entity_id, since) || m_Registry.ChangedSince<MeshComponent>(entity_id, since))
+				{
+					m_SpatialIndex.Update(entity_id, value.world_bounds);
+				}
+			});
+			// Meshes removed without destroying their entity
+			if (m_SpatialIndex.GetCount() > m_Registry.GetComponentEntities<MeshComponent>().size())
+			{
+				m_SpatialIndex.RemoveIf([this](EntityId entity_id) { return !m_Registry.Has<MeshComponent>(entity_id); });
+			}
+			m_MeshTransformsTick = m_Registry.AdvanceTick();
+		} });
+
+		// Writes the level into the Mesh, so it counts as writing the component to stay between MeshTransforms and Draw
+		m_Systems.AddSystem({ "MeshLOD", {}, MakeComponentMask<MeshComponent>(), false, [this]()
+		{
+			Camera* camera = GetCurrentCamera();
+			glm::vec3 camera_position = camera->CalculatePosition();
+			const glm::mat4& projection = camera->GetProjection();
+			// An orthographic projection has no divide by depth, the size on screen does not change with distance
+			bool perspective = projection[3][3] == 0.0f;
+			float projection_scale = projection[1][1];
+			ParallelEach<MeshComponent>(m_Registry, [=](EntityId, MeshComponent& value)
+			{
+				auto mesh_source = value.mesh ? value.mesh->GetMeshSource() : nullptr;
+				if (!mesh_source || value.world_bounds.IsEmpty())
+				{
+					return;
+				}
+
+				uint32_t lod_count = mesh_source->GetLODCount();
+				if (value.forced_lod >= 0)
+				{
+					value.mesh->SetLOD(std::min((uint32_t)value.forced_lod, lod_count - 1));
+					return;
+				}
+
+				// Height of the bounding sphere as a fraction of the viewport height
+				float radius = glm::length(value.world_bounds.GetExtents());
+				float screen_size = radius * projection_scale;
+				if (perspective)
+				{
+					screen_size /= std::max(glm::distance(value.world_bounds.GetCenter(), camera_position), 0.001f);
+				}
+				value.mesh->SetLOD(mesh_source->SelectLOD(screen_size * value.lod_bias, value.mesh->GetLOD()));
+			});
+		} });
+
+		m_Systems.AddSystem({ "Draw", MakeComponentMask<TransformComponent, MeshComponent, DirectionalLightComponent>(),
+			MakeComponentMask<PointLightComponent>(), true, [this]()
+		{
+			DrawSystem();
+		} });
 	}
 
-	EntityHandle* Scene::CreateEntityByUUID(UUID id, std::string name, nullptr_t parent)
+	Scene::~Scene() {
+	}
+	Entity Scene::CreateEntity(std::string name, EntityId parent)
 	{
-		UUID root_id = 0;
-		return CreateEntityByUUID(id, name, &root_id);
+		UUID new_id = UUID();
+		return CreateEntityByUUID(new_id, name, parent);
 	}
 
-	EntityHandle* Scene::CreateEntityByUUID(UUID id, std::string name, UUID* parent)
+	Entity Scene::CreateEntityByUUID(UUID id, std::string name, EntityId parent)
 	{
-		UUID root_id = 0;
-		m_RootSceneNode.AddChild(parent == nullptr ? root_id : *parent, id);
+		EntityId entity_id = m_Registry.CreateEntity();
+		m_Hierarchy.Add(entity_id, parent);
 
-		m_Registry.Add<IDComponent>(id, IDComponent(id));
-		m_Registry.Add<ParentIDComponent>(id, ParentIDComponent(parent == nullptr ? root_id : *parent));
-		m_Registry.Add<TagComponent>(id, TagComponent(name));
-		m_Registry.Add<TransformComponent>(id, TransformComponent());
+		auto parent_id_component = m_Registry.GetReadOnly<IDComponent>(parent);
 
-		Ref<Entity> new_entity = CreateRef<Entity>(id, this);
+		m_Registry.Add<IDComponent>(entity_id, IDComponent(id));
+		m_Registry.Add<ParentIDComponent>(entity_id, ParentIDComponent(parent_id_component ? parent_id_component->id : UUID(0)));
+		m_Registry.Add<TagComponent>(entity_id, TagComponent(name));
+		m_Registry.Add<TransformComponent>(entity_id, TransformComponent());
 
-		entities[id] = new_entity;
+		m_EntityIDs[id] = entity_id;
 
-		return new_entity->GetHandle();
+		return Entity(entity_id, this);
 	}
 
-	void Scene::DestroyEntity(EntityHandle* id)
+	void Scene::DestroyEntity(EntityId id)
 	{
-		DestroyEntity(id->GetID());
+		DestroyEntities(std::span<const EntityId>(&id, 1));
 	}
 
-	void Scene::DestroyEntity(UUID id)
+	void Scene::DestroyEntities(std::span<const EntityId> ids)
 	{
-		// Temp fix
-		auto entity = GetEntity(id);
-		if (entity->HasComponent<GlobalSoundsComponent>())
+		std::vector<EntityId> destroyed;
+		destroyed.reserve(ids.size());
+		for (EntityId id : ids)
+		{
+			if (m_Registry.IsValid(id))
+			{
+				destroyed.push_back(id);
+			}
+		}
+		if (destroyed.empty())
+		{
+			return;
+		}
+
+		// Subsystems get the whole batch while the components are still readable
+		for (EntityId id : destroyed)
 		{
-			auto sounds = entity->GetComponent<GlobalSoundsComponent>();
-			for (auto sound : sounds->Sounds)
+			if (auto sounds = m_Registry.Get<GlobalSoundsComponent>(id))
 			{
-				sound->StopSound();
+				for (auto& sound : sounds->Sounds)
+				{
+					sound->StopSound();
+				}
+			}
+
+			if (auto sounds = m_Registry.Get<LocalSoundsComponent>(id))
+			{
+				for (auto& sound : sounds->Sounds)
+				{
+					sound->StopSound();
+				}
 			}
 		}
 
-		if (entity->HasComponent<LocalSoundsComponent>())
+		if (m_SceneState == SceneRunType::Runtime)
 		{
-			auto sounds = entity->GetComponent<LocalSoundsComponent>();
-			for (auto sound : sounds->Sounds)
+			if (auto physics_scene = PhysicsEngine::Get()->GetCurrentScene())
 			{
-				sound->StopSound();
+				physics_scene->OnEntitiesDestroyed(destroyed);
 			}
+			ScriptEngine::OnEntitiesDestroyed(destroyed);
 		}
 
-		m_RootSceneNode.RemoveChild(id, &m_RootSceneNode);
-		m_Registry.RemoveAllFromEntity(id);
-		entities.erase(id);
+		for (EntityId id : destroyed)
+		{
+			// The children move up to the destroyed entity's parent
+			const IDComponent* parent_id_component = m_Registry.GetReadOnly<IDComponent>(m_Hierarchy.GetParent(id));
+			m_Hierarchy.ForEachChild(id, [&](EntityId child)
+			{
+				m_Registry.Patch<ParentIDComponent>(child)->id = parent_id_component ? parent_id_component->id : UUID(0);
+			});
+			m_Hierarchy.Remove(id);
+			m_SpatialIndex.Remove(id);
+			m_EntityIDs.erase(m_Registry.Get<IDComponent>(id)->id);
+			m_Registry.DestroyEntity(id);
+		}
 	}
 
-	Entity* Scene::GetEntity(const UUID& id)
+	void Scene::FlushCommands()
 	{
-		auto it = entities.find(id);
-		if (it != entities.end()) {
-			return it->second.get();
+		HVE_PROFILE_FUNC();
+		// Destroy callbacks may record new commands, keep going until the buffer settles
+		while (!m_Commands.Empty())
+		{
+			std::vector<EntityId> destroyed = m_Commands.Execute(*this);
+			DestroyEntities(destroyed);
 		}
-		return nullptr;
 	}
 
-	Entity* Scene::GetEntity(EntityHandle* id)
+	Entity Scene::GetEntity(EntityId id)
 	{
-		return GetEntity(id->GetID());
+		if (m_Registry.IsValid(id)) {
+			return Entity(id, this);
+		}
+		return Entity();
 	}
 
-	void Scene::ForEachEntity(std::function<void(const UUID, const Ref<Entity>)> func) const
+	Entity Scene::GetEntityByUUID(const UUID& id)
 	{
-		for (const auto& [key, value] : entities)
-		{
-			func(key, value);
+		auto it = m_EntityIDs.find(id);
+		if (it != m_EntityIDs.end()) {
+			return GetEntity(it->second);
 		}
+		return Entity();
+	}
+
+	// The copy keeps the EntityIds of the original, so the registry, the hierarchy and the UUID table can
+	// each be copied wholesale without remapping a single id
+	Ref<Scene> Scene::Copy(Ref<Scene> original_scene)
+	{
+		HVE_PROFILE_FUNC();
+		Ref<Scene> new_scene = CreateRef<Scene>(original_scene->m_Name);
+
+		new_scene->m_Registry = original_scene->m_Registry.Clone();
+		new_scene->m_Hierarchy = original_scene->m_Hierarchy;
+		new_scene->m_EntityIDs = original_scene->m_EntityIDs;
+		new_scene->m_WorldPartition.CopyFrom(original_scene->m_WorldPartition);
+
+		return new_scene;
 	}
 
-	static void CopySceneEntities(SceneNode* source, Ref<Scene> target)
+	bool Scene::ReparentEntity(EntityId id, EntityId new_parent_id)
 	{
-		for (size_t i = 0; i < source->GetChildren()->size(); i++)
+		if (!m_Registry.IsValid(id) || !m_Hierarchy.Reparent(id, new_parent_id))
 		{
-			target->CreateEntityByUUID(source->GetChildren()->at(i)->GetID(), "", &source->GetID());
-			CopySceneEntities(source->GetChildren()->at(i).get(), target);
+			return false;
 		}
+
+		const IDComponent* parent_id_component = m_Registry.GetReadOnly<IDComponent>(m_Hierarchy.GetParent(id));
+		m_Registry.Patch<ParentIDComponent>(id)->id = parent_id_component ? parent_id_component->id : UUID(0);
+		// The world transform of the whole subtree depends on the new parent
+		m_Registry.Patch<TransformComponent>(id);
+		return true;
 	}
 
-	template<typename ComponentType>
-	static void CopyComponent(Registry& source, Registry& target)
+	std::vector<EntityId> Scene::Instantiate(Ref<Prefab> prefab, uint32_t count, std::span<const LocalTransformComponent> transforms, EntityId parent)
 	{
-		auto component_reg = source.GetComponentRegistry<ComponentType>();
-		if (!component_reg)
+		HVE_PROFILE_FUNC();
+		std::vector<EntityId> roots;
+		if (!prefab || prefab->m_Entities.empty() || count == 0)
 		{
-			return;
+			return roots;
 		}
-		for (auto& [id, component] : *component_reg)
+		HVE_CORE_ASSERT(transforms.empty() || transforms.size() == count, "Instantiate needs either no transforms or one per copy");
+
+		const auto& prefab_entities = prefab->m_Entities;
+		const auto& prefab_parents = prefab->m_ParentIndices;
+		uint32_t entity_count = (uint32_t)prefab_entities.size();
+
+		std::vector<EntityId> created((size_t)entity_count * count);
+		m_Registry.CreateEntities(created);
+		m_Registry.Instantiate(*prefab->m_Scene->GetRegistry(), prefab_entities, created);
+
+		if (!m_Hierarchy.Contains(parent))
 		{
-			target.Add<ComponentType>(id, component);
+			parent = EntityId();
 		}
-	}
+		const IDComponent* parent_id_component = m_Registry.GetReadOnly<IDComponent>(parent);
+		UUID parent_uuid = parent_id_component ? parent_id_component->id : UUID(0);
 
-	Ref<Scene> Scene::Copy(Ref<Scene> original_scene)
-	{
-		Ref<Scene> new_scene = CreateRef<Scene>(original_scene->m_Name);
-		
-		CopySceneEntities(&original_scene->m_RootSceneNode, new_scene);
-
-		CopyComponent<TagComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<TransformComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<MeshComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<CameraComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<PointLightComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<DirectionalLightComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<GlobalSoundsComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<LocalSoundsComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<ScriptComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<CharacterControllerComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<BoxColliderComponent>(original_scene->m_Registry, new_scene->m_Registry);
-		CopyComponent<SphereColliderComponent>(original_scene->m_Registry, new_scene->m_Registry);
+		m_EntityIDs.reserve(m_EntityIDs.size() + created.size());
+		roots.reserve(count);
 
-		return new_scene;
-	}
+		// The pools now hold copies of the prefab's ids, parents and meshes, only those need fixing per entity
+		std::vector<UUID> uuids(entity_count);
+		for (uint32_t instance = 0; instance < count; instance++)
+		{
+			const EntityId* instance_ids = created.data() + (size_t)instance * entity_count;
+			for (uint32_t local = 0; local < entity_count; local++)
+			{
+				EntityId entity_id = instance_ids[local];
+				bool is_root = local == 0;
 
-	void Scene::FindNodeAndParent(SceneNode* current, UUID id, SceneNode** node, SceneNode** parent) {
-		for (auto& child : *current->GetChildren()) {
-			if (child->GetID() == id) {
-				*node = child.get();
-				*parent = current;
-				return;
+				uuids[local] = UUID();
+				m_Registry.Patch<IDComponent>(entity_id)->id = uuids[local];
+				m_Registry.Patch<ParentIDComponent>(entity_id)->id = is_root ? parent_uuid : uuids[prefab_parents[local]];
+				m_EntityIDs[uuids[local]] = entity_id;
+
+				m_Hierarchy.Add(entity_id, is_root ? parent : instance_ids[prefab_parents[local]]);
+
+				// Meshes carry the world transform, every entity needs its own
+				if (auto mesh_component = m_Registry.Patch<MeshComponent>(entity_id); mesh_component && mesh_component->mesh)
+				{
+					mesh_component->mesh = CreateRef<Mesh>(mesh_component->mesh->GetMeshSource());
+				}
 			}
-			FindNodeAndParent(child.get(), id, node, parent);
+
+			if (!transforms.empty())
+			{
+				m_Registry.Patch<TransformComponent>(instance_ids[0])->local_transform = transforms[instance];
+			}
+			roots.push_back(instance_ids[0]);
 		}
+
+		// Physics bodies are created from the world transform, the transform pass would only fill it in on the next step
+		PlaceEntities(created);
+		SetupRuntimeEntities(created);
+
+		return roots;
 	}
 
-	void Scene::ReparentSceneNode(EntityHandle* id, EntityHandle* new_parent_id) {
-		UUID* ent_id = &id->GetID();
-		UUID* parent_id = &new_parent_id->GetID();
-		ReparentSceneNode(ent_id, parent_id);
+	void Scene::PlaceEntities(std::span<const EntityId> entities)
+	{
+		HVE_PROFILE_FUNC();
+		for (EntityId entity_id : entities)
+		{
+			auto transform = m_Registry.Patch<TransformComponent>(entity_id);
+			if (!transform)
+			{
+				continue;
+			}
+
+			// The nearest ancestor with a transform, entities without one pass their parent's through
+			const WorldTransformComponent* parent_world = nullptr;
+			for (EntityId parent = m_Hierarchy.GetParent(entity_id); parent.IsValid() && !parent_world; parent = m_Hierarchy.GetParent(parent))
+			{
+				if (auto parent_transform = m_Registry.GetReadOnly<TransformComponent>(parent))
+				{
+					parent_world = &parent_transform->world_transform;
+				}
+			}
+
+			auto& local = transform->local_transform;
+			auto& world = transform->world_transform;
+			local.UpdateMatrix();
+			if (parent_world)
+			{
+				world.matrix = Math::MultiplyTransform(parent_world->matrix, local.matrix);
+			}
+			FinishWorldTransform(world, local, parent_world != nullptr);
+		}
 	}
 
-	void Scene::ReparentSceneNode(UUID* id, UUID* new_parent_id)
+	void Scene::SetupRuntimeEntities(std::span<const EntityId> entities)
 	{
-		m_RootSceneNode.RemoveChild(*id, &m_RootSceneNode);
-		m_RootSceneNode.AddChild(*new_parent_id, *id);
+		// Same setup OnRuntimeStart does for the entities that were there from the start
+		if (m_SceneState != SceneRunType::Runtime)
+		{
+			return;
+		}
+		for (EntityId entity_id : entities)
+		{
+			if (m_Registry.Has<ScriptComponent>(entity_id))
+			{
+				ScriptEngine::OnCreateEntityClass(GetEntity(entity_id));
+			}
+		}
+		for (EntityId entity_id : entities)
+		{
+			if (m_Registry.Has<CharacterControllerComponent>(entity_id) || m_Registry.Has<BoxColliderComponent>(entity_id)
+				|| m_Registry.Has<SphereColliderComponent>(entity_id))
+			{
+				PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
+			}
+		}
 	}
 
 	void Scene::OnRuntimeStart()
@@ -251,55 +500,39 @@ namespace Engine {
 		m_SceneState = SceneRunType::Runtime;
 
 		// Init all script entities
-		auto script_registry = m_Registry.GetComponentRegistry<ScriptComponent>();
-		if (script_registry)
+		m_Registry.Each<ScriptComponent>([this](EntityId entity_id, ScriptComponent&)
 		{
-			for (auto& [entity_id, script_component] : *script_registry)
-			{
-				ScriptEngine::OnCreateEntityClass(GetEntity(entity_id));
-			}
-		}
+			ScriptEngine::OnCreateEntityClass(GetEntity(entity_id));
+		});
 
 		PhysicsEngine::Get()->CreateScene(this, 10);
 		PhysicsEngine::Get()->OnRuntimeStart(1, 1);
 
-		std::set<UUID> finished_assets = std::set<UUID>();
+		std::set<EntityId> finished_assets = std::set<EntityId>();
 
-		auto character_controllers = m_Registry.GetComponentRegistry<CharacterControllerComponent>();
-		if (character_controllers)
+		m_Registry.Each<CharacterControllerComponent>([&](EntityId entity_id, CharacterControllerComponent&)
 		{
-			for (auto& [entity_id, character_controller] : *character_controllers)
-			{
-				if (finished_assets.contains(entity_id))
-					continue;
-				PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
-				finished_assets.insert(entity_id);
-			}
-		}
+			if (finished_assets.contains(entity_id))
+				return;
+			PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
+			finished_assets.insert(entity_id);
+		});
 
-		auto box_colliders = m_Registry.GetComponentRegistry<BoxColliderComponent>();
-		if (box_colliders)
+		m_Registry.Each<BoxColliderComponent>([&](EntityId entity_id, BoxColliderComponent&)
 		{
-			for (auto& [entity_id, box_collider] : *box_colliders)
-			{
-				if (finished_assets.contains(entity_id))
-					continue;
-				PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
-				finished_assets.insert(entity_id);
-			}
-		}
+			if (finished_assets.contains(entity_id))
+				return;
+			PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
+			finished_assets.insert(entity_id);
+		});
 
-		auto sphere_colliders = m_Registry.GetComponentRegistry<SphereColliderComponent>();
-		if (sphere_colliders)
+		m_Registry.Each<SphereColliderComponent>([&](EntityId entity_id, SphereColliderComponent&)
 		{
-			for (auto& [entity_id, sphere_collider] : *sphere_colliders)
-			{
-				if (finished_assets.contains(entity_id))
-					continue;
-				PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
-				finished_assets.insert(entity_id);
-			}
-		}
+			if (finished_assets.contains(entity_id))
+				return;
+			PhysicsEngine::Get()->GetCurrentScene()->CreateBody(GetEntity(entity_id));
+			finished_assets.insert(entity_id);
+		});
 	}
 
 	void Scene::OnRuntimeStop()
@@ -329,14 +562,11 @@ namespace Engine {
 
 	Camera* Scene::GetPrimaryEntityCamera()
 	{
-		if (m_Registry.GetComponentRegistry<CameraComponent>() != nullptr)
+		for (auto& value : m_Registry.GetComponentRegistry<CameraComponent>())
 		{
-			for (auto& [id, value] : *m_Registry.GetComponentRegistry<CameraComponent>())
+			if (value.IsPrimary)
 			{
-				if (value.IsPrimary)
-				{
-					return &value.camera;
-				}
+				return &value.camera;
 			}
 		}
 
@@ -354,218 +584,334 @@ namespace Engine {
 		SetCurrentCamera(Renderer::Get()->GetCamera());
 		m_IsReloading = false;
 
-		if (m_SceneState == SceneRunType::Runtime)
+		// Before the systems run, so cells that come in this frame are placed and drawn right away
+		m_WorldPartition.Update(GetCurrentCamera()->CalculatePosition(), m_SceneState == SceneRunType::Runtime);
+
+		// At a fixed simulation rate the frame may take several steps or none. Outside of play mode nothing
+		// simulates, but the transforms still have to follow the editor every frame.
+		uint32_t steps = m_SceneState == SceneRunType::Runtime ? Application::Get().GetFrameData().FixedSteps : 1;
+		for (uint32_t step = 0; step < steps; step++)
 		{
-			ScriptEngine::OnUpdate(Application::Get().GetFrameData().DeltaTime);
+			m_SimulationSystems.Run();
+			FlushCommands();
+		}
+
+		m_Systems.Run();
+		FlushCommands();
+	}
+
+	void Scene::UpdateTransforms()
+	{
+		HVE_PROFILE_FUNC();
+		m_InheritedWorlds.resize(m_Hierarchy.GetCapacity());
+		m_WorldChanged.resize(m_Hierarchy.GetCapacity());
 
-			auto box_colliders = m_Registry.GetComponentRegistry<BoxColliderComponent>();
-			if (box_colliders)
+		bool full_pass = m_StaticTransformsDirty || m_StaticHierarchyVersion != m_Hierarchy.GetVersion();
+		if (!full_pass)
+		{
+			// Settled static parents are not visited, so point their slots at their current storage for the children
+			for (EntityId entity_id : m_StaticBoundary)
 			{
-				for (auto& [entity_id, box_collider] : *box_colliders)
+				auto transform = m_Registry.GetReadOnly<TransformComponent>(entity_id);
+				if (!transform || !transform->IsStatic())
 				{
-					glm::vec3 entity_world_translation = GetEntity(entity_id)->GetComponent<TransformComponent>()->world_transform.translation;
-					PhysicsEngine::Get()->GetCurrentScene()->SetPosition(entity_id, entity_world_translation, true);
+					full_pass = true;
+					break;
 				}
+				m_InheritedWorlds[entity_id.Index] = &transform->world_transform;
+				m_WorldChanged[entity_id.Index] = 0;
+			}
+		}
+
+		if (full_pass)
+		{
+			PropagateTransforms(m_Hierarchy.GetDepthOrder(), m_Hierarchy.GetLevelOffsets());
+			RebuildDynamicOrder();
+		}
+		else
+		{
+			PropagateTransforms(m_DynamicOrder, m_DynamicLevelOffsets);
+		}
+		m_TransformsTick = m_Registry.AdvanceTick();
+	}
 
-				PhysicsEngine::Get()->Step(Application::Get().GetFrameData().DeltaTime);
+	void Scene::PropagateTransforms(std::span<const EntityId> order, std::span<const uint32_t> level_offsets)
+	{
+		// Entities on one level only read from the level above and write their own slots, so each level can be
+		// split across the workers. The serial path runs the same chunks in order, so the results match bit for bit.
+		for (size_t level = 0; level + 1 < level_offsets.size(); level++)
+		{
+			std::span<const EntityId> level_entities = order.subspan(level_offsets[level], level_offsets[level + 1] - level_offsets[level]);
+			if (!m_ParallelTransforms)
+			{
+				UpdateTransformChunk(level_entities);
+				continue;
 			}
+			JobSystem::ParallelFor(level_entities.size(), 256, [this, level_entities](size_t begin, size_t end)
+			{
+				UpdateTransformChunk(level_entities.subspan(begin, end - begin));
+			});
 		}
+	}
+
+	void Scene::RebuildDynamicOrder()
+	{
+		HVE_PROFILE_FUNC();
+		std::span<const EntityId> order = m_Hierarchy.GetDepthOrder();
+		std::span<const uint32_t> level_offsets = m_Hierarchy.GetLevelOffsets();
 
-		UpdateTransforms();
+		// An entity is settled when it is static and so is everything above it, nothing can move it until the next full pass
+		std::vector<uint8_t> settled(m_Hierarchy.GetCapacity(), 0);
+		m_DynamicOrder.clear();
+		m_DynamicLevelOffsets.clear();
+		m_StaticBoundary.clear();
 
-		if (m_SceneState == SceneRunType::Runtime)
+		for (size_t level = 0; level + 1 < level_offsets.size(); level++)
 		{
-			SyncPhysicsTransforms();
+			m_DynamicLevelOffsets.push_back((uint32_t)m_DynamicOrder.size());
+			for (uint32_t i = level_offsets[level]; i < level_offsets[level + 1]; i++)
+			{
+				EntityId entity_id = order[i];
+				uint32_t parent_index = m_Hierarchy.GetParentIndex(entity_id.Index);
+				bool parent_settled = parent_index == SceneHierarchy::None || settled[parent_index];
+
+				auto transform = m_Registry.GetReadOnly<TransformComponent>(entity_id);
+				if (transform && transform->IsStatic() && parent_settled)
+				{
+					settled[entity_id.Index] = 1;
+					continue;
+				}
+
+				m_DynamicOrder.push_back(entity_id);
+				if (parent_index != SceneHierarchy::None && parent_settled)
+				{
+					m_StaticBoundary.push_back(m_Hierarchy.GetParent(entity_id));
+				}
+			}
 		}
+		m_DynamicLevelOffsets.push_back((uint32_t)m_DynamicOrder.size());
 
-		SoundEngine::SetListenerPosition(GetCurrentCamera()->CalculatePosition());
+		std::sort(m_StaticBoundary.begin(), m_StaticBoundary.end());
+		m_StaticBoundary.erase(std::unique(m_StaticBoundary.begin(), m_StaticBoundary.end()), m_StaticBoundary.end());
 
-		DrawSystem();
+		m_StaticHierarchyVersion = m_Hierarchy.GetVersion();
+		m_StaticTransformsDirty = false;
 	}
 
-	void Scene::UpdateWorldTransform(SceneNode* node, glm::mat4& parentWorldTransform)
+	void Scene::UpdateTransformChunk(std::span<const EntityId> entities)
 	{
-		if (!node) return;
-		auto transform = m_Registry.Get<TransformComponent>(node->GetID());
-		if (transform) {
-			glm::mat4 worldTransform = parentWorldTransform * transform->local_transform.mat4();
+		// Changed entities are gathered into small batches so the matrices go through the batched kernels together
+		constexpr size_t BatchSize = 64;
+		EntityId changed_ids[BatchSize];
+		TransformComponent* transforms[BatchSize];
+		const WorldTransformComponent* parent_worlds[BatchSize];
+		glm::vec3 translations[BatchSize];
+		glm::quat rotations[BatchSize];
+		glm::vec3 scales[BatchSize];
+		glm::mat4 parents[BatchSize];
+		glm::mat4 matrices[BatchSize];
+		uint32_t slots[BatchSize];
 
-			glm::vec3 scale;
-			glm::quat rotation;
-			glm::vec3 translation;
-			glm::vec3 skew;
-			glm::vec4 perspective;
+		for (size_t batch_begin = 0; batch_begin < entities.size(); batch_begin += BatchSize)
+		{
+			size_t batch_end = std::min(batch_begin + BatchSize, entities.size());
+			uint32_t changed_count = 0;
+			uint32_t compose_count = 0;
 
-			glm::decompose(worldTransform, scale, rotation, translation, skew, perspective);
+			for (size_t i = batch_begin; i < batch_end; i++)
+			{
+				EntityId entity_id = entities[i];
+				uint32_t parent_index = m_Hierarchy.GetParentIndex(entity_id.Index);
+				const WorldTransformComponent* parent_world = parent_index == SceneHierarchy::None ? nullptr : m_InheritedWorlds[parent_index];
+				bool parent_changed = parent_index != SceneHierarchy::None && m_WorldChanged[parent_index];
 
-			glm::vec3 eulerAngles = glm::eulerAngles(rotation);
+				if (!m_Registry.Has<TransformComponent>(entity_id))
+				{
+					// Entities without a transform pass their parent's straight through
+					m_InheritedWorlds[entity_id.Index] = parent_world;
+					m_WorldChanged[entity_id.Index] = parent_changed;
+					continue;
+				}
 
-			transform->world_transform.translation = translation;
-			transform->world_transform.rotation = eulerAngles;
-			transform->world_transform.scale = scale;
+				// Untouched subtrees keep their cached matrices
+				bool local_changed = m_Registry.ChangedSince<TransformComponent>(entity_id, m_TransformsTick);
+				bool changed = parent_changed || local_changed || m_Registry.ChangedSince<CameraComponent>(entity_id, m_TransformsTick);
+				m_WorldChanged[entity_id.Index] = changed;
 
-			if (m_Registry.Get<CameraComponent>(node->GetID()) != nullptr) {
-				m_Registry.Get<CameraComponent>(node->GetID())->camera.SetPosition(translation);
+				if (!changed)
+				{
+					m_InheritedWorlds[entity_id.Index] = &m_Registry.GetReadOnly<TransformComponent>(entity_id)->world_transform;
+					continue;
+				}
 
-				if (m_Registry.Get<CameraComponent>(node->GetID())->camera.IsRotationLocked()) {
-					m_Registry.Get<CameraComponent>(node->GetID())->camera.SetRotation(glm::vec2(-eulerAngles.x, -eulerAngles.y));
+				auto transform = m_Registry.Patch<TransformComponent>(entity_id);
+				if (local_changed)
+				{
+					translations[compose_count] = transform->local_transform.translation;
+					rotations[compose_count] = transform->local_transform.rotation;
+					scales[compose_count] = transform->local_transform.scale;
+					slots[compose_count++] = changed_count;
 				}
+				changed_ids[changed_count] = entity_id;
+				transforms[changed_count] = transform;
+				parent_worlds[changed_count++] = parent_world;
 			}
 
-			for (auto& child : *node->GetChildren()) {
-				UpdateWorldTransform(child.get(), worldTransform);
+			if (compose_count > 0)
+			{
+				Math::ComposeTransforms(translations, rotations, scales, matrices, compose_count);
+				for (uint32_t i = 0; i < compose_count; i++)
+				{
+					transforms[slots[i]]->local_transform.matrix = matrices[i];
+				}
 			}
-			
-		}
-		else {
-			for (auto& child : *node->GetChildren()) {
-				UpdateWorldTransform(child.get(), parentWorldTransform);
+
+			// Roots take their local matrix as it is, everything with a parent is multiplied in one go
+			uint32_t multiply_count = 0;
+			for (uint32_t i = 0; i < changed_count; i++)
+			{
+				if (parent_worlds[i])
+				{
+					parents[multiply_count] = parent_worlds[i]->matrix;
+					matrices[multiply_count] = transforms[i]->local_transform.matrix;
+					slots[multiply_count++] = i;
+				}
+			}
+			if (multiply_count > 0)
+			{
+				Math::MultiplyTransforms(parents, matrices, matrices, multiply_count);
+				for (uint32_t i = 0; i < multiply_count; i++)
+				{
+					transforms[slots[i]]->world_transform.matrix = matrices[i];
+				}
 			}
-		}
-	}
 
-	void Scene::UpdateTransforms()
-	{
-		HVE_PROFILE_FUNC();
-		glm::mat4 identityMatrix = glm::mat4(1.0f);
+			for (uint32_t i = 0; i < changed_count; i++)
+			{
+				EntityId entity_id = changed_ids[i];
+				auto& world = transforms[i]->world_transform;
+				FinishWorldTransform(world, transforms[i]->local_transform, parent_worlds[i] != nullptr);
+				m_InheritedWorlds[entity_id.Index] = &world;
 
-		for (auto& child : *m_RootSceneNode.GetChildren()) {
-			UpdateWorldTransform(child.get(), identityMatrix);
+				if (auto camera_component = m_Registry.Patch<CameraComponent>(entity_id)) {
+					camera_component->camera.SetPosition(world.translation);
+
+					if (camera_component->camera.IsRotationLocked()) {
+						glm::vec3 eulerAngles = world.GetRotationEuler();
+						camera_component->camera.SetRotation(glm::vec2(-eulerAngles.x, -eulerAngles.y));
+					}
+				}
+			}
 		}
 	}
 
 	void Scene::DrawSystem()
 	{
 		HVE_PROFILE_FUNC();
-		if (m_Registry.GetComponentRegistry<MeshComponent>() != nullptr) {
-			for (const auto& [id, value] : *m_Registry.GetComponentRegistry<MeshComponent>()) {
-				if (value.mesh != nullptr)
-				{
-					value.mesh->SetTransform(m_Registry.Get<TransformComponent>(id)->world_transform.mat4());
-					Renderer::Get()->SubmitObject(value.mesh);
-				}
-			}
-		}
-		if (m_Registry.GetComponentRegistry<PointLightComponent>() != nullptr) {
-			for (auto& [id, value] : *m_Registry.GetComponentRegistry<PointLightComponent>()) {
-				if (m_Registry.Get<TransformComponent>(id) != nullptr) {
-					value.light.SetPosition(m_Registry.Get<TransformComponent>(id)->world_transform.translation);
-				}
-				Renderer::Get()->SubmitPointLight(&value.light);
+		for (auto& value : m_Registry.GetComponentRegistry<MeshComponent>())
+		{
+			if (value.mesh != nullptr)
+			{
+				Renderer::Get()->SubmitObject(value.mesh);
 			}
 		}
 
-		if (m_Registry.GetComponentRegistry<DirectionalLightComponent>() != nullptr)
+		m_Registry.Each<PointLightComponent, TransformComponent>([](EntityId id, PointLightComponent& value, TransformComponent& transform) {
+			value.light.SetPosition(transform.world_transform.translation);
+			Renderer::Get()->SubmitPointLight(&value.light);
+		});
+
+		for (auto& value : m_Registry.GetComponentRegistry<DirectionalLightComponent>())
 		{
-			for (auto& [id, value] : *m_Registry.GetComponentRegistry<DirectionalLightComponent>())
-			{
-				Renderer::Get()->SubmitDirectionalLight(&value.light);
-			}
+			Renderer::Get()->SubmitDirectionalLight(&value.light);
 		}
 		Renderer::Get()->BeginDrawing();
 	}
 
 	void Scene::SyncPhysicsTransforms()
 	{
-		auto box_colliders = m_Registry.GetComponentRegistry<BoxColliderComponent>();
-		if (box_colliders)
+		HVE_PROFILE_FUNC();
+		ParallelEach<BoxColliderComponent, TransformComponent>(m_Registry, [this](EntityId entity_id, BoxColliderComponent&, TransformComponent& transform)
 		{
-			for (auto& [entity_id, box_collider] : *box_colliders)
+			// Static bodies never move, their transform is already where the body is
+			if (transform.IsStatic())
 			{
-				auto transform = GetEntity(entity_id)->GetComponent<TransformComponent>();
-				glm::mat4 collider_transform = PhysicsEngine::Get()->GetCurrentScene()->GetTransform(entity_id);
-				glm::mat4 worldTransform = collider_transform;
-
-				glm::vec3 scale;
-				glm::quat rotation;
-				glm::vec3 translation;
-				glm::vec3 skew;
-				glm::vec4 perspective;
-
-				glm::decompose(worldTransform, scale, rotation, translation, skew, perspective);
-
-				glm::vec3 eulerAngles = glm::eulerAngles(rotation);
+				return;
+			}
 
-				transform->world_transform.translation = translation;
-				transform->world_transform.rotation = eulerAngles;
+			// Bodies are rigid, so the pose is the rotation part and the last column. The scale stays as it was.
+			glm::mat4 collider_transform = PhysicsEngine::Get()->GetCurrentScene()->GetTransform(entity_id);
+			transform.world_transform.translation = glm::vec3(collider_transform[3]);
+			transform.world_transform.rotation = glm::quat_cast(glm::mat3(collider_transform));
+			transform.world_transform.UpdateMatrix();
+			glm::vec3 translation = transform.world_transform.translation;
+			glm::vec3 eulerAngles = transform.world_transform.GetRotationEuler();
+			m_Registry.Patch<TransformComponent>(entity_id);
+
+			// Update the camera if present
+			auto camera_component = m_Registry.Get<CameraComponent>(entity_id);
+			if (camera_component)
+			{
+				camera_component->camera.SetPosition(translation);
 
-				// Update the camera if present
-				auto camera_component = m_Registry.Get<CameraComponent>(entity_id);
-				if (camera_component)
+				if (camera_component->camera.IsRotationLocked())
 				{
-					camera_component->camera.SetPosition(translation);
-
-					if (camera_component->camera.IsRotationLocked())
-					{
-						camera_component->camera.SetRotationAroundFocalPoint(glm::vec2(-eulerAngles.x, -eulerAngles.y));
-					}
+					camera_component->camera.SetRotationAroundFocalPoint(glm::vec2(-eulerAngles.x, -eulerAngles.y));
 				}
 			}
-		}
+		});
 
 
-		auto sphere_colliders = m_Registry.GetComponentRegistry<SphereColliderComponent>();
-		if (sphere_colliders)
+		ParallelEach<SphereColliderComponent, TransformComponent>(m_Registry, [this](EntityId entity_id, SphereColliderComponent&, TransformComponent& transform)
 		{
-			for (auto& [entity_id, sphere_collider] : *sphere_colliders)
+			if (transform.IsStatic())
 			{
-				auto transform = GetEntity(entity_id)->GetComponent<TransformComponent>();
-				glm::mat4 collider_transform = PhysicsEngine::Get()->GetCurrentScene()->GetTransform(entity_id);
-				glm::mat4 worldTransform = collider_transform;
-
-				glm::vec3 scale;
-				glm::quat rotation;
-				glm::vec3 translation;
-				glm::vec3 skew;
-				glm::vec4 perspective;
-
-				glm::decompose(worldTransform, scale, rotation, translation, skew, perspective);
-
-				glm::vec3 eulerAngles = glm::eulerAngles(rotation);
+				return;
+			}
 
-				transform->world_transform.translation = translation;
-				transform->world_transform.rotation = eulerAngles;
+			// Bodies are rigid, so the pose is the rotation part and the last column. The scale stays as it was.
+			glm::mat4 collider_transform = PhysicsEngine::Get()->GetCurrentScene()->GetTransform(entity_id);
+			transform.world_transform.translation = glm::vec3(collider_transform[3]);
+			transform.world_transform.rotation = glm::quat_cast(glm::mat3(collider_transform));
+			transform.world_transform.UpdateMatrix();
+			glm::vec3 translation = transform.world_transform.translation;
+			glm::vec3 eulerAngles = transform.world_transform.GetRotationEuler();
+			m_Registry.Patch<TransformComponent>(entity_id);
+
+			// Update the camera if present
+			auto camera_component = m_Registry.Get<CameraComponent>(entity_id);
+			if (camera_component)
+			{
+				camera_component->camera.SetPosition(translation);
 
-				// Update the camera if present
-				auto camera_component = m_Registry.Get<CameraComponent>(entity_id);
-				if (camera_component)
+				if (camera_component->camera.IsRotationLocked())
 				{
-					camera_component->camera.SetPosition(translation);
-
-					if (camera_component->camera.IsRotationLocked())
-					{
-						camera_component->camera.SetRotationAroundFocalPoint(glm::vec2(-eulerAngles.x, -eulerAngles.y));
-					}
+					camera_component->camera.SetRotationAroundFocalPoint(glm::vec2(-eulerAngles.x, -eulerAngles.y));
 				}
 			}
-		}
+		});
 
-		auto character_controllers= m_Registry.GetComponentRegistry<CharacterControllerComponent>();
-		if (character_controllers)
+		m_Registry.Each<CharacterControllerComponent, TransformComponent>([this](EntityId entity_id, CharacterControllerComponent&, TransformComponent& transform)
 		{
-			for (auto& [entity_id, character_controller] : *character_controllers)
-			{
-				auto transform = GetEntity(entity_id)->GetComponent<TransformComponent>();
+			glm::vec3 eulerAngles = PhysicsEngine::Get()->GetCurrentScene()->GetRotation(entity_id);
 
+			transform.world_transform.translation = PhysicsEngine::Get()->GetCurrentScene()->GetPosition(entity_id);
+			transform.world_transform.rotation = glm::quat(eulerAngles);
+			transform.world_transform.UpdateMatrix();
+			m_Registry.Patch<TransformComponent>(entity_id);
 
-				glm::vec3 eulerAngles = PhysicsEngine::Get()->GetCurrentScene()->GetRotation(entity_id);
-
-				transform->world_transform.translation = PhysicsEngine::Get()->GetCurrentScene()->GetPosition(entity_id);
-				transform->world_transform.rotation = PhysicsEngine::Get()->GetCurrentScene()->GetRotation(entity_id);
+			// Update the camera if present
+			auto camera_component = m_Registry.Get<CameraComponent>(entity_id);
+			if (camera_component)
+			{
+				camera_component->camera.SetPosition(transform.world_transform.translation);
 
-				// Update the camera if present
-				auto camera_component = m_Registry.Get<CameraComponent>(entity_id);
-				if (camera_component)
+				if (camera_component->camera.IsRotationLocked())
 				{
-					camera_component->camera.SetPosition(transform->world_transform.translation);
-
-					if (camera_component->camera.IsRotationLocked())
-					{
-						camera_component->camera.SetRotationAroundFocalPoint(glm::vec2(-eulerAngles.x, -eulerAngles.y));
-					}
+					camera_component->camera.SetRotationAroundFocalPoint(glm::vec2(-eulerAngles.x, -eulerAngles.y));
 				}
 			}
-		}
+		});
 	}
 
-}
+}
\ No newline at end of file
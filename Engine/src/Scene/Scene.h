@@ -1,8 +1,12 @@
 #pragma once
 #include "Core/Input.h"
 #include "Registry.h"
+#include "SystemScheduler.h"
+#include "EntityCommandBuffer.h"
+#include "SceneHierarchy.h"
+#include "SpatialIndex.h"
+#include "WorldPartition.h"
 #include "Renderer/Camera.h"
-#include "EntityHandle.h"
 #include "SceneSerializer.h"
 #include "Assets/AssetMetadata.h"
 #include "Renderer/Renderer.h"
@@ -10,97 +14,9 @@
 namespace Engine {
 
 	class Entity;
-
-	class SceneNode {
-	public:
-		SceneNode(UUID entity_id) : m_ID(entity_id) {}
-		~SceneNode() = default;
-
-		SceneNode(const SceneNode& other)
-		{
-			m_ID = other.m_ID;
-			children.clear();
-			for (const auto& child : other.children)
-			{
-				children.emplace_back(std::make_unique<SceneNode>(*child));  // Deep copy each child
-			}
-		}
-
-		// Copy assignment operator
-		SceneNode& operator=(const SceneNode& other)
-		{
-			if (this == &other) return *this; // handle self assignment
-
-			m_ID = other.m_ID;
-			children.clear();
-			for (const auto& child : other.children)
-			{
-				children.emplace_back(std::make_unique<SceneNode>(*child));  // Deep copy each child
-			}
-			return *this;
-		}
-
-		bool AddChild(UUID parent_id, UUID entity_id) {
-			for (auto& child : children)
-			{
-				if (child->GetID() == entity_id) //Have to check it here to avoid duplicates
-				{
-					return true;
-				}
-			}
-			if (m_ID == parent_id) {
-				children.push_back(CreateScope<SceneNode>(entity_id));
-				return true;
-			}
-			else {
-				for (auto& child : children) {
-					if (child->AddChild(parent_id, entity_id)) {
-						break;
-					}
-				}
-			}
-			return false;
-		}
-
-		bool RemoveChild(UUID entity_id, SceneNode* parent) {
-			if (m_ID == entity_id) {
-				parent->AddChildren(std::move(children));
-				for (size_t i = 0; i < parent->GetChildren()->size(); i++) {
-					if (parent->GetChildren()->at(i)->GetID() == entity_id) {
-						parent->GetChildren()->erase(parent->GetChildren()->begin() + i);
-					}
-				}
-				return true;
-			}
-			else {
-				for (auto& child : children) {
-					if (child->RemoveChild(entity_id, this)) {
-						break;
-					}
-				}
-			}
-			return false;
-		}
-
-		void SetChildren(std::vector<Scope<SceneNode>> new_children) {
-			children = std::move(new_children);
-		}
-
-		void AddChildren(std::vector<Scope<SceneNode>> new_children) {
-			for (auto &child : new_children) {
-				children.push_back(std::move(child));
-			}
-		}
-
-		UUID& GetID() { return m_ID; }
-		void SetID(UUID id) { m_ID = id; }
-		std::vector<Scope<SceneNode>>* GetChildren() { return &children; }
-
-	private:
-		UUID m_ID;
-		std::vector<Scope<SceneNode>> children;
-	};
-
+	class Prefab;
+	struct LocalTransformComponent;
+	struct WorldTransformComponent;
 
 	enum class SceneRunType
 	{
@@ -124,20 +40,21 @@ namespace Engine {
 
 		Registry* GetRegistry() { return &m_Registry; }
 
-		EntityHandle* CreateEntity(std::string name, Entity* parent);
-		EntityHandle* CreateEntity(std::string name, EntityHandle* parent);
-		EntityHandle* CreateEntity(std::string name, UUID* parent);
-		EntityHandle* CreateEntity(std::string name, nullptr_t parent);
+		// An invalid parent id puts the entity directly under the root node
+		Entity CreateEntity(std::string name, EntityId parent = EntityId());
+		Entity CreateEntityByUUID(UUID id, std::string name, EntityId parent = EntityId());
 
-		EntityHandle* CreateEntityByUUID(UUID id, std::string name, Entity* parent);
-		EntityHandle* CreateEntityByUUID(UUID id, std::string name, EntityHandle* parent);
-		EntityHandle* CreateEntityByUUID(UUID id, std::string name, UUID* parent);
-		EntityHandle* CreateEntityByUUID(UUID id, std::string name, nullptr_t parent);
+		// Immediate, only safe while nothing iterates the registry. Systems and scripts go through GetCommandBuffer()
+		void DestroyEntity(EntityId id);
+		void DestroyEntities(std::span<const EntityId> ids);
+		// Moves the entity and everything below it, an invalid new parent puts it directly under the root.
+		// Returns false if the new parent is the entity itself or one of its descendants.
+		bool ReparentEntity(EntityId id, EntityId new_parent_id);
 
-		void DestroyEntity(EntityHandle* id);
-		void DestroyEntity(UUID id);
-		void ReparentSceneNode(EntityHandle* id, EntityHandle* new_parent_id);
-		void ReparentSceneNode(UUID* id, UUID* new_parent_id);
+		// Spawns count copies of the prefab under parent with every component pool written in bulk. transforms is
+		// either empty, which keeps the local transform saved with the prefab, or holds the root's local transform
+		// for each copy. Immediate like CreateEntity. Returns the root entity of every copy.
+		std::vector<EntityId> Instantiate(Ref<Prefab> prefab, uint32_t count, std::span<const LocalTransformComponent> transforms = {}, EntityId parent = EntityId());
 
 		void OnRuntimeStart();
 		void OnRuntimeStop();
@@ -149,14 +66,38 @@ namespace Engine {
 
 		void UpdateScene();
 
+		EntityCommandBuffer& GetCommandBuffer() { return m_Commands; }
+		// Applies everything recorded in the command buffer, UpdateScene calls this after every simulation step and
+		// once more after the per frame systems
+		void FlushCommands();
+
+		// Propagates transforms level by level on the job system, off runs the same work on the calling thread
+		void SetParallelTransforms(bool parallel) { m_ParallelTransforms = parallel; }
+		bool IsParallelTransforms() const { return m_ParallelTransforms; }
+		// The transform pass skips static entities once they are placed, so editing one or changing an entity's
+		// mobility has to be followed by this. The next pass then visits every entity once.
+		void InvalidateStaticTransforms() { m_StaticTransformsDirty = true; }
+
+		// World bounds of every mesh, updated once per frame after the transforms
+		const SpatialIndex& GetSpatialIndex() const { return m_SpatialIndex; }
+
+		// Streams the static part of the scene in grid cells around the current camera, off unless enabled
+		WorldPartition& GetWorldPartition() { return m_WorldPartition; }
+
+		// Makes every system treat all components as changed on the next update. Needed when data shared
+		// with another scene, such as the meshes of a play mode copy, may have been modified behind its back.
+		void ResetChangeTracking();
+
 		UUID& GetId() { return m_ID; }
 
-		SceneNode* GetRootNode() { return &m_RootSceneNode; }
+		SceneHierarchy& GetHierarchy() { return m_Hierarchy; }
 
 		std::string& GetName() { return m_Name; }
 
-		Entity* GetEntity(const UUID& id);
-		Entity* GetEntity(EntityHandle* id);
+		// Returns an invalid Entity if the id is stale
+		Entity GetEntity(EntityId id);
+		// Hashes into the UUID table, meant for the serializer and the editor rather than per frame code
+		Entity GetEntityByUUID(const UUID& id);
 
 		template<typename T>
 		auto GetAllEntitiesByType()
@@ -164,7 +105,18 @@ namespace Engine {
 			return m_Registry.GetComponentRegistry<T>();
 		}
 
-		void ForEachEntity(std::function<void(const UUID, const Ref<Entity>)> func) const;
+		template<typename T>
+		auto GetAllEntityIDsByType()
+		{
+			return m_Registry.GetComponentEntities<T>();
+		}
+
+		// Walks the hierarchy depth first, parents are visited before their children. The callback must not change the hierarchy.
+		template<typename Func>
+		void ForEachEntity(Func&& func)
+		{
+			m_Hierarchy.ForEachInSubtree(EntityId(), func);
+		}
 
 		static AssetType GetStaticType() { return AssetType::Scene; } // Good for templated functions
 		AssetType GetType() const { return GetStaticType(); }
@@ -178,12 +130,21 @@ namespace Engine {
 
 	private:
 
-		void FindNodeAndParent(SceneNode* current, UUID id, SceneNode** node, SceneNode** parent);
+		void RegisterSystems();
 
-		void UpdateWorldTransform(SceneNode* node, glm::mat4& parentWorldTransform);
 		void UpdateTransforms();
+		void PropagateTransforms(std::span<const EntityId> order, std::span<const uint32_t> level_offsets);
+		// Splits the depth order into the static subtrees that are final now and everything else
+		void RebuildDynamicOrder();
+		// Reads the parents' slots and writes the entities' own, safe to run for any part of one level at once
+		void UpdateTransformChunk(std::span<const EntityId> entities);
 		void DrawSystem();
 		void SyncPhysicsTransforms();
+		// World transforms of freshly created entities right away instead of on the next transform pass. Parents have
+		// to come before their children, parents outside of entities are taken as already placed.
+		void PlaceEntities(std::span<const EntityId> entities);
+		// Scripts and physics bodies for entities added while the scene is running
+		void SetupRuntimeEntities(std::span<const EntityId> entities);
 
 	private:
 		UUID m_ID = UUID();
@@ -193,10 +154,36 @@ namespace Engine {
 		std::string m_Name;
 
 		Registry m_Registry{};
-
-		SceneNode m_RootSceneNode = SceneNode(0);
-
-		std::unordered_map<UUID, Ref<Entity>> entities;
+		// Scripts, physics and transforms, run once per fixed step. The rest runs once per rendered frame.
+		SystemScheduler m_SimulationSystems;
+		SystemScheduler m_Systems;
+		EntityCommandBuffer m_Commands;
+
+		// Registry ticks at the end of the last run of the systems that skip unchanged components
+		uint32_t m_TransformsTick = 0;
+		// Taken after PhysicsSync rather than the push, so the poses copied from the bodies are not sent back
+		uint32_t m_PhysicsPushTick = 0;
+		uint32_t m_MeshTransformsTick = 0;
+
+		SceneHierarchy m_Hierarchy;
+		SpatialIndex m_SpatialIndex;
+		WorldPartition m_WorldPartition{ this };
+
+		// Scratch for the transform pass, indexed by EntityId::Index. The world transform an entity hands down
+		// to its children is its own, or its parent's when it has no TransformComponent, nullptr meaning identity.
+		std::vector<const WorldTransformComponent*> m_InheritedWorlds;
+		std::vector<uint8_t> m_WorldChanged;
+		bool m_ParallelTransforms = true;
+
+		// The depth order without static entities whose parents are static too, with its own level offsets
+		std::vector<EntityId> m_DynamicOrder;
+		std::vector<uint32_t> m_DynamicLevelOffsets;
+		// Static entities with a dynamic child, their scratch slots are refreshed before each pass
+		std::vector<EntityId> m_StaticBoundary;
+		uint32_t m_StaticHierarchyVersion = 0;
+		bool m_StaticTransformsDirty = true;
+
+		std::unordered_map<UUID, EntityId> m_EntityIDs;
 
 		bool m_IsReloading = false;
 
@@ -205,5 +192,6 @@ namespace Engine {
 		SkyboxSettings m_Skybox;
 
 		friend class Entity;
+		friend class WorldPartition;
 	};
 }
@@ -0,0 +1,231 @@
+#include "pch.h"
+#include "SceneHierarchy.h"
+
+namespace Engine {
+
+	void SceneHierarchy::Add(EntityId entity, EntityId parent)
+	{
+		if (!entity.IsValid())
+		{
+			return;
+		}
+		if (entity.Index >= m_Nodes.size())
+		{
+			m_Nodes.resize(entity.Index + 1);
+		}
+
+		m_Nodes[entity.Index] = Node();
+		m_Nodes[entity.Index].Entity = entity;
+		Link(entity.Index, Contains(parent) ? parent.Index : None);
+		MarkDirty();
+	}
+
+	void SceneHierarchy::Remove(EntityId entity)
+	{
+		if (!Contains(entity))
+		{
+			return;
+		}
+
+		uint32_t parent = m_Nodes[entity.Index].Parent;
+		for (uint32_t child = m_Nodes[entity.Index].FirstChild; child != None;)
+		{
+			uint32_t next = m_Nodes[child].NextSibling;
+			Unlink(child);
+			Link(child, parent);
+			child = next;
+		}
+
+		Unlink(entity.Index);
+		m_Nodes[entity.Index] = Node();
+		MarkDirty();
+	}
+
+	bool SceneHierarchy::Reparent(EntityId entity, EntityId new_parent)
+	{
+		if (!Contains(entity))
+		{
+			return false;
+		}
+
+		uint32_t parent = Contains(new_parent) ? new_parent.Index : None;
+		if (parent != None && (parent == entity.Index || IsDescendantOf(new_parent, entity)))
+		{
+			return false;
+		}
+
+		Unlink(entity.Index);
+		Link(entity.Index, parent);
+		MarkDirty();
+		return true;
+	}
+
+	void SceneHierarchy::Clear()
+	{
+		m_Root = Node();
+		m_Nodes.clear();
+		m_Order.clear();
+		m_LevelOffsets.clear();
+		m_OrderDirty = false;
+		m_Version++;
+	}
+
+	bool SceneHierarchy::Contains(EntityId entity) const
+	{
+		return entity.IsValid() && entity.Index < m_Nodes.size() && m_Nodes[entity.Index].Entity == entity;
+	}
+
+	EntityId SceneHierarchy::GetParent(EntityId entity) const
+	{
+		uint32_t parent = GetNode(entity).Parent;
+		return parent == None ? EntityId() : m_Nodes[parent].Entity;
+	}
+
+	EntityId SceneHierarchy::GetFirstChild(EntityId entity) const
+	{
+		uint32_t child = GetNode(entity).FirstChild;
+		return child == None ? EntityId() : m_Nodes[child].Entity;
+	}
+
+	EntityId SceneHierarchy::GetNextSibling(EntityId entity) const
+	{
+		if (!Contains(entity))
+		{
+			return EntityId();
+		}
+		uint32_t sibling = m_Nodes[entity.Index].NextSibling;
+		return sibling == None ? EntityId() : m_Nodes[sibling].Entity;
+	}
+
+	uint32_t SceneHierarchy::GetChildCount(EntityId entity) const
+	{
+		return GetNode(entity).ChildCount;
+	}
+
+	bool SceneHierarchy::IsDescendantOf(EntityId entity, EntityId ancestor) const
+	{
+		if (!Contains(entity))
+		{
+			return false;
+		}
+		if (!ancestor.IsValid())
+		{
+			return true;
+		}
+		for (uint32_t index = m_Nodes[entity.Index].Parent; index != None; index = m_Nodes[index].Parent)
+		{
+			if (index == ancestor.Index)
+			{
+				return m_Nodes[index].Entity == ancestor;
+			}
+		}
+		return false;
+	}
+
+	std::span<const EntityId> SceneHierarchy::GetDepthOrder()
+	{
+		if (m_OrderDirty)
+		{
+			RebuildOrder();
+		}
+		return m_Order;
+	}
+
+	std::span<const uint32_t> SceneHierarchy::GetLevelOffsets()
+	{
+		if (m_OrderDirty)
+		{
+			RebuildOrder();
+		}
+		return m_LevelOffsets;
+	}
+
+	const SceneHierarchy::Node& SceneHierarchy::GetNode(EntityId entity) const
+	{
+		return Contains(entity) ? m_Nodes[entity.Index] : m_Root;
+	}
+
+	SceneHierarchy::Node& SceneHierarchy::GetNode(EntityId entity)
+	{
+		return Contains(entity) ? m_Nodes[entity.Index] : m_Root;
+	}
+
+	void SceneHierarchy::Link(uint32_t index, uint32_t parent)
+	{
+		Node& node = m_Nodes[index];
+		Node& parent_node = GetSlot(parent);
+
+		node.Parent = parent;
+		node.PrevSibling = parent_node.LastChild;
+		node.NextSibling = None;
+		if (parent_node.LastChild != None)
+		{
+			m_Nodes[parent_node.LastChild].NextSibling = index;
+		}
+		else
+		{
+			parent_node.FirstChild = index;
+		}
+		parent_node.LastChild = index;
+		parent_node.ChildCount++;
+	}
+
+	void SceneHierarchy::Unlink(uint32_t index)
+	{
+		Node& node = m_Nodes[index];
+		Node& parent_node = GetSlot(node.Parent);
+
+		if (node.PrevSibling != None)
+		{
+			m_Nodes[node.PrevSibling].NextSibling = node.NextSibling;
+		}
+		else
+		{
+			parent_node.FirstChild = node.NextSibling;
+		}
+
+		if (node.NextSibling != None)
+		{
+			m_Nodes[node.NextSibling].PrevSibling = node.PrevSibling;
+		}
+		else
+		{
+			parent_node.LastChild = node.PrevSibling;
+		}
+
+		parent_node.ChildCount--;
+		node.Parent = None;
+		node.PrevSibling = None;
+		node.NextSibling = None;
+	}
+
+	// Breadth first, each level is the children of the previous one in order, so the whole pass is linear
+	void SceneHierarchy::RebuildOrder()
+	{
+		m_Order.clear();
+		m_LevelOffsets.clear();
+
+		for (uint32_t child = m_Root.FirstChild; child != None; child = m_Nodes[child].NextSibling)
+		{
+			m_Order.push_back(m_Nodes[child].Entity);
+		}
+
+		size_t level_begin = 0;
+		while (level_begin < m_Order.size())
+		{
+			m_LevelOffsets.push_back((uint32_t)level_begin);
+			size_t level_end = m_Order.size();
+			for (size_t i = level_begin; i < level_end; i++)
+			{
+				for (uint32_t child = m_Nodes[m_Order[i].Index].FirstChild; child != None; child = m_Nodes[child].NextSibling)
+				{
+					m_Order.push_back(m_Nodes[child].Entity);
+				}
+			}
+			level_begin = level_end;
+		}
+		m_LevelOffsets.push_back((uint32_t)m_Order.size());
+
+		m_OrderDirty = false;
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <vector>
+#include <span>
+#include "EntityId.h"
+
+namespace Engine {
+
+	// Parent/child links of a scene as a flat side table indexed by EntityId::Index. Every entity keeps its parent,
+	// first and last child and both siblings, so adding, removing and reparenting only relink a handful of slots.
+	// The invalid EntityId stands for the scene root. A depth sorted order of all entities is rebuilt lazily for
+	// passes that need parents before children.
+	class SceneHierarchy
+	{
+	public:
+		static constexpr uint32_t None = UINT32_MAX;
+
+		// Appends entity as the last child of parent, or of the root when parent is invalid or unknown
+		void Add(EntityId entity, EntityId parent = EntityId());
+		// The children of the entity are handed to its parent
+		void Remove(EntityId entity);
+		// Moves entity together with its subtree. Refused when new_parent is the entity itself or below it.
+		bool Reparent(EntityId entity, EntityId new_parent);
+		void Clear();
+
+		bool Contains(EntityId entity) const;
+		// Invalid EntityId for entities directly under the root
+		EntityId GetParent(EntityId entity) const;
+		EntityId GetFirstChild(EntityId entity) const;
+		EntityId GetNextSibling(EntityId entity) const;
+		uint32_t GetChildCount(EntityId entity) const;
+		// Walks up from entity, O(depth)
+		bool IsDescendantOf(EntityId entity, EntityId ancestor) const;
+
+		template<typename Func>
+		void ForEachChild(EntityId parent, Func&& func) const
+		{
+			for (uint32_t child = GetNode(parent).FirstChild; child != None;)
+			{
+				// Read the link first so the callback may reparent or remove the child
+				uint32_t next = m_Nodes[child].NextSibling;
+				func(m_Nodes[child].Entity);
+				child = next;
+			}
+		}
+
+		// Depth first with parents before children, without recursion so deep chains cannot run out of stack. An invalid
+		// entity walks the whole scene. The callback must not change the hierarchy.
+		template<typename Func>
+		void ForEachInSubtree(EntityId entity, Func&& func) const
+		{
+			uint32_t top = None;
+			if (entity.IsValid())
+			{
+				if (!Contains(entity))
+				{
+					return;
+				}
+				top = entity.Index;
+				func(entity);
+			}
+
+			for (uint32_t index = GetNode(entity).FirstChild; index != None;)
+			{
+				func(m_Nodes[index].Entity);
+				if (m_Nodes[index].FirstChild != None)
+				{
+					index = m_Nodes[index].FirstChild;
+					continue;
+				}
+				// Climb to the nearest ancestor with a sibling left, never above the subtree's own top
+				while (index != top && m_Nodes[index].NextSibling == None)
+				{
+					index = m_Nodes[index].Parent;
+				}
+				index = index == top ? None : m_Nodes[index].NextSibling;
+			}
+		}
+
+		// Every entity, parents before children and grouped by depth
+		std::span<const EntityId> GetDepthOrder();
+		// GetDepthOrder()[LevelOffsets[d], LevelOffsets[d + 1]) holds the entities at depth d
+		std::span<const uint32_t> GetLevelOffsets();
+		// Index of the parent in the slot arrays, None for entities directly under the root
+		uint32_t GetParentIndex(uint32_t entity_index) const { return m_Nodes[entity_index].Parent; }
+		uint32_t GetCapacity() const { return (uint32_t)m_Nodes.size(); }
+		// Bumped by every structural change, for callers that cache something derived from the order
+		uint32_t GetVersion() const { return m_Version; }
+
+	private:
+		struct Node
+		{
+			EntityId Entity;
+			uint32_t Parent = None;
+			uint32_t FirstChild = None;
+			uint32_t LastChild = None;
+			uint32_t PrevSibling = None;
+			uint32_t NextSibling = None;
+			uint32_t ChildCount = 0;
+		};
+
+		const Node& GetNode(EntityId entity) const;
+		Node& GetNode(EntityId entity);
+		Node& GetSlot(uint32_t index) { return index == None ? m_Root : m_Nodes[index]; }
+
+		void Link(uint32_t index, uint32_t parent);
+		void Unlink(uint32_t index);
+		void RebuildOrder();
+		void MarkDirty() { m_OrderDirty = true; m_Version++; }
+
+	private:
+		Node m_Root;
+		std::vector<Node> m_Nodes;
+
+		std::vector<EntityId> m_Order;
+		std::vector<uint32_t> m_LevelOffsets;
+		bool m_OrderDirty = false;
+		uint32_t m_Version = 0;
+	};
+}
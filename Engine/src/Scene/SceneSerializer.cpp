@@ -6,12 +6,17 @@
 #include "Assets/AssetTypes.h"
 #include "Assets/ModelImporter.h"
 #include "Scene/Scene.h"
+#include "Scene/Prefab.h"
 #include "Assets/DesignAssetManager.h"
 
 namespace Engine{
 
 	void SceneSerializer::Serializer(const std::filesystem::path& directory, Scene* scene)
 	{
+		// Cells go first, saving them can move entities out of the scene
+		WorldPartition& world_partition = scene->GetWorldPartition();
+		world_partition.SaveCells(directory.has_extension() ? directory.parent_path() : directory, scene->GetName());
+
 		auto skybox_settings = scene->GetSkybox();
 		YAML::Emitter out;
 		out << YAML::BeginMap;
@@ -24,20 +29,19 @@ namespace Engine{
 		out << YAML::Key << "Texture" << YAML::Value << skybox_settings.Texture->Handle;
 		out << YAML::Key << "Brightness" << YAML::Value << skybox_settings.Brightness;
 		out << YAML::EndMap;
+		world_partition.Serialize(out);
 		out << YAML::EndMap;
 
-		auto rootNode = scene->GetRootNode();
-		if (rootNode)
+		out << YAML::Key << "Entities";
+		out << YAML::BeginSeq;
+		scene->GetHierarchy().ForEachChild(EntityId(), [&](EntityId child) // The root itself is not an entity and is not serialized
 		{
-			out << YAML::Key << "Entities";
-			out << YAML::BeginSeq;
-			auto children = rootNode->GetChildren(); // We do this here because we dont want to serialize the root node
-			for (size_t i = 0; i < children->size(); i++)
+			if (!world_partition.IsPartitioned(child))
 			{
-				TraverseTree(out, children->at(i).get(), scene);
+				TraverseTree(out, child, scene);
 			}
-			out << YAML::EndSeq;
-		}
+		});
+		out << YAML::EndSeq;
 
 		out << YAML::EndMap;
 
@@ -91,6 +95,8 @@ namespace Engine{
 
 		Ref<Scene> new_scene = CreateRef<Scene>(sceneName);
 		new_scene->SetSkybox(skybox_settings);
+		// Only the cell index, the cells themselves stream in around the camera
+		new_scene->GetWorldPartition().Deserialize(root_node["Scene"]["WorldPartition"]);
 
 		if (root_node["Entities"])
 		{
@@ -98,64 +104,194 @@ namespace Engine{
 			for (YAML::const_iterator it = entities.begin(); it != entities.end(); ++it)
 			{
 				YAML::Node entity_node = *it;
-				DeserializeEntity(entity_node, new_scene, nullptr);
+				DeserializeEntity(entity_node, new_scene.get(), EntityId());
 			}
 		}
 
 		return new_scene;
 	}
 
-	void SceneSerializer::TraverseTree(YAML::Emitter& out, SceneNode* scene_node, Scene* scene)
+	void SceneSerializer::SerializePrefab(const std::filesystem::path& filepath, Entity root)
+	{
+		YAML::Emitter out;
+		EmitPrefab(out, root);
+
+		std::filesystem::path full_path = filepath;
+		if (!full_path.is_absolute())
+		{
+			full_path = Project::GetFullFilePath(full_path);
+		}
+		if (full_path.has_parent_path() && !std::filesystem::exists(full_path.parent_path()))
+		{
+			std::filesystem::create_directories(full_path.parent_path());
+		}
+
+		std::ofstream fout(full_path);
+		HVE_CORE_ASSERT(fout, "Failed to open file for writing: {0}", full_path);
+
+		fout << out.c_str();
+		fout.close();
+		HVE_CORE_ASSERT(!fout.fail(), "Failed to write data to file: {0}", full_path);
+		HVE_CORE_TRACE_TAG("Scene Serializer", "Prefab saved successfully to: {0}", full_path);
+	}
+
+	Ref<Prefab> SceneSerializer::DeserializePrefab(const std::filesystem::path& filepath)
+	{
+		std::string full_file_path = Project::GetFullFilePath(filepath).string();
+		YAML::Node root_node = YAML::LoadFile(full_file_path);
+		if (!root_node["Prefab"])
+		{
+			HVE_CORE_ERROR_TAG("Scene Deserializer", "File {0}, is not a proper prefab file", filepath.string());
+			return nullptr;
+		}
+		return LoadPrefab(root_node);
+	}
+
+	Ref<Prefab> SceneSerializer::CopyToPrefab(Entity root)
+	{
+		YAML::Emitter out;
+		EmitPrefab(out, root);
+		return LoadPrefab(YAML::Load(out.c_str()));
+	}
+
+	void SceneSerializer::EmitPrefab(YAML::Emitter& out, Entity root)
+	{
+		out << YAML::BeginMap;
+		out << YAML::Key << "Prefab";
+		out << YAML::BeginMap;
+		out << YAML::Key << "Name" << YAML::Value << root.GetComponent<TagComponent>()->name;
+		out << YAML::EndMap;
+
+		out << YAML::Key << "Entities";
+		out << YAML::BeginSeq;
+		if (root.GetScene()->GetHierarchy().Contains(root.GetID()))
+		{
+			TraverseTree(out, root.GetID(), root.GetScene());
+		}
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+	}
+
+	Ref<Prefab> SceneSerializer::LoadPrefab(YAML::Node root_node)
+	{
+		Ref<Scene> prefab_scene = CreateRef<Scene>(root_node["Prefab"]["Name"].as<std::string>("Prefab"));
+
+		if (root_node["Entities"])
+		{
+			for (const auto& entity_node : root_node["Entities"])
+			{
+				DeserializeEntity(entity_node, prefab_scene.get(), EntityId());
+			}
+		}
+
+		return CreateRef<Prefab>(prefab_scene);
+	}
+
+	void SceneSerializer::SerializeCell(const std::filesystem::path& filepath, Scene* scene, std::span<const EntityId> roots, const YAML::Node* kept_entities)
+	{
+		YAML::Emitter out;
+		out << YAML::BeginMap;
+		out << YAML::Key << "Cell";
+		out << YAML::BeginMap;
+		out << YAML::Key << "Scene" << YAML::Value << scene->GetName();
+		out << YAML::EndMap;
+
+		out << YAML::Key << "Entities";
+		out << YAML::BeginSeq;
+		if (kept_entities && kept_entities->IsSequence())
+		{
+			for (const auto& entity_node : *kept_entities)
+			{
+				out << entity_node;
+			}
+		}
+		for (EntityId root : roots)
+		{
+			TraverseTree(out, root, scene);
+		}
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+
+		if (filepath.has_parent_path() && !std::filesystem::exists(filepath.parent_path()))
+		{
+			std::filesystem::create_directories(filepath.parent_path());
+		}
+
+		std::ofstream fout(filepath);
+		HVE_CORE_ASSERT(fout, "Failed to open file for writing: {0}", filepath);
+
+		fout << out.c_str();
+		fout.close();
+		HVE_CORE_ASSERT(!fout.fail(), "Failed to write data to file: {0}", filepath);
+	}
+
+	std::vector<EntityId> SceneSerializer::DeserializeEntities(const YAML::Node& entities, Scene* scene)
+	{
+		std::vector<EntityId> roots;
+		if (!entities || !entities.IsSequence())
+		{
+			return roots;
+		}
+		roots.reserve(entities.size());
+		for (const auto& entity_node : entities)
+		{
+			roots.push_back(DeserializeEntity(entity_node, scene, EntityId()));
+		}
+		return roots;
+	}
+
+	void SceneSerializer::TraverseTree(YAML::Emitter& out, EntityId entity_id, Scene* scene)
 	{
 		out << YAML::BeginMap;
-		SerializeEntity(out, scene->GetEntity(scene_node->GetID()));
+		SerializeEntity(out, scene->GetEntity(entity_id));
 
-		if (!scene_node->GetChildren()->empty())
+		if (scene->GetHierarchy().GetChildCount(entity_id) > 0)
 		{
 			out << YAML::Key << "Children";
 			out << YAML::BeginSeq;
-			for (size_t i = 0; i < scene_node->GetChildren()->size(); i++)
+			scene->GetHierarchy().ForEachChild(entity_id, [&](EntityId child)
 			{
-				TraverseTree(out, scene_node->GetChildren()->at(i).get(), scene);
-			}
+				TraverseTree(out, child, scene);
+			});
 			out << YAML::EndSeq;
 		}
 		out << YAML::EndMap;
 
 	}
-	void SceneSerializer::SerializeEntity(YAML::Emitter& out, Entity* entity)
+	void SceneSerializer::SerializeEntity(YAML::Emitter& out, Entity entity)
 	{
-		out << YAML::Key << "Entity" << YAML::Value << entity->GetID();
+		out << YAML::Key << "Entity" << YAML::Value << entity.GetUUID();
 
-		if (entity->HasComponent<TagComponent>())
+		if (entity.HasComponent<TagComponent>())
 		{
-			out << YAML::Key << "Tag" << YAML::Value << entity->GetComponent<TagComponent>()->name;
+			out << YAML::Key << "Tag" << YAML::Value << entity.GetComponent<TagComponent>()->name;
 		}
 
 
-		if (entity->HasComponent<TransformComponent>())
+		if (entity.HasComponent<TransformComponent>())
 		{
-			auto transform = entity->GetComponent<TransformComponent>();
+			auto transform = entity.GetComponent<TransformComponent>();
 			out << YAML::Key << "LocalTransformComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "Position" << YAML::Value << transform->local_transform.translation;
-			out << YAML::Key << "Rotation" << YAML::Value << transform->local_transform.rotation;
+			out << YAML::Key << "Rotation" << YAML::Value << transform->local_transform.rotation_euler;
 			out << YAML::Key << "Scale" << YAML::Value << transform->local_transform.scale;
+			out << YAML::Key << "Mobility" << YAML::Value << MobilityToString(transform->mobility);
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<ScriptComponent>())
+		if (entity.HasComponent<ScriptComponent>())
 		{
-			auto scriptcomp = entity->GetComponent<ScriptComponent>();
+			auto scriptcomp = entity.GetComponent<ScriptComponent>();
 			out << YAML::Key << "Script";
 			out << YAML::BeginMap;
 			out << YAML::Key << "ClassName" << YAML::Value << scriptcomp->Name;
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<CameraComponent>())
+		if (entity.HasComponent<CameraComponent>())
 		{
-			auto& camera = entity->GetComponent<CameraComponent>()->camera;
+			auto& camera = entity.GetComponent<CameraComponent>()->camera;
 			out << YAML::Key << "Camera";
 			out << YAML::BeginMap;
 			out << YAML::Key << "ProjectionType" << YAML::Value << (int)camera.GetType();
@@ -163,13 +299,13 @@ namespace Engine{
 			out << YAML::Key << "Near" << YAML::Value << camera.GetNear();
 			out << YAML::Key << "Far" << YAML::Value << camera.GetFar();
 			out << YAML::Key << "Zoom" << YAML::Value << camera.GetZoomDistance();
-			out << YAML::Key << "IsPrimary" << YAML::Value << entity->GetComponent<CameraComponent>()->IsPrimary;
+			out << YAML::Key << "IsPrimary" << YAML::Value << entity.GetComponent<CameraComponent>()->IsPrimary;
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<PointLightComponent>())
+		if (entity.HasComponent<PointLightComponent>())
 		{
-			auto light = entity->GetComponent<PointLightComponent>()->light;
+			auto light = entity.GetComponent<PointLightComponent>()->light;
 			out << YAML::Key << "PointLight";
 			out << YAML::BeginMap;
 			out << YAML::Key << "Color" << YAML::Value << light.GetColor();
@@ -180,9 +316,9 @@ namespace Engine{
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<DirectionalLightComponent>())
+		if (entity.HasComponent<DirectionalLightComponent>())
 		{
-			auto light = entity->GetComponent<DirectionalLightComponent>()->light;
+			auto light = entity.GetComponent<DirectionalLightComponent>()->light;
 			out << YAML::Key << "DirectionalLight";
 			out << YAML::BeginMap;
 			out << YAML::Key << "Color" << YAML::Value << light.GetColor();
@@ -192,18 +328,20 @@ namespace Engine{
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<MeshComponent>())
+		if (entity.HasComponent<MeshComponent>())
 		{
-			auto mesh = entity->GetComponent<MeshComponent>()->mesh;
+			auto mesh_component = entity.GetComponent<MeshComponent>();
 			out << YAML::Key << "Mesh";
 			out << YAML::BeginMap;
-			out << YAML::Key << "Handle" << YAML::Value << mesh->GetMeshSource()->Handle;
+			out << YAML::Key << "Handle" << YAML::Value << mesh_component->mesh->GetMeshSource()->Handle;
+			out << YAML::Key << "LODBias" << YAML::Value << mesh_component->lod_bias;
+			out << YAML::Key << "ForcedLOD" << YAML::Value << mesh_component->forced_lod;
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<BoxColliderComponent>())
+		if (entity.HasComponent<BoxColliderComponent>())
 		{
-			auto collider = entity->GetComponent<BoxColliderComponent>();
+			auto collider = entity.GetComponent<BoxColliderComponent>();
 			out << YAML::Key << "BoxCollider";
 			out << YAML::BeginMap;
 			out << YAML::Key << "HalfSize" << YAML::Value << collider->HalfSize;
@@ -215,9 +353,9 @@ namespace Engine{
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<SphereColliderComponent>())
+		if (entity.HasComponent<SphereColliderComponent>())
 		{
-			auto collider = entity->GetComponent<SphereColliderComponent>();
+			auto collider = entity.GetComponent<SphereColliderComponent>();
 			out << YAML::Key << "SphereCollider";
 			out << YAML::BeginMap;
 			out << YAML::Key << "Radius" << YAML::Value << collider->Radius;
@@ -229,9 +367,9 @@ namespace Engine{
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<CharacterControllerComponent>())
+		if (entity.HasComponent<CharacterControllerComponent>())
 		{
-			auto collider = entity->GetComponent<CharacterControllerComponent>();
+			auto collider = entity.GetComponent<CharacterControllerComponent>();
 			out << YAML::Key << "CharacterController";
 			out << YAML::BeginMap;
 			out << YAML::Key << "Radius" << YAML::Value << collider->Radius;
@@ -243,9 +381,9 @@ namespace Engine{
 			out << YAML::EndMap;
 		}
 
-		if (entity->HasComponent<GlobalSoundsComponent>())
+		if (entity.HasComponent<GlobalSoundsComponent>())
 		{
-			auto& sounds_vector = entity->GetComponent<GlobalSoundsComponent>()->Sounds;
+			auto& sounds_vector = entity.GetComponent<GlobalSoundsComponent>()->Sounds;
 
 			out << YAML::Key << "GlobalSounds";
 			out << YAML::BeginSeq;
@@ -263,9 +401,9 @@ namespace Engine{
 			out << YAML::EndSeq;
 		}
 
-		if (entity->HasComponent<LocalSoundsComponent>())
+		if (entity.HasComponent<LocalSoundsComponent>())
 		{
-			auto& sounds_vector = entity->GetComponent<LocalSoundsComponent>()->Sounds;
+			auto& sounds_vector = entity.GetComponent<LocalSoundsComponent>()->Sounds;
 
 			out << YAML::Key << "LocalSounds";
 			out << YAML::BeginSeq;
@@ -284,7 +422,7 @@ namespace Engine{
 			out << YAML::EndSeq;
 		}
 	}
-	void SceneSerializer::DeserializeEntity(YAML::Node entity_node, Ref<Scene> scene, UUID* parent_entity_id)
+	EntityId SceneSerializer::DeserializeEntity(YAML::Node entity_node, Scene* scene, EntityId parent_entity_id)
 	{
 		UUID entity_id = entity_node["Entity"].as<uint64_t>();
 		std::string name = "New Entity";
@@ -292,17 +430,21 @@ namespace Engine{
 		{
 			name = entity_node["Tag"].as<std::string>();
 		}
-		EntityHandle* entity = scene->CreateEntityByUUID(entity_id, name, parent_entity_id);
+		Entity entity = scene->CreateEntityByUUID(entity_id, name, parent_entity_id);
 
 		TransformComponent entity_transform{};
 
 		if (entity_node["LocalTransformComponent"])
 		{
 			entity_transform.local_transform.translation = entity_node["LocalTransformComponent"]["Position"].as<glm::vec3>(glm::vec3(0.0f));
-			entity_transform.local_transform.rotation = entity_node["LocalTransformComponent"]["Rotation"].as<glm::vec3>(glm::vec3(0.0f));
+			entity_transform.local_transform.SetRotationEuler(entity_node["LocalTransformComponent"]["Rotation"].as<glm::vec3>(glm::vec3(0.0f)));
 			entity_transform.local_transform.scale = entity_node["LocalTransformComponent"]["Scale"].as<glm::vec3>(glm::vec3(0.0f));
+			if (entity_node["LocalTransformComponent"]["Mobility"])
+			{
+				entity_transform.mobility = MobilityFromString(entity_node["LocalTransformComponent"]["Mobility"].as<std::string>());
+			}
 		}
-		scene->GetEntity(entity)->AddComponent<TransformComponent>(entity_transform);
+		entity.AddComponent<TransformComponent>(entity_transform);
 
 		if (entity_node["Camera"])
 		{
@@ -316,14 +458,14 @@ namespace Engine{
 				camera_component.camera.SetZoomDistance(entity_node["Camera"]["Zoom"].as<float>());
 			}
 			camera_component.IsPrimary = entity_node["Camera"]["IsPrimary"].as<bool>();
-			scene->GetEntity(entity)->AddComponent<CameraComponent>(camera_component);
+			entity.AddComponent<CameraComponent>(camera_component);
 		}
 
 		if (entity_node["Script"])
 		{
 			auto script_component = ScriptComponent{};
 			script_component.Name = entity_node["Script"]["ClassName"].as<std::string>();
-			scene->GetEntity(entity)->AddComponent<ScriptComponent>(script_component);
+			entity.AddComponent<ScriptComponent>(script_component);
 		}
 
 		
@@ -344,7 +486,7 @@ namespace Engine{
 				light.light.CastShadows(entity_node["PointLight"]["IsCastingShadows"].as<bool>());
 			}
 
-			scene->GetEntity(entity)->AddComponent<PointLightComponent>(light);
+			entity.AddComponent<PointLightComponent>(light);
 		}
 
 		if (entity_node["DirectionalLight"])
@@ -361,7 +503,7 @@ namespace Engine{
 				light.light.CastShadows(entity_node["DirectionalLight"]["IsCastingShadows"].as<bool>());
 			}
 
-			scene->GetEntity(entity)->AddComponent<DirectionalLightComponent>(light);
+			entity.AddComponent<DirectionalLightComponent>(light);
 		}
 
 		if (entity_node["Mesh"])
@@ -369,7 +511,9 @@ namespace Engine{
 			MeshComponent mesh_comp{};
 			Ref<MeshSource> source = AssetManager::GetAsset<MeshSource>(entity_node["Mesh"]["Handle"].as<AssetHandle>(0));
 			mesh_comp.mesh = CreateRef<Mesh>(source);
-			scene->GetEntity(entity)->AddComponent<MeshComponent>(mesh_comp);
+			mesh_comp.lod_bias = entity_node["Mesh"]["LODBias"].as<float>(1.0f);
+			mesh_comp.forced_lod = entity_node["Mesh"]["ForcedLOD"].as<int>(-1);
+			entity.AddComponent<MeshComponent>(mesh_comp);
 		}
 
 		if (entity_node["BoxCollider"])
@@ -381,7 +525,7 @@ namespace Engine{
 			collider.Friction = entity_node["BoxCollider"]["Friction"].as<float>();
 			collider.Restitution = entity_node["BoxCollider"]["Restitution"].as<float>();
 			collider.Mass = entity_node["BoxCollider"]["Mass"].as<float>();
-			scene->GetEntity(entity)->AddComponent<BoxColliderComponent>(collider);
+			entity.AddComponent<BoxColliderComponent>(collider);
 		}
 
 		if (entity_node["SphereCollider"])
@@ -393,7 +537,7 @@ namespace Engine{
 			collider.Restitution = entity_node["SphereCollider"]["Restitution"].as<float>();
 			collider.Mass = entity_node["SphereCollider"]["Mass"].as<float>();
 			collider.MotionType = FromStringToMotionType(entity_node["SphereCollider"]["MotionType"].as<std::string>());
-			scene->GetEntity(entity)->AddComponent<SphereColliderComponent>(collider);
+			entity.AddComponent<SphereColliderComponent>(collider);
 		}
 
 		if (entity_node["CharacterController"])
@@ -405,7 +549,7 @@ namespace Engine{
 			collider.Mass = entity_node["CharacterController"]["Mass"].as<float>();
 			collider.Friction = entity_node["CharacterController"]["Friction"].as<float>();
 			collider.Restitution = entity_node["CharacterController"]["Restitution"].as<float>();
-			scene->GetEntity(entity)->AddComponent<CharacterControllerComponent>(collider);
+			entity.AddComponent<CharacterControllerComponent>(collider);
 		}
 
 		if (entity_node["GlobalSounds"])
@@ -433,7 +577,7 @@ namespace Engine{
 
 			GlobalSoundsComponent new_comp{};
 			new_comp.Sounds = sounds_vector;
-			scene->GetEntity(entity)->AddComponent<GlobalSoundsComponent>(new_comp);
+			entity.AddComponent<GlobalSoundsComponent>(new_comp);
 		}
 
 		if (entity_node["LocalSounds"])
@@ -463,7 +607,7 @@ namespace Engine{
 
 			LocalSoundsComponent new_comp{};
 			new_comp.Sounds = sounds_vector;
-			scene->GetEntity(entity)->AddComponent<LocalSoundsComponent>(new_comp);
+			entity.AddComponent<LocalSoundsComponent>(new_comp);
 		}
 
 
@@ -471,9 +615,10 @@ namespace Engine{
 		{
 			for (const auto& child_node : entity_node["Children"])
 			{
-				DeserializeEntity(child_node, scene, &entity_id);
+				DeserializeEntity(child_node, scene, entity.GetID());
 			}
 		}
 
+		return entity.GetID();
 	}
 }
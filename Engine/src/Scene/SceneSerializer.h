@@ -1,4 +1,6 @@
 #pragma once
+#include <span>
+#include "EntityId.h"
 
 namespace YAML {
 	class Emitter;
@@ -6,9 +8,9 @@ namespace YAML {
 }
 
 namespace Engine {
-	class SceneNode;
 	class Scene;
 	class Entity;
+	class Prefab;
 
 	class SceneSerializer
 	{
@@ -16,9 +18,23 @@ namespace Engine {
 		static void Serializer(const std::filesystem::path& directory, Scene* scene);
 		static Ref<Scene> Deserializer(const std::filesystem::path& filepath);
 
+		// Prefab files hold a single entity subtree in the same format as the entities of a scene
+		static void SerializePrefab(const std::filesystem::path& filepath, Entity root);
+		static Ref<Prefab> DeserializePrefab(const std::filesystem::path& filepath);
+		// Round trips the subtree through YAML, so the prefab gets its own meshes and sounds like a loaded one
+		static Ref<Prefab> CopyToPrefab(Entity root);
+
+		// World partition cells hold root level subtrees in the same format as the entities of a scene. The entity
+		// nodes in kept_entities, read from the cell's previous file, are written out again ahead of roots.
+		static void SerializeCell(const std::filesystem::path& filepath, Scene* scene, std::span<const EntityId> roots, const YAML::Node* kept_entities = nullptr);
+		// Creates the entities of an Entities sequence under the scene root, returns the roots
+		static std::vector<EntityId> DeserializeEntities(const YAML::Node& entities, Scene* scene);
+
 	private:
-		static void TraverseTree(YAML::Emitter& out, SceneNode* scene_node, Scene* scene);
-		static void SerializeEntity(YAML::Emitter& out, Entity* entity);
-		static void DeserializeEntity(YAML::Node entity_node, Ref<Scene> scene, UUID* parent_entity_id);
+		static void TraverseTree(YAML::Emitter& out, EntityId entity_id, Scene* scene);
+		static void SerializeEntity(YAML::Emitter& out, Entity entity);
+		static EntityId DeserializeEntity(YAML::Node entity_node, Scene* scene, EntityId parent_entity_id);
+		static void EmitPrefab(YAML::Emitter& out, Entity root);
+		static Ref<Prefab> LoadPrefab(YAML::Node root_node);
 	};
 }
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "SpatialIndex.h"
+
+namespace Engine {
+
+	void SpatialIndex::Update(EntityId entity_id, const Math::BoundingBox& bounds)
+	{
+		if (bounds.IsEmpty())
+		{
+			Remove(entity_id);
+			return;
+		}
+
+		if (entity_id.Index >= m_Slots.size())
+		{
+			m_Slots.resize(entity_id.Index + 1);
+		}
+
+		// A proxy left behind by an earlier entity in the same slot is replaced
+		Slot& slot = m_Slots[entity_id.Index];
+		if (slot.Proxy != Math::DynamicAABBTree::Null && GetEntity(slot.Proxy) != entity_id)
+		{
+			m_Tree.DestroyProxy(slot.Proxy);
+			slot.Proxy = Math::DynamicAABBTree::Null;
+		}
+
+		glm::vec3 center = bounds.GetCenter();
+		if (slot.Proxy == Math::DynamicAABBTree::Null)
+		{
+			slot.Proxy = m_Tree.CreateProxy(bounds, entity_id.Pack());
+		}
+		else
+		{
+			m_Tree.MoveProxy(slot.Proxy, bounds, center - slot.Center);
+		}
+		slot.Center = center;
+	}
+
+	void SpatialIndex::Remove(EntityId entity_id)
+	{
+		if (!Contains(entity_id))
+		{
+			return;
+		}
+
+		Slot& slot = m_Slots[entity_id.Index];
+		m_Tree.DestroyProxy(slot.Proxy);
+		slot = Slot();
+	}
+
+	void SpatialIndex::Clear()
+	{
+		m_Tree.Clear();
+		m_Slots.clear();
+	}
+
+	bool SpatialIndex::Contains(EntityId entity_id) const
+	{
+		return entity_id.Index < m_Slots.size()
+			&& m_Slots[entity_id.Index].Proxy != Math::DynamicAABBTree::Null
+			&& GetEntity(m_Slots[entity_id.Index].Proxy) == entity_id;
+	}
+
+	std::vector<EntityId> SpatialIndex::Query(const Math::BoundingBox& bounds) const
+	{
+		std::vector<EntityId> result;
+		Query(bounds, [&result](EntityId entity_id) { result.push_back(entity_id); return true; });
+		return result;
+	}
+
+	std::vector<EntityId> SpatialIndex::QuerySphere(const glm::vec3& center, float radius) const
+	{
+		std::vector<EntityId> result;
+		QuerySphere(center, radius, [&result](EntityId entity_id) { result.push_back(entity_id); return true; });
+		return result;
+	}
+
+	std::vector<EntityId> SpatialIndex::QueryFrustum(const Math::Frustum& frustum) const
+	{
+		std::vector<EntityId> result;
+		QueryFrustum(frustum, [&result](EntityId entity_id) { result.push_back(entity_id); return true; });
+		return result;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include "EntityId.h"
+#include "Math/DynamicAABBTree.h"
+
+namespace Engine {
+
+	// Scene wide index over the world bounds of every mesh, kept current by the MeshTransforms system. Results are
+	// conservative, boxes are fattened a little, so callers wanting exact answers test the entities they get back.
+	// Callbacks return false to stop early, except RayCast's, see DynamicAABBTree::RayCast.
+	class SpatialIndex
+	{
+	public:
+		// Inserts or moves the entity's proxy, an empty box removes it
+		void Update(EntityId entity_id, const Math::BoundingBox& bounds);
+		void Remove(EntityId entity_id);
+		// Drops the proxies of entities pred(EntityId) returns true for
+		template<typename Pred>
+		void RemoveIf(Pred&& pred)
+		{
+			for (const Slot& slot : m_Slots)
+			{
+				if (slot.Proxy == Math::DynamicAABBTree::Null)
+				{
+					continue;
+				}
+				EntityId entity_id = GetEntity(slot.Proxy);
+				if (pred(entity_id))
+				{
+					Remove(entity_id);
+				}
+			}
+		}
+		void Clear();
+
+		bool Contains(EntityId entity_id) const;
+		uint32_t GetCount() const { return m_Tree.GetProxyCount(); }
+		const Math::DynamicAABBTree& GetTree() const { return m_Tree; }
+
+		template<typename Func>
+		void Query(const Math::BoundingBox& bounds, Func&& func) const
+		{
+			m_Tree.Query(bounds, [this, &func](int32_t proxy) { return func(GetEntity(proxy)); });
+		}
+
+		template<typename Func>
+		void QuerySphere(const glm::vec3& center, float radius, Func&& func) const
+		{
+			m_Tree.QuerySphere(center, radius, [this, &func](int32_t proxy) { return func(GetEntity(proxy)); });
+		}
+
+		template<typename Func>
+		void QueryFrustum(const Math::Frustum& frustum, Func&& func) const
+		{
+			m_Tree.QueryFrustum(frustum, [this, &func](int32_t proxy) { return func(GetEntity(proxy)); });
+		}
+
+		// func(EntityId, float t) returns the new maximum distance
+		template<typename Func>
+		void RayCast(const Math::Ray& ray, float max_distance, Func&& func) const
+		{
+			m_Tree.RayCast(ray, max_distance, [this, &func](int32_t proxy, float t) { return func(GetEntity(proxy), t); });
+		}
+
+		// Collecting versions for callers that are not hot
+		std::vector<EntityId> Query(const Math::BoundingBox& bounds) const;
+		std::vector<EntityId> QuerySphere(const glm::vec3& center, float radius) const;
+		std::vector<EntityId> QueryFrustum(const Math::Frustum& frustum) const;
+
+	private:
+		EntityId GetEntity(int32_t proxy) const { return EntityId::Unpack(m_Tree.GetUserData(proxy)); }
+
+	private:
+		struct Slot
+		{
+			int32_t Proxy = Math::DynamicAABBTree::Null;
+			// Center of the last tight box, to tell the tree which way the entity is moving
+			glm::vec3 Center = glm::vec3(0.0f);
+		};
+
+		Math::DynamicAABBTree m_Tree;
+		// Indexed by EntityId::Index
+		std::vector<Slot> m_Slots;
+	};
+}
@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "SystemScheduler.h"
+
+#include <thread>
+
+namespace Engine {
+
+	static bool SystemsConflict(const SystemDesc& a, const SystemDesc& b)
+	{
+		return (a.Writes & (b.Reads | b.Writes)).any() || (a.Reads & b.Writes).any();
+	}
+
+	void SystemScheduler::AddSystem(SystemDesc desc)
+	{
+		m_Systems.push_back({ std::move(desc), {}, 0 });
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::Clear()
+	{
+		m_Systems.clear();
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		for (auto& system : m_Systems)
+		{
+			system.Dependents.clear();
+			system.DependencyCount = 0;
+		}
+
+		for (uint32_t later = 0; later < m_Systems.size(); later++)
+		{
+			for (uint32_t earlier = 0; earlier < later; earlier++)
+			{
+				if (SystemsConflict(m_Systems[earlier].Desc, m_Systems[later].Desc))
+				{
+					m_Systems[earlier].Dependents.push_back(later);
+					m_Systems[later].DependencyCount++;
+				}
+			}
+		}
+
+		m_Remaining = CreateScope<std::atomic<uint32_t>[]>(m_Systems.size());
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Run()
+	{
+		HVE_PROFILE_FUNC();
+		if (m_GraphDirty)
+		{
+			BuildGraph();
+		}
+
+		uint32_t system_count = (uint32_t)m_Systems.size();
+		for (uint32_t i = 0; i < system_count; i++)
+		{
+			m_Remaining[i].store(m_Systems[i].DependencyCount, std::memory_order_relaxed);
+		}
+		m_Completed.store(0, std::memory_order_release);
+
+		for (uint32_t i = 0; i < system_count; i++)
+		{
+			if (m_Systems[i].DependencyCount == 0)
+			{
+				Dispatch(i);
+			}
+		}
+
+		while (m_Completed.load(std::memory_order_acquire) < system_count)
+		{
+			uint32_t main_thread_system = UINT32_MAX;
+			{
+				std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+				if (!m_MainThreadQueue.empty())
+				{
+					main_thread_system = m_MainThreadQueue.back();
+					m_MainThreadQueue.pop_back();
+				}
+			}
+
+			if (main_thread_system != UINT32_MAX)
+			{
+				Execute(main_thread_system);
+			}
+			else if (!JobSystem::RunPendingJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// Jobs decrement their counter after Execute returns, don't let the next frame start before that
+		JobSystem::Wait(m_Jobs);
+	}
+
+	void SystemScheduler::Dispatch(uint32_t index)
+	{
+		if (m_Systems[index].Desc.MainThread)
+		{
+			std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+			m_MainThreadQueue.push_back(index);
+			return;
+		}
+
+		JobSystem::Submit([this, index]() { Execute(index); }, &m_Jobs);
+	}
+
+	void SystemScheduler::Execute(uint32_t index)
+	{
+		SystemNode& system = m_Systems[index];
+		{
+			HVE_PROFILE_SCOPE_DYNAMIC(system.Desc.Name.c_str());
+			system.Desc.Run();
+		}
+
+		for (uint32_t dependent : system.Dependents)
+		{
+			if (m_Remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				Dispatch(dependent);
+			}
+		}
+		m_Completed.fetch_add(1, std::memory_order_acq_rel);
+	}
+}
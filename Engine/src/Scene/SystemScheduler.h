@@ -0,0 +1,75 @@
+#pragma once
+#include <bitset>
+#include <atomic>
+#include <mutex>
+#include "Registry.h"
+#include "Core/JobSystem.h"
+
+namespace Engine {
+
+	using ComponentMask = std::bitset<MaxComponentTypes>;
+
+	template<typename... Components>
+	ComponentMask MakeComponentMask()
+	{
+		ComponentMask mask;
+		(mask.set(ComponentTypeID<Components>::Value), ...);
+		return mask;
+	}
+
+	struct SystemDesc
+	{
+		std::string Name;
+		ComponentMask Reads;
+		ComponentMask Writes;
+		// Anything that calls into Mono, OpenGL or other thread bound APIs has to stay on the main thread
+		bool MainThread = false;
+		std::function<void()> Run;
+	};
+
+	// Runs a fixed list of systems every frame. Two systems are ordered (in registration order) when one
+	// writes a component the other reads or writes, everything else is free to run at the same time on
+	// the JobSystem. Main thread systems are run by the thread that calls Run().
+	class SystemScheduler
+	{
+	public:
+		void AddSystem(SystemDesc desc);
+		void Clear();
+
+		// Blocks until every system has run once
+		void Run();
+
+	private:
+		void BuildGraph();
+		void Dispatch(uint32_t index);
+		void Execute(uint32_t index);
+
+	private:
+		struct SystemNode
+		{
+			SystemDesc Desc;
+			std::vector<uint32_t> Dependents;
+			uint32_t DependencyCount = 0;
+		};
+
+		std::vector<SystemNode> m_Systems;
+		Scope<std::atomic<uint32_t>[]> m_Remaining;
+		bool m_GraphDirty = true;
+
+		std::atomic<uint32_t> m_Completed = 0;
+		std::mutex m_MainThreadMutex;
+		std::vector<uint32_t> m_MainThreadQueue;
+		JobCounter m_Jobs;
+	};
+
+	// Splits a view into chunks on the JobSystem. The callback runs concurrently, so it may only touch the
+	// components handed to it and must not add or remove components.
+	template<typename... Components, typename Func>
+	void ParallelEach(Registry& registry, Func&& func, size_t grain_size = 64)
+	{
+		auto view = registry.View<Components...>();
+		JobSystem::ParallelFor(view.SizeHint(), grain_size, [&](size_t begin, size_t end) {
+			view.EachInRange(begin, end, func);
+		});
+	}
+}
@@ -0,0 +1,455 @@
+#include "pch.h"
+#include "WorldPartition.h"
+#include "Scene.h"
+#include "Entity.h"
+#include "Components.h"
+#include "SceneSerializer.h"
+#include "Assets/ModelImporter.h"
+#include "Assets/DesignAssetManager.h"
+#include "Project/Project.h"
+#include "Core/JobSystem.h"
+#include "Serialization/YAMLSerializer.h"
+
+namespace Engine {
+
+	// Filled in by a worker. The main thread reads it once the counter is back at zero, or drops it when the cell
+	// goes out of range first, the job keeps it alive until it is done.
+	struct WorldPartition::PendingCell
+	{
+		CellCoord Coord;
+		JobCounter Counter;
+		std::atomic<bool> Cancelled{ false };
+
+		YAML::Node Entities;
+		std::vector<std::pair<AssetHandle, Scope<MeshSourceData>>> Meshes;
+	};
+
+	// Cell files are stored relative to the project like every other asset path, so the project folder can move
+	static std::filesystem::path GetProjectRelativePath(const std::filesystem::path& path)
+	{
+		if (!path.is_absolute())
+		{
+			return path;
+		}
+		return std::filesystem::relative(path, Project::GetActive()->GetSettings().RootPath);
+	}
+
+	static void CollectSubtree(SceneHierarchy& hierarchy, EntityId entity_id, std::vector<EntityId>& out)
+	{
+		hierarchy.ForEachInSubtree(entity_id, [&out](EntityId entity) { out.push_back(entity); });
+	}
+
+	WorldPartition::WorldPartition(Scene* scene)
+		: m_Scene(scene)
+	{
+	}
+
+	void WorldPartition::SetSettings(const WorldPartitionSettings& settings)
+	{
+		// The cells are cut by the current grid, so they all have to be in the scene before it changes or goes away
+		if (!m_Cells.empty() && (!settings.Enabled || settings.CellSize != m_Settings.CellSize))
+		{
+			LoadAllCells();
+		}
+		m_Settings = settings;
+		m_Settings.CellSize = std::max(m_Settings.CellSize, 1.0f);
+		m_Settings.LoadRadius = std::max(m_Settings.LoadRadius, 0.0f);
+	}
+
+	void WorldPartition::Update(const glm::vec3& position, bool allow_unload)
+	{
+		HVE_PROFILE_FUNC();
+		if (!m_Settings.Enabled || m_Cells.empty())
+		{
+			return;
+		}
+
+		const glm::vec2 camera(position.x, position.z);
+		const float unload_radius = m_Settings.LoadRadius + m_Settings.CellSize * 0.5f;
+		auto distance_to = [this, camera](const CellCoord& coord)
+		{
+			glm::vec2 center = (glm::vec2((float)coord.X, (float)coord.Z) + 0.5f) * m_Settings.CellSize;
+			return glm::distance(center, camera);
+		};
+
+		if (allow_unload)
+		{
+			std::vector<CellCoord> out_of_range;
+			for (const auto& [coord, roots] : m_LoadedCells)
+			{
+				if (distance_to(coord) > unload_radius)
+				{
+					out_of_range.push_back(coord);
+				}
+			}
+			for (const CellCoord& coord : out_of_range)
+			{
+				UnloadCell(coord);
+			}
+
+			std::erase_if(m_PendingCells, [&](const Ref<PendingCell>& pending)
+			{
+				bool drop = distance_to(pending->Coord) > unload_radius;
+				pending->Cancelled = drop;
+				return drop;
+			});
+		}
+
+		// Only the cells of the square around the camera are looked up, the level may hold any number of them
+		CellCoord min = GetCellCoord(position - glm::vec3(m_Settings.LoadRadius));
+		CellCoord max = GetCellCoord(position + glm::vec3(m_Settings.LoadRadius));
+		for (int32_t x = min.X; x <= max.X; x++)
+		{
+			for (int32_t z = min.Z; z <= max.Z; z++)
+			{
+				CellCoord coord{ x, z };
+				if (m_Cells.contains(coord) && !m_LoadedCells.contains(coord) && !IsCellPending(coord) && distance_to(coord) <= m_Settings.LoadRadius)
+				{
+					RequestCell(coord);
+				}
+			}
+		}
+
+		// Creating the entities and uploading the meshes is the part that stalls the frame, so one cell at a time
+		for (auto it = m_PendingCells.begin(); it != m_PendingCells.end(); ++it)
+		{
+			if ((*it)->Counter.Pending.load(std::memory_order_acquire) == 0)
+			{
+				Ref<PendingCell> pending = *it;
+				m_PendingCells.erase(it);
+				FinishCell(*pending);
+				break;
+			}
+		}
+	}
+
+	void WorldPartition::LoadAllCells()
+	{
+		HVE_PROFILE_FUNC();
+		for (const auto& [coord, cell] : m_Cells)
+		{
+			if (!m_LoadedCells.contains(coord) && !IsCellPending(coord))
+			{
+				RequestCell(coord);
+			}
+		}
+		FlushPendingCells();
+	}
+
+	bool WorldPartition::IsPartitioned(EntityId entity_id) const
+	{
+		if (!m_Settings.Enabled || m_Scene->GetHierarchy().GetParent(entity_id) != EntityId())
+		{
+			return false;
+		}
+		auto transform = m_Scene->GetRegistry()->GetReadOnly<TransformComponent>(entity_id);
+		return transform && transform->IsStatic();
+	}
+
+	CellCoord WorldPartition::GetCellCoord(const glm::vec3& position) const
+	{
+		return { (int32_t)std::floor(position.x / m_Settings.CellSize), (int32_t)std::floor(position.z / m_Settings.CellSize) };
+	}
+
+	bool WorldPartition::IsCellPending(const CellCoord& coord) const
+	{
+		return std::any_of(m_PendingCells.begin(), m_PendingCells.end(), [&coord](const Ref<PendingCell>& pending) { return pending->Coord == coord; });
+	}
+
+	void WorldPartition::RequestCell(const CellCoord& coord)
+	{
+		const Cell& cell = m_Cells.at(coord);
+		Ref<PendingCell> pending = CreateRef<PendingCell>();
+		pending->Coord = coord;
+
+		// The asset manager is not safe to use from the workers, so they get copies of the metadata they need
+		auto asset_manager = Project::GetActiveDesignAssetManager();
+		std::vector<std::pair<AssetHandle, AssetMetadata>> meshes;
+		for (AssetHandle handle : cell.Meshes)
+		{
+			if (asset_manager->IsAssetHandleValid(handle) && !asset_manager->IsAssetLoaded(handle))
+			{
+				meshes.emplace_back(handle, asset_manager->GetMetadata(handle));
+			}
+		}
+
+		std::filesystem::path file_path = Project::GetFullFilePath(cell.FilePath);
+		m_PendingCells.push_back(pending);
+		JobSystem::Submit([pending, file_path, meshes]()
+		{
+			HVE_PROFILE_SCOPE("WorldPartition::LoadCell");
+			if (!std::filesystem::exists(file_path))
+			{
+				HVE_CORE_ERROR_TAG("World Partition", "Cell file {0} is missing", file_path);
+				return;
+			}
+			pending->Entities = YAML::LoadFile(file_path.string())["Entities"];
+
+			for (const auto& [handle, metadata] : meshes)
+			{
+				if (pending->Cancelled)
+				{
+					return;
+				}
+				pending->Meshes.emplace_back(handle, ModelImporter::ReadSource(metadata));
+			}
+		}, &pending->Counter);
+	}
+
+	void WorldPartition::FinishCell(PendingCell& pending)
+	{
+		HVE_PROFILE_FUNC();
+		auto asset_manager = Project::GetActiveDesignAssetManager();
+		for (auto& [handle, data] : pending.Meshes)
+		{
+			// A neighbouring cell may have brought the same mesh in meanwhile
+			if (data && !asset_manager->IsAssetLoaded(handle))
+			{
+				if (Ref<MeshSource> mesh_source = ModelImporter::BuildSource(*data))
+				{
+					asset_manager->AddLoadedAsset(handle, mesh_source);
+				}
+			}
+		}
+
+		std::vector<EntityId> roots = SceneSerializer::DeserializeEntities(pending.Entities, m_Scene);
+		std::vector<UUID>& members = m_LoadedCells[pending.Coord];
+		members.clear();
+		for (EntityId root : roots)
+		{
+			members.push_back(m_Scene->GetRegistry()->GetReadOnly<IDComponent>(root)->id);
+		}
+		// Deserializing only restores the local transforms, colliders would otherwise all be created at the origin
+		std::vector<EntityId> entities = CollectCellEntities(members);
+		m_Scene->PlaceEntities(entities);
+		m_Scene->SetupRuntimeEntities(entities);
+	}
+
+	void WorldPartition::FlushPendingCells()
+	{
+		std::vector<Ref<PendingCell>> pending_cells = std::move(m_PendingCells);
+		m_PendingCells.clear();
+		for (const Ref<PendingCell>& pending : pending_cells)
+		{
+			JobSystem::Wait(pending->Counter);
+			FinishCell(*pending);
+		}
+	}
+
+	void WorldPartition::UnloadCell(const CellCoord& coord)
+	{
+		HVE_PROFILE_FUNC();
+		auto loaded = m_LoadedCells.find(coord);
+		if (loaded == m_LoadedCells.end())
+		{
+			return;
+		}
+		std::vector<EntityId> entities = CollectCellEntities(loaded->second);
+		m_LoadedCells.erase(loaded);
+		m_Scene->DestroyEntities(entities);
+
+		// Meshes still used by other cells or by the rest of the scene are refused and stay
+		auto asset_manager = Project::GetActiveDesignAssetManager();
+		if (auto cell = m_Cells.find(coord); cell != m_Cells.end())
+		{
+			for (AssetHandle handle : cell->second.Meshes)
+			{
+				asset_manager->UnloadAsset(handle);
+			}
+		}
+		// The material textures of the meshes that just went away
+		asset_manager->UnloadUnusedMemoryAssets();
+	}
+
+	std::vector<EntityId> WorldPartition::CollectCellEntities(const std::vector<UUID>& roots)
+	{
+		std::vector<EntityId> entities;
+		for (const UUID& id : roots)
+		{
+			// Roots that were reparented or made dynamic belong to the scene file now
+			Entity root = m_Scene->GetEntityByUUID(id);
+			if (root && IsPartitioned(root.GetID()))
+			{
+				CollectSubtree(m_Scene->GetHierarchy(), root.GetID(), entities);
+			}
+		}
+		return entities;
+	}
+
+	void WorldPartition::CollectMeshes(EntityId entity_id, std::vector<AssetHandle>& meshes)
+	{
+		std::vector<EntityId> subtree;
+		CollectSubtree(m_Scene->GetHierarchy(), entity_id, subtree);
+		for (EntityId id : subtree)
+		{
+			auto mesh_component = m_Scene->GetRegistry()->GetReadOnly<MeshComponent>(id);
+			if (!mesh_component || !mesh_component->mesh || !mesh_component->mesh->GetMeshSource())
+			{
+				continue;
+			}
+			AssetHandle handle = mesh_component->mesh->GetMeshSource()->Handle;
+			if (std::find(meshes.begin(), meshes.end(), handle) == meshes.end())
+			{
+				meshes.push_back(handle);
+			}
+		}
+	}
+
+	void WorldPartition::SaveCells(const std::filesystem::path& scene_directory, const std::string& scene_name)
+	{
+		HVE_PROFILE_FUNC();
+		if (!m_Settings.Enabled)
+		{
+			if (m_Cells.empty())
+			{
+				return;
+			}
+			// Everything goes back into the scene file
+			LoadAllCells();
+			for (const auto& [coord, cell] : m_Cells)
+			{
+				std::filesystem::remove(Project::GetFullFilePath(cell.FilePath));
+			}
+			m_Cells.clear();
+			m_LoadedCells.clear();
+			return;
+		}
+
+		// A load finishing after the save would bring back a file from before it
+		FlushPendingCells();
+
+		std::map<CellCoord, std::vector<EntityId>> groups;
+		m_Scene->GetHierarchy().ForEachChild(EntityId(), [&](EntityId child)
+		{
+			if (IsPartitioned(child))
+			{
+				auto transform = m_Scene->GetRegistry()->GetReadOnly<TransformComponent>(child);
+				groups[GetCellCoord(transform->local_transform.translation)].push_back(child);
+			}
+		});
+
+		const std::filesystem::path cells_directory = GetProjectRelativePath(scene_directory) / (scene_name + "_Cells");
+		std::vector<EntityId> moved_out;
+		for (const auto& [coord, roots] : groups)
+		{
+			bool in_scene = !m_Cells.contains(coord) || m_LoadedCells.contains(coord);
+			Cell& cell = m_Cells[coord];
+			if (cell.FilePath.empty())
+			{
+				cell.FilePath = cells_directory / ("cell_" + std::to_string(coord.X) + "_" + std::to_string(coord.Z) + ".hvecell");
+			}
+			std::filesystem::path file_path = Project::GetFullFilePath(cell.FilePath);
+
+			if (in_scene)
+			{
+				SceneSerializer::SerializeCell(file_path, m_Scene, roots);
+				cell.Meshes.clear();
+				std::vector<UUID>& members = m_LoadedCells[coord];
+				members.clear();
+				for (EntityId root : roots)
+				{
+					CollectMeshes(root, cell.Meshes);
+					members.push_back(m_Scene->GetRegistry()->GetReadOnly<IDComponent>(root)->id);
+				}
+			}
+			else
+			{
+				// The rest of the cell only exists in its file
+				YAML::Node kept_entities = YAML::LoadFile(file_path.string())["Entities"];
+				SceneSerializer::SerializeCell(file_path, m_Scene, roots, &kept_entities);
+				for (EntityId root : roots)
+				{
+					CollectMeshes(root, cell.Meshes);
+					CollectSubtree(m_Scene->GetHierarchy(), root, moved_out);
+				}
+			}
+		}
+
+		// Loaded cells whose entities were all deleted or moved elsewhere
+		for (auto it = m_LoadedCells.begin(); it != m_LoadedCells.end();)
+		{
+			if (groups.contains(it->first))
+			{
+				++it;
+				continue;
+			}
+			if (auto cell = m_Cells.find(it->first); cell != m_Cells.end())
+			{
+				std::filesystem::remove(Project::GetFullFilePath(cell->second.FilePath));
+				m_Cells.erase(cell);
+			}
+			it = m_LoadedCells.erase(it);
+		}
+
+		m_Scene->DestroyEntities(moved_out);
+	}
+
+	void WorldPartition::Serialize(YAML::Emitter& out) const
+	{
+		out << YAML::Key << "WorldPartition";
+		out << YAML::BeginMap;
+		out << YAML::Key << "Enabled" << YAML::Value << m_Settings.Enabled;
+		out << YAML::Key << "CellSize" << YAML::Value << m_Settings.CellSize;
+		out << YAML::Key << "LoadRadius" << YAML::Value << m_Settings.LoadRadius;
+
+		// The index lets a scene start streaming without opening a single cell file
+		out << YAML::Key << "Cells";
+		out << YAML::BeginSeq;
+		for (const auto& [coord, cell] : m_Cells)
+		{
+			out << YAML::BeginMap;
+			out << YAML::Key << "X" << YAML::Value << coord.X;
+			out << YAML::Key << "Z" << YAML::Value << coord.Z;
+			out << YAML::Key << "File" << YAML::Value << cell.FilePath.string();
+			out << YAML::Key << "Meshes" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+			for (AssetHandle handle : cell.Meshes)
+			{
+				out << handle;
+			}
+			out << YAML::EndSeq;
+			out << YAML::EndMap;
+		}
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+	}
+
+	void WorldPartition::Deserialize(const YAML::Node& node)
+	{
+		if (!node)
+		{
+			return;
+		}
+
+		m_Settings.Enabled = node["Enabled"].as<bool>(false);
+		m_Settings.CellSize = std::max(node["CellSize"].as<float>(64.0f), 1.0f);
+		m_Settings.LoadRadius = std::max(node["LoadRadius"].as<float>(128.0f), 0.0f);
+
+		m_Cells.clear();
+		m_LoadedCells.clear();
+		if (node["Cells"])
+		{
+			for (const auto& cell_node : node["Cells"])
+			{
+				CellCoord coord{ cell_node["X"].as<int32_t>(0), cell_node["Z"].as<int32_t>(0) };
+				Cell& cell = m_Cells[coord];
+				// Scenes saved before the paths were made relative hold absolute ones
+				cell.FilePath = GetProjectRelativePath(cell_node["File"].as<std::string>());
+				if (cell_node["Meshes"])
+				{
+					for (const auto& mesh_node : cell_node["Meshes"])
+					{
+						cell.Meshes.push_back(mesh_node.as<AssetHandle>(0));
+					}
+				}
+			}
+		}
+	}
+
+	void WorldPartition::CopyFrom(const WorldPartition& other)
+	{
+		m_Settings = other.m_Settings;
+		m_Cells = other.m_Cells;
+		m_LoadedCells = other.m_LoadedCells;
+		m_PendingCells.clear();
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <glm/glm.hpp>
+#include "EntityId.h"
+#include "Assets/Asset.h"
+
+namespace YAML {
+	class Emitter;
+	class Node;
+}
+
+namespace Engine {
+	class Scene;
+
+	struct WorldPartitionSettings
+	{
+		bool Enabled = false;
+		// Edge length of the square cells on the XZ plane
+		float CellSize = 64.0f;
+		// Cells whose center lies within this distance of the camera are loaded. They unload again half a cell
+		// further out, so a camera on a cell border does not load and unload the same cell every frame.
+		float LoadRadius = 128.0f;
+	};
+
+	struct CellCoord
+	{
+		int32_t X = 0;
+		int32_t Z = 0;
+
+		bool operator<(const CellCoord& other) const { return X != other.X ? X < other.X : Z < other.Z; }
+		bool operator==(const CellCoord& other) const { return X == other.X && Z == other.Z; }
+	};
+
+	// Splits the static part of a scene into a grid of cells that are saved as files of their own and streamed in
+	// and out around the camera, so neither the memory a level needs nor its load time grow with its size.
+	// A cell holds the root level subtrees whose root is static, placed by the root's translation. Everything
+	// else stays in the scene file and is always loaded.
+	//
+	// Loading a cell parses its file and reads its meshes and textures on the job system. Only the GPU upload and
+	// the creation of the entities run on the main thread, one cell per update.
+	class WorldPartition
+	{
+	public:
+		explicit WorldPartition(Scene* scene);
+
+		const WorldPartitionSettings& GetSettings() const { return m_Settings; }
+		// Turning the partition off or changing the cell size brings every cell in first, the next save then
+		// writes the scene file and the cell files to match
+		void SetSettings(const WorldPartitionSettings& settings);
+
+		// Starts loading the cells in range of position and brings in at most one finished cell. allow_unload also
+		// drops the cells out of range, the editor keeps them so unsaved edits are never thrown away.
+		void Update(const glm::vec3& position, bool allow_unload);
+		// Synchronously loads every cell that is not loaded yet
+		void LoadAllCells();
+
+		bool IsCellLoaded(const CellCoord& coord) const { return m_LoadedCells.contains(coord); }
+		uint32_t GetCellCount() const { return (uint32_t)m_Cells.size(); }
+		uint32_t GetLoadedCellCount() const { return (uint32_t)m_LoadedCells.size(); }
+		uint32_t GetPendingCellCount() const { return (uint32_t)m_PendingCells.size(); }
+
+		// True for entities that are saved to a cell file rather than the scene file
+		bool IsPartitioned(EntityId entity_id) const;
+		CellCoord GetCellCoord(const glm::vec3& position) const;
+
+		// Called by the scene serializer before it writes the scene file. Loaded cells and cells without a file are
+		// written from the scene. Entities that moved into a cell that is not loaded are merged into its file and
+		// leave the scene, as if that cell had just been streamed out.
+		void SaveCells(const std::filesystem::path& scene_directory, const std::string& scene_name);
+		void Serialize(YAML::Emitter& out) const;
+		void Deserialize(const YAML::Node& node);
+
+		// Settings, cell index and which cells are loaded, for a copy of the scene that keeps the same entities.
+		// Loads still in flight are not carried over, the copy starts them again.
+		void CopyFrom(const WorldPartition& other);
+
+	private:
+		struct Cell
+		{
+			std::filesystem::path FilePath;
+			// Mesh sources used inside the cell, read ahead on the workers and released with the cell
+			std::vector<AssetHandle> Meshes;
+		};
+
+		struct PendingCell;
+
+		bool IsCellPending(const CellCoord& coord) const;
+		void RequestCell(const CellCoord& coord);
+		void FinishCell(PendingCell& pending);
+		// Waits for every load in flight and brings it in
+		void FlushPendingCells();
+		void UnloadCell(const CellCoord& coord);
+		// Roots of the cell that are still in the scene, with everything below them
+		std::vector<EntityId> CollectCellEntities(const std::vector<UUID>& roots);
+		void CollectMeshes(EntityId entity_id, std::vector<AssetHandle>& meshes);
+
+	private:
+		Scene* m_Scene;
+		WorldPartitionSettings m_Settings;
+
+		// Every cell that has a file, loaded or not
+		std::map<CellCoord, Cell> m_Cells;
+		// Root entities of each loaded cell, by UUID so stale entries are harmless
+		std::map<CellCoord, std::vector<UUID>> m_LoadedCells;
+		std::vector<Ref<PendingCell>> m_PendingCells;
+	};
+}
@@ -114,7 +114,7 @@ namespace Engine {
 		ScriptClass EntityClass;
 
 		std::unordered_map<std::string, Ref<ScriptClass>> EntityClasses;
-		std::unordered_map<UUID, Ref<ScriptInstance>> EntityInstances;
+		std::vector<std::pair<EntityId, Ref<ScriptInstance>>> EntityInstances;
 
 		Scene* SceneContext = nullptr;
 		bool ShouldReload = false;
@@ -246,27 +246,47 @@ namespace Engine {
 		return s_Data->EntityClasses.find(full_class_name) != s_Data->EntityClasses.end();
 	}
 
-	bool ScriptEngine::EntityInstanceExists(const UUID& entity_id)
+	bool ScriptEngine::EntityInstanceExists(const EntityId& entity_id)
 	{
-		return s_Data->EntityInstances.find(entity_id) != s_Data->EntityInstances.end();
+		return GetInstanceByEntityID(entity_id) != nullptr;
 	}
 
-	void ScriptEngine::OnCreateEntityClass(Entity* entity)
+	void ScriptEngine::OnCreateEntityClass(Entity entity)
 	{
-		const auto script_component = entity->GetComponent<ScriptComponent>();
+		const auto script_component = entity.GetComponent<ScriptComponent>();
 		if (script_component && EntityClassExists(script_component->Name))
 		{
-			s_Data->EntityInstances[entity->GetID()]
-				= CreateRef<ScriptInstance>(s_Data->EntityClasses[script_component->Name], entity);
-			s_Data->EntityInstances[entity->GetID()]->InvokeOnCreate();
+			EntityId entity_id = entity.GetID();
+			if (entity_id.Index >= s_Data->EntityInstances.size())
+			{
+				s_Data->EntityInstances.resize(entity_id.Index + 1);
+			}
+			auto instance = CreateRef<ScriptInstance>(s_Data->EntityClasses[script_component->Name], entity);
+			s_Data->EntityInstances[entity_id.Index] = { entity_id, instance };
+			instance->InvokeOnCreate();
 		}
 	}
 
 	void ScriptEngine::OnUpdate(float delta_time)
 	{
 		HVE_PROFILE_FUNC();
-		for(auto [entity_id, instance] : s_Data->EntityInstances){
-			instance->InvokeOnUpdate(delta_time);
+		for (size_t i = 0; i < s_Data->EntityInstances.size(); i++) {
+			// Copy the ref, a script may destroy its own entity during the update
+			Ref<ScriptInstance> instance = s_Data->EntityInstances[i].second;
+			if (instance) {
+				instance->InvokeOnUpdate(delta_time);
+			}
+		}
+	}
+
+	void ScriptEngine::OnEntitiesDestroyed(std::span<const EntityId> entity_ids)
+	{
+		for (EntityId entity_id : entity_ids)
+		{
+			if (entity_id.Index < s_Data->EntityInstances.size() && s_Data->EntityInstances[entity_id.Index].first == entity_id)
+			{
+				s_Data->EntityInstances[entity_id.Index] = { EntityId(), nullptr };
+			}
 		}
 	}
 
@@ -280,7 +300,7 @@ namespace Engine {
 		s_Data->ShouldReload = true;
 	}
 
-	std::unordered_map<UUID, Ref<ScriptInstance>>& ScriptEngine::GetEntityInstances()
+	std::vector<std::pair<EntityId, Ref<ScriptInstance>>>& ScriptEngine::GetEntityInstances()
 	{
 		return s_Data->EntityInstances;
 	}
@@ -300,15 +320,14 @@ namespace Engine {
 		return s_Data->CoreAssemblyImage;
 	}
 
-	Ref<ScriptInstance> ScriptEngine::GetInstanceByEntityID(UUID entity_id)
+	Ref<ScriptInstance> ScriptEngine::GetInstanceByEntityID(EntityId entity_id)
 	{
-		auto iter = s_Data->EntityInstances.find(entity_id);
-		if (iter == s_Data->EntityInstances.end())
+		if (entity_id.Index >= s_Data->EntityInstances.size() || s_Data->EntityInstances[entity_id.Index].first != entity_id)
 		{
 			return nullptr;
 		}
 
-		return iter->second;
+		return s_Data->EntityInstances[entity_id.Index].second;
 	}
 
 	void ScriptEngine::CallMethod(MonoObject* monoObject, MonoMethod* managedMethod, const void** parameters)
@@ -388,15 +407,16 @@ namespace Engine {
 		HVE_CORE_WARN("Reloaded Scripts");
 	}
 
-	ScriptInstance::ScriptInstance(Ref<ScriptClass> script_class, Entity* entity): m_ScriptClass(script_class), m_EntityID(entity->GetID())
+	ScriptInstance::ScriptInstance(Ref<ScriptClass> script_class, Entity entity): m_ScriptClass(script_class), m_EntityID(entity.GetID())
 	{
 		m_Instance = script_class->Instantiate();
 		m_Constructor = s_Data->EntityClass.GetMethod(".ctor", 1);
 		m_OnCreateMethod = script_class->GetMethod("OnCreate", 0);
 		m_OnUpdateMethod = script_class->GetMethod("OnUpdate", 1);
 
-		// Call Entity constructor
-		void* param = &m_EntityID;
+		// Call Entity constructor, scripts address entities by the packed EntityId
+		uint64_t packed_id = m_EntityID.Pack();
+		void* param = &packed_id;
 		m_ScriptClass->InvokeMethod(m_Instance, m_Constructor, &param);
 		
 	}
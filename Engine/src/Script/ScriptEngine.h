@@ -10,6 +10,9 @@ extern "C" {
 	typedef struct _MonoString MonoString;
 }
 
+#include <span>
+#include "Scene/EntityId.h"
+
 namespace Engine {
 
 	class Scene;
@@ -36,7 +39,7 @@ namespace Engine {
 	class ScriptInstance
 	{
 	public:
-		ScriptInstance(Ref<ScriptClass> script_class, Entity* entity);
+		ScriptInstance(Ref<ScriptClass> script_class, Entity entity);
 
 		void InvokeOnCreate();
 		void InvokeOnUpdate(float delta_time);
@@ -46,7 +49,7 @@ namespace Engine {
 
 	private:
 		Ref<ScriptClass> m_ScriptClass;
-		UUID m_EntityID;
+		EntityId m_EntityID;
 
 		MonoObject* m_Instance = nullptr;
 
@@ -68,19 +71,22 @@ namespace Engine {
 		static void OnRuntimeStop();
 
 		static bool EntityClassExists(const std::string& full_class_name);
-		static bool EntityInstanceExists(const UUID& entity_id);
+		static bool EntityInstanceExists(const EntityId& entity_id);
 
 		static void ReloadAssembly(const std::filesystem::path& app_assembly_path);
 
 		static bool ShouldReload();
 		static void MarkForReload();
 
-		static void OnCreateEntityClass(Entity* entity);
+		static void OnCreateEntityClass(Entity entity);
 
 		static void OnUpdate(float delta_time);
+		// Drops the script instances of entities the scene is about to remove
+		static void OnEntitiesDestroyed(std::span<const EntityId> entity_ids);
 
 		static std::unordered_map<std::string, Ref<ScriptClass>>& GetEntityClasses();
-		static std::unordered_map<UUID, Ref<ScriptInstance>>& GetEntityInstances();
+		// Indexed by EntityId::Index, a slot is empty when its instance is null
+		static std::vector<std::pair<EntityId, Ref<ScriptInstance>>>& GetEntityInstances();
 		static Scene* GetSceneContext();
 
 		static MonoImage* GetCoreAssemblyImage();
@@ -92,9 +98,12 @@ namespace Engine {
 
 			auto& instances = GetEntityInstances();
 
-			for (auto [entity_id, instance] : instances)
+			for (auto& [entity_id, instance] : instances)
 			{
-				CallMethod(entity_id, methodName, std::forward<TArgs>(args)...);
+				if (instance)
+				{
+					CallMethod(entity_id, methodName, std::forward<TArgs>(args)...);
+				}
 			}
 		}
 
@@ -102,7 +111,7 @@ namespace Engine {
 		
 
 		template<typename... TArgs>
-		static void CallMethod(UUID entity_id, const std::string& methodName, TArgs&&... args)
+		static void CallMethod(EntityId entity_id, const std::string& methodName, TArgs&&... args)
 		{
 			HVE_PROFILE_SCOPE_DYNAMIC(methodName.c_str());
 
@@ -150,7 +159,7 @@ namespace Engine {
 		static void ShutdownMono();
 		static MonoObject* InstantiateClass(MonoClass* mono_class);
 		static void LoadAssemblyClasses();
-		static Ref<ScriptInstance> GetInstanceByEntityID(UUID entity_id);
+		static Ref<ScriptInstance> GetInstanceByEntityID(EntityId entity_id);
 		static void CallMethod(MonoObject* monoObject, MonoMethod* managedMethod, const void** parameters);
 
 		friend class ScriptClass;
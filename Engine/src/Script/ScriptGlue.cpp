@@ -12,15 +12,16 @@
 
 namespace Engine {
 
-	static std::unordered_map<MonoType*, std::function<bool(Entity*)>> s_HasComponentFuncs;
+	static std::unordered_map<MonoType*, std::function<bool(Entity)>> s_HasComponentFuncs;
 
 #define HVE_ADD_INTERNAL_CALL(Name) mono_add_internal_call("Helios.InternalCalls::" #Name, Name)
 
-	std::pair<Scene*, Entity*> GetSceneAndEntity(UUID entity_id)
+	// Scripts hold the packed EntityId handed to them by ScriptInstance, not the UUID
+	std::pair<Scene*, Entity> GetSceneAndEntity(uint64_t entity_id)
 	{
 		Scene* scene = ScriptEngine::GetSceneContext();
 		HVE_CORE_ASSERT(scene);
-		Entity* entity = scene->GetEntity(entity_id);
+		Entity entity = scene->GetEntity(EntityId::Unpack(entity_id));
 		HVE_CORE_ASSERT(entity);
 		return { scene, entity };
 	}
@@ -54,14 +55,15 @@ namespace Engine {
 	static void Entity_Destroy(uint64_t entity_id)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		scene->DestroyEntity(entity_id);
+		// Scripts run while the scene is iterating its pools, the entity goes away at the end of the frame
+		scene->GetCommandBuffer().DestroyEntity(entity.GetID());
 	}
 
 
 	static void Camera_RotateAroundEntity(uint64_t entity_id, glm::vec2* rotation, float speed, bool inverse_controls)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			camera_comp->camera.RotateAroundFocalPoint(*rotation, speed, inverse_controls);
@@ -71,7 +73,7 @@ namespace Engine {
 	static void Camera_Rotate(uint64_t entity_id, glm::vec2* rotation, float speed, bool inverse_controls)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			camera_comp->camera.Rotate(*rotation, speed, inverse_controls);
@@ -81,7 +83,7 @@ namespace Engine {
 	static void Camera_GetForwardDirection(uint64_t entity_id, glm::vec3* forward_direction)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			*forward_direction = camera_comp->camera.GetForwardDirection();
@@ -91,7 +93,7 @@ namespace Engine {
 	static void Camera_GetRightDirection(uint64_t entity_id, glm::vec3* right_direction)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			*right_direction = camera_comp->camera.GetRightDirection();
@@ -101,7 +103,7 @@ namespace Engine {
 	static void Camera_GetPosition(uint64_t entity_id, glm::vec3* position)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			*position = camera_comp->camera.GetPosition();
@@ -111,7 +113,7 @@ namespace Engine {
 	static void Camera_GetRotation(uint64_t entity_id, glm::vec3* rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			*rotation = glm::eulerAngles(camera_comp->camera.GetOrientation());
@@ -121,7 +123,7 @@ namespace Engine {
 	static void Camera_SetPosition(uint64_t entity_id, glm::vec3* position)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			camera_comp->camera.SetPosition(*position);
@@ -131,7 +133,7 @@ namespace Engine {
 	static void Camera_SetRotation(uint64_t entity_id, glm::vec3* rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto camera_comp = entity->GetComponent<CameraComponent>();
+		auto camera_comp = entity.GetComponent<CameraComponent>();
 		if (camera_comp)
 		{
 			camera_comp->camera.SetRotation(glm::vec2(*rotation));
@@ -142,43 +144,43 @@ namespace Engine {
 	static void TransformComponent_GetTranslation(uint64_t entity_id, glm::vec3* out_translation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		*out_translation = entity->GetComponent<TransformComponent>()->world_transform.translation;
+		*out_translation = entity.GetComponent<TransformComponent>()->world_transform.translation;
 	}
 
 	static void TransformComponent_SetTranslation(uint64_t entity_id, glm::vec3* in_translation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		entity->GetComponent<TransformComponent>()->world_transform.translation = *in_translation;
+		entity.GetComponent<TransformComponent>()->world_transform.translation = *in_translation;
 	}
 
 	static void TransformComponent_GetRotation(uint64_t entity_id, glm::vec3* out_rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		*out_rotation = entity->GetComponent<TransformComponent>()->world_transform.rotation;
+		*out_rotation = entity.GetComponent<TransformComponent>()->world_transform.GetRotationEuler();
 	}
 
 	static void TransformComponent_SetRotation(uint64_t entity_id, glm::vec3* in_rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		entity->GetComponent<TransformComponent>()->world_transform.rotation = *in_rotation;
+		entity.GetComponent<TransformComponent>()->world_transform.rotation = glm::quat(*in_rotation);
 	}
 
 	static void TransformComponent_GetScale(uint64_t entity_id, glm::vec3* out_scale)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		*out_scale = entity->GetComponent<TransformComponent>()->world_transform.scale;
+		*out_scale = entity.GetComponent<TransformComponent>()->world_transform.scale;
 	}
 
 	static void TransformComponent_SetScale(uint64_t entity_id, glm::vec3* in_scale)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		entity->GetComponent<TransformComponent>()->world_transform.scale = *in_scale;
+		entity.GetComponent<TransformComponent>()->world_transform.scale = *in_scale;
 	}
 
 	static void Sounds_PlaySoundAtIndexGlobal(uint64_t entity_id, int index)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sounds_library = entity->GetComponent<GlobalSoundsComponent>();
+		auto sounds_library = entity.GetComponent<GlobalSoundsComponent>();
 		if (sounds_library && index <= sounds_library->Sounds.size() - 1)
 		{
 			sounds_library->Sounds.at(index)->PlaySound(false);
@@ -188,7 +190,7 @@ namespace Engine {
 	static void Sounds_PlaySoundAtIndexLocal(uint64_t entity_id, int index)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sounds_library = entity->GetComponent<LocalSoundsComponent>();
+		auto sounds_library = entity.GetComponent<LocalSoundsComponent>();
 		if (sounds_library && index <= sounds_library->Sounds.size() - 1)
 		{
 			sounds_library->Sounds.at(index)->PlaySound(scene->GetCurrentCamera()->CalculatePosition(), false);
@@ -198,74 +200,74 @@ namespace Engine {
 	static void BoxCollider_GetLinearVelocity(uint64_t entity_id, glm::vec3* out_velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			*out_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity_id);
+			*out_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity.GetID());
 		}
 	}
 
 	static void BoxCollider_SetLinearVelocity(uint64_t entity_id, glm::vec3* in_velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, *in_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), *in_velocity);
 		}
 	}
 
 	static void BoxCollider_AddLinearVelocity(uint64_t entity_id, glm::vec3* velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity_id);
+			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity.GetID());
 			curr_velocity += *velocity;
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, curr_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), curr_velocity);
 		}
 	}
 
 	static void BoxCollider_AddAngularVelocity(uint64_t entity_id, glm::vec3* velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetAngularVelocity(entity_id);
+			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetAngularVelocity(entity.GetID());
 			curr_velocity += *velocity;
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, curr_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), curr_velocity);
 		}
 	}
 
 	static void BoxCollider_AddImpulse(uint64_t entity_id, glm::vec3* impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddLinearImpulse(entity_id, *impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddLinearImpulse(entity.GetID(), *impulse);
 		}
 	}
 
 	static void BoxCollider_AddAngularImpulse(uint64_t entity_id, glm::vec3* impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddAngularImpulse(entity_id, *impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddAngularImpulse(entity.GetID(), *impulse);
 		}
 	}
 
 	static void BoxCollider_AddLinearAngularImpulse(uint64_t entity_id, glm::vec3* linear_impulse, glm::vec3* angular_impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto box_collider = entity->GetComponent<BoxColliderComponent>();
+		auto box_collider = entity.GetComponent<BoxColliderComponent>();
 		if (box_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddLinearAndAngularImpulse(entity_id, *linear_impulse, *angular_impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddLinearAndAngularImpulse(entity.GetID(), *linear_impulse, *angular_impulse);
 		}
 	}
 
@@ -273,128 +275,128 @@ namespace Engine {
 	static void SphereCollider_GetLinearVelocity(uint64_t entity_id, glm::vec3* out_velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			*out_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity_id);
+			*out_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity.GetID());
 		}
 	}
 
 	static void SphereCollider_SetLinearVelocity(uint64_t entity_id, glm::vec3* in_velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, *in_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), *in_velocity);
 		}
 	}
 
 	static void SphereCollider_AddLinearVelocity(uint64_t entity_id, glm::vec3* velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity_id);
+			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity.GetID());
 			curr_velocity += *velocity;
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, curr_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), curr_velocity);
 		}
 	}
 
 	static void SphereCollider_AddAngularVelocity(uint64_t entity_id, glm::vec3* velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetAngularVelocity(entity_id);
+			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetAngularVelocity(entity.GetID());
 			curr_velocity += *velocity;
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, curr_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), curr_velocity);
 		}
 	}
 
 	static void SphereCollider_AddImpulse(uint64_t entity_id, glm::vec3* impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddLinearImpulse(entity_id, *impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddLinearImpulse(entity.GetID(), *impulse);
 		}
 	}
 
 	static void SphereCollider_AddAngularImpulse(uint64_t entity_id, glm::vec3* impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddAngularImpulse(entity_id, *impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddAngularImpulse(entity.GetID(), *impulse);
 		}
 	}
 
 	static void SphereCollider_AddLinearAngularImpulse(uint64_t entity_id, glm::vec3* linear_impulse, glm::vec3* angular_impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto sphere_collider = entity->GetComponent<SphereColliderComponent>();
+		auto sphere_collider = entity.GetComponent<SphereColliderComponent>();
 		if (sphere_collider)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddLinearAndAngularImpulse(entity_id, *linear_impulse, *angular_impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddLinearAndAngularImpulse(entity.GetID(), *linear_impulse, *angular_impulse);
 		}
 	}
 
 	static void CharacterController_GetLinearVelocity(uint64_t entity_id, glm::vec3* out_velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			*out_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity_id);
+			*out_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity.GetID());
 		}
 	}
 
 	static void CharacterController_SetLinearVelocity(uint64_t entity_id, glm::vec3* in_velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, *in_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), *in_velocity);
 		}
 	}
 
 	static void CharacterController_AddLinearVelocity(uint64_t entity_id, glm::vec3* velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity_id);
+			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetLinearVelocity(entity.GetID());
 			curr_velocity += *velocity;
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, curr_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), curr_velocity);
 		}
 	}
 
 	static void CharacterController_AddAngularVelocity(uint64_t entity_id, glm::vec3* velocity)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetAngularVelocity(entity_id);
+			glm::vec3 curr_velocity = PhysicsEngine::Get()->GetCurrentScene()->GetAngularVelocity(entity.GetID());
 			curr_velocity += *velocity;
-			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity_id, curr_velocity);
+			PhysicsEngine::Get()->GetCurrentScene()->SetLinearVelocity(entity.GetID(), curr_velocity);
 		}
 	}
 
 	static void CharacterController_AddImpulse(uint64_t entity_id, glm::vec3* impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddLinearImpulse(entity_id, *impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddLinearImpulse(entity.GetID(), *impulse);
 		}
 	}
 
@@ -402,60 +404,60 @@ namespace Engine {
 	static void CharacterController_AddAngularImpulse(uint64_t entity_id, glm::vec3* impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddAngularImpulse(entity_id, *impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddAngularImpulse(entity.GetID(), *impulse);
 		}
 	}
 
 	static void CharacterController_AddLinearAngularImpulse(uint64_t entity_id, glm::vec3* linear_impulse, glm::vec3* angular_impulse)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->AddLinearAndAngularImpulse(entity_id, *linear_impulse, *angular_impulse);
+			PhysicsEngine::Get()->GetCurrentScene()->AddLinearAndAngularImpulse(entity.GetID(), *linear_impulse, *angular_impulse);
 		}
 	}
 
 	static bool CharacterController_IsCharacterGrounded(uint64_t entity_id)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			return PhysicsEngine::Get()->GetCurrentScene()->IsCharacterGrounded(entity_id);
+			return PhysicsEngine::Get()->GetCurrentScene()->IsCharacterGrounded(entity.GetID());
 		}
 	}
 
 	static void CharacterController_GetRotation(uint64_t entity_id, glm::vec3* rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			*rotation = PhysicsEngine::Get()->GetCurrentScene()->GetRotation(entity_id);
+			*rotation = PhysicsEngine::Get()->GetCurrentScene()->GetRotation(entity.GetID());
 		}
 	}
 
 	static void CharacterController_SetRotation(uint64_t entity_id, glm::vec3* rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->SetRotation(entity_id, *rotation);
+			PhysicsEngine::Get()->GetCurrentScene()->SetRotation(entity.GetID(), *rotation);
 		}
 	}
 
 	static void CharacterController_Rotate(uint64_t entity_id, glm::vec3* rotation)
 	{
 		auto [scene, entity] = GetSceneAndEntity(entity_id);
-		auto character_controller = entity->GetComponent<CharacterControllerComponent>();
+		auto character_controller = entity.GetComponent<CharacterControllerComponent>();
 		if (character_controller)
 		{
-			PhysicsEngine::Get()->GetCurrentScene()->Rotate(entity_id, *rotation);
+			PhysicsEngine::Get()->GetCurrentScene()->Rotate(entity.GetID(), *rotation);
 		}
 	}
 
@@ -468,7 +470,7 @@ namespace Engine {
 			std::string_view structName = class_name.substr(pos + 1);
 			std::string managedTypename = fmt::format("Helios.{}", structName);
 			MonoType* managed_type = mono_reflection_type_from_name(managedTypename.data(), ScriptEngine::GetCoreAssemblyImage());
-			s_HasComponentFuncs[managed_type] = [](Entity* entity) {return entity->HasComponent<Component>(); };
+			s_HasComponentFuncs[managed_type] = [](Entity entity) {return entity.HasComponent<Component>(); };
 			if (!managed_type)
 			{
 				HVE_CORE_WARN("Could not find component type - {}", managedTypename);